@@ -0,0 +1,2003 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Benchmark.h"
+#include "Interpreter.h"
+#include "global.h"
+#include "config.h"
+#include "RR.h"
+#include "FCFS.h"
+#include "Workload.h"
+#include "vmstat.h"
+#include "IndexedHeap.h"
+#include "TicketTree.h"
+#include "ProcessCoroutine.h"
+#include "Checkpoint.h"
+
+// --- File-local helpers ---
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+// Each program is repeated until this much time has passed, so short programs still time reliably.
+const auto MIN_BENCH_TIME = std::chrono::milliseconds(20);
+const int STATEMENTS_PER_PROGRAM = 1000;
+// Bench processes never enter a ready queue, so their frames are never picked for eviction.
+const int BENCH_PROCESS_ID = INT_MAX;
+const size_t BENCH_MEMORY_SIZE = 256;
+
+struct BenchResult {
+    uint64_t instructions = 0;
+    double seconds = 0;
+};
+
+void reset_execution(Process& process) {
+    process.program_counter = 0;
+    process.loop_depth = 0;
+    process.sleep_ticks_remaining = 0;
+}
+
+// Runs process's program to completion in slices of at most budget ticks, retrying after page faults.
+// Sleeps end at once: only the ticks spent on a core count.
+uint64_t run_to_completion(Process& process, int budget = INT_MAX) {
+    uint64_t executed = 0;
+    reset_execution(process);
+    for (;;) {
+        int ticks = 0;
+        ExecStatus status = interpreter_run(process, budget, ticks);
+        executed += ticks;
+        if (status == ExecStatus::FINISHED || status == ExecStatus::TERMINATED) return executed;
+        if (status == ExecStatus::SLEEPING) process.sleep_ticks_remaining = 0;
+    }
+}
+
+// Times the statements as written; optimize_program would fold most of these programs away.
+BenchResult time_program(Process& process, const std::vector<std::string>& statements) {
+    auto image = std::make_shared<ProgramImage>();
+    compile_program(statements, *image);
+    load_program(process, image);
+    run_to_completion(process); // Warm up: page in memory, size the variable table
+
+    BenchResult result;
+    auto start = bench_clock::now();
+    auto elapsed = bench_clock::duration::zero();
+    do {
+        result.instructions += run_to_completion(process);
+        elapsed = bench_clock::now() - start;
+    } while (elapsed < MIN_BENCH_TIME);
+    result.seconds = std::chrono::duration<double>(elapsed).count();
+    return result;
+}
+
+void print_row(const std::string& label, const BenchResult& result, uint64_t per_instruction_divisor = 1) {
+    double units = static_cast<double>(result.instructions) / per_instruction_divisor;
+    std::cout << std::left << std::setw(22) << label << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << (result.seconds * 1e9 / units)
+              << std::setw(16) << std::setprecision(1) << (units / result.seconds / 1e6) << "\n";
+}
+
+// Variable storage before symbol table slots: (name, value) pairs, searched by name for every
+// operand, a DECLARE or a first write appending the pair.
+using TupleVariables = std::vector<std::tuple<std::string, uint16_t>>;
+
+uint16_t& tuple_variable(TupleVariables& variables, const std::string& name) {
+    for (auto& [variable_name, value] : variables) {
+        if (variable_name == name) return value;
+    }
+    return std::get<1>(variables.emplace_back(name, 0));
+}
+
+// Times DECLAREs followed by ADDs (dest, lhs, rhs by name) on tuple storage, counting instructions
+// like time_program. Only the lookups are timed: the names are parsed up front and the values live
+// in host memory, not in the process's pages.
+BenchResult time_tuple_adds(const std::vector<std::pair<std::string, uint16_t>>& declares,
+                            const std::vector<std::array<std::string, 3>>& adds) {
+    TupleVariables variables;
+    uint64_t checksum = 0;
+    BenchResult result;
+    auto start = bench_clock::now();
+    auto elapsed = bench_clock::duration::zero();
+    do {
+        variables.clear();
+        for (const auto& [name, value] : declares) tuple_variable(variables, name) = value;
+        for (const auto& add : adds) {
+            uint32_t sum = uint32_t(tuple_variable(variables, add[1])) + tuple_variable(variables, add[2]);
+            tuple_variable(variables, add[0]) = static_cast<uint16_t>(sum > 65535 ? 65535 : sum);
+        }
+        checksum += std::get<1>(variables.front());
+        result.instructions += declares.size() + adds.size();
+        elapsed = bench_clock::now() - start;
+    } while (elapsed < MIN_BENCH_TIME);
+    result.seconds = std::chrono::duration<double>(elapsed).count();
+    if (checksum == 1) std::cout << ""; // Keeps the loop from being optimized away
+    return result;
+}
+
+// ns per executed instruction for each opcode, measured on straight-line programs.
+void bench_interpreter() {
+    Process process(BENCH_PROCESS_ID);
+    process.cold->processName = "bench";
+    memory_manager->allocate_for_process(process, BENCH_MEMORY_SIZE);
+
+    auto repeated = [](const std::string& statement) {
+        return std::vector<std::string>(STATEMENTS_PER_PROGRAM, statement);
+    };
+
+    std::cout << "\nInterpreter dispatch: "
+#if defined(__GNUC__) || defined(__clang__)
+              << "computed goto"
+#else
+              << "switch"
+#endif
+              << ", " << STATEMENTS_PER_PROGRAM << " instructions per program\n";
+    std::cout << std::left << std::setw(22) << "Opcode" << std::right
+              << std::setw(12) << "ns/instr" << std::setw(16) << "M instr/s" << "\n";
+
+    const std::vector<std::pair<std::string, std::string>> cases = {
+        {"PRINT",    "PRINT(\"x = \" + x)"},
+        {"DECLARE",  "DECLARE x 1"},
+        {"ADD",      "ADD x x 1"},
+        {"SUBTRACT", "SUBTRACT x x 1"},
+        {"SLEEP",    "SLEEP 0"},
+        {"READ",     "READ y 0x10"},
+        {"WRITE",    "WRITE 0x10 x"},
+    };
+    for (const auto& [label, statement] : cases) {
+        std::vector<std::string> program = repeated(statement);
+        program.insert(program.begin(), "DECLARE x 1");
+        print_row(label, time_program(process, program));
+    }
+
+    // Variable lookup cost grows with the number of live variables; use the per-process maximum. The
+    // same program on the old (name, value) tuples shows what slot resolution saves.
+    std::vector<std::string> many_vars;
+    std::vector<std::pair<std::string, uint16_t>> tuple_declares;
+    std::vector<std::array<std::string, 3>> tuple_adds;
+    auto name = [](int v) { return "v" + std::to_string(v % MAX_VARIABLES); };
+    for (int v = 0; v < MAX_VARIABLES; ++v) {
+        many_vars.push_back("DECLARE " + name(v) + " " + std::to_string(v));
+        tuple_declares.emplace_back(name(v), static_cast<uint16_t>(v));
+    }
+    for (int i = 0; i < STATEMENTS_PER_PROGRAM; ++i) {
+        many_vars.push_back("ADD " + name(i) + " " + name(i + 1) + " " + name(i + 7));
+        tuple_adds.push_back({name(i), name(i + 1), name(i + 7)});
+    }
+    print_row("ADD (" + std::to_string(MAX_VARIABLES) + " vars)", time_program(process, many_vars));
+    print_row("ADD (" + std::to_string(MAX_VARIABLES) + " vars, tuples)", time_tuple_adds(tuple_declares, tuple_adds));
+
+    // FOR costs no ticks; report the time per loop iteration including its one-ADD body.
+    BenchResult loop = time_program(process, {"FOR([ADD x x 1], " + std::to_string(STATEMENTS_PER_PROGRAM) + ")"});
+    print_row("FOR iteration (+ADD)", loop);
+
+    memory_manager->deallocate_for_process(process);
+    std::cout << std::endl;
+}
+
+size_t string_heap_bytes(const std::string& s) {
+    // Short strings live inside the object itself.
+    const char* inline_begin = reinterpret_cast<const char*>(&s);
+    bool is_inline = s.data() >= inline_begin && s.data() < inline_begin + sizeof(s);
+    return is_inline ? 0 : s.capacity() + 1;
+}
+
+size_t image_bytes(const ProgramImage& image) {
+    size_t bytes = sizeof(ProgramImage) + string_heap_bytes(image.error);
+    bytes += image.source.capacity() * sizeof(std::string);
+    for (const auto& command : image.source) bytes += string_heap_bytes(command);
+    bytes += image.code.capacity() * sizeof(Instruction);
+    bytes += image.messages.capacity() * sizeof(std::vector<PrintPart>);
+    for (const auto& message : image.messages) {
+        bytes += message.capacity() * sizeof(PrintPart);
+        for (const auto& part : message) bytes += string_heap_bytes(part.text);
+    }
+    bytes += image.variable_names.capacity() * sizeof(std::string);
+    for (const auto& name : image.variable_names) bytes += string_heap_bytes(name);
+    return bytes;
+}
+
+// Bytes a process owns: the object and its cold record plus its share of the program image.
+size_t process_footprint(const Process& process) {
+    size_t bytes = sizeof(Process) + sizeof(ProcessColdData) + string_heap_bytes(process.cold->processName);
+    if (process.image) bytes += image_bytes(*process.image) / process.image.use_count();
+    return bytes;
+}
+
+// Creation rate and footprint of scheduler-generated processes, without the memory manager.
+void bench_programs() {
+    const int PROCESS_COUNT = 100000;
+    const std::vector<std::pair<std::string, std::function<void(Process&, size_t)>>> generators = {
+        {"RR generated", rr_load_generated_program},
+        {"FCFS generated", fcfs_load_generated_program},
+    };
+
+    std::cout << "\n" << PROCESS_COUNT << " processes per generator\n";
+    std::cout << std::left << std::setw(22) << "Generator" << std::right
+              << std::setw(14) << "bytes/proc" << std::setw(16) << "K creates/s" << "\n";
+    for (const auto& [label, load] : generators) {
+        std::vector<std::shared_ptr<Process>> processes;
+        processes.reserve(PROCESS_COUNT);
+        auto start = bench_clock::now();
+        for (int i = 0; i < PROCESS_COUNT; ++i) {
+            auto pcb = std::make_shared<Process>(i);
+            pcb->cold->processName = "process" + std::to_string(i);
+            load(*pcb, BENCH_MEMORY_SIZE);
+            processes.push_back(std::move(pcb));
+        }
+        double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+        size_t total_bytes = 0;
+        for (const auto& pcb : processes) total_bytes += process_footprint(*pcb);
+        std::cout << std::left << std::setw(22) << label << std::right
+                  << std::setw(14) << total_bytes / PROCESS_COUNT
+                  << std::setw(16) << std::fixed << std::setprecision(1) << (PROCESS_COUNT / seconds / 1e3) << "\n";
+    }
+    std::cout << std::endl;
+}
+
+// True when the RR scheduler has nothing queued, running or sleeping, so a policy can be swapped in.
+bool rr_scheduler_idle() {
+    std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+    bool cores_idle = std::all_of(rr_g_running_processes.begin(), rr_g_running_processes.end(), [](ProcessIndex p) { return p == NO_PROCESS; });
+    return cores_idle && g_creation_queue.empty() && rr_g_ready_queue.empty() && rr_g_blocked_queue.empty() && rr_g_fault_queue.empty() && rr_g_sleep_wheel.empty();
+}
+
+// True when neither scheduler has a process and no workload is being generated, so nothing else
+// touches memory_manager.
+bool schedulers_idle() {
+    bool fcfs_idle;
+    {
+        std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+        fcfs_idle = std::all_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.end(), [](ProcessIndex p) { return p == NO_PROCESS; }) &&
+                    fcfs_g_ready_queue.empty() && fcfs_g_blocked_queue.empty() && fcfs_g_sleep_wheel.empty();
+    }
+    return fcfs_idle && !process_maker_running && rr_scheduler_idle();
+}
+
+// Creation rate of the scheduler-start workload for each arrival model, on both threads it runs on:
+// the generator building requests, and the scheduler turning g_creation_queue into ready processes
+// with rr_create_queued_processes, table entry, memory and DEBUG line included. The CV (stddev /
+// mean) of the arrival gaps tells the models apart: 0 fixed, ~1 Poisson, >1 bursty. The processes
+// are removed again before the next model.
+void bench_workload() {
+    const int PROCESS_COUNT = 20000;
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe workload benchmark needs an RR-family scheduler (e.g. \"rr\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe workload benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    WorkloadConfig config = workload_config_from_globals();
+    if (config.seed == 0) config.seed = 1; // Reproducible runs
+
+    std::ostringstream table; // Printed after the runs, below their DEBUG lines
+    table << "\n" << PROCESS_COUNT << " processes per model, " << config.min_ins << "-" << config.max_ins
+          << " instructions, " << config.min_mem << "-" << config.max_mem << " bytes, mean gap "
+          << config.mean_gap_ticks << " ticks\n";
+    table << std::left << std::setw(12) << "Model" << std::right << std::setw(14) << "K gen/s"
+          << std::setw(16) << "K creates/s" << std::setw(14) << "mean gap" << std::setw(10) << "gap CV" << "\n";
+
+    const std::vector<std::pair<std::string, ArrivalModel>> models = {
+        {"fixed", ArrivalModel::FIXED}, {"poisson", ArrivalModel::POISSON}, {"bursty", ArrivalModel::BURSTY},
+    };
+    for (const auto& [label, model] : models) {
+        config.arrival_model = model;
+        WorkloadGenerator generator(config);
+        std::vector<ProcessCreationRequest> requests;
+        requests.reserve(PROCESS_COUNT);
+        double gap_sum = 0, gap_square_sum = 0;
+
+        auto start = bench_clock::now();
+        for (int i = 0; i < PROCESS_COUNT; ++i) {
+            GeneratedProcess generated = generator.next();
+            gap_sum += generated.arrival_gap;
+            gap_square_sum += static_cast<double>(generated.arrival_gap) * generated.arrival_gap;
+            requests.push_back({"process" + std::to_string(cpuClocks++), generated.memory_size, std::move(generated.program)});
+        }
+        double generate_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex); // No core dispatches them meanwhile
+        for (auto& request : requests) g_creation_queue.push_back(std::move(request));
+        start = bench_clock::now();
+        rr_create_queued_processes(static_cast<uint64_t>(get_cpu_clock_ticks()));
+        double create_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+        size_t created = 0;
+        while (!rr_g_ready_queue.empty()) {
+            ProcessIndex index = rr_g_ready_queue.pop_front();
+            memory_manager->deallocate_for_process(g_process_table[index]);
+            g_process_table.release(index);
+            created++;
+        }
+
+        double mean_gap = gap_sum / PROCESS_COUNT;
+        double variance = std::max(0.0, gap_square_sum / PROCESS_COUNT - mean_gap * mean_gap);
+        table << std::left << std::setw(12) << label << std::right << std::fixed << std::setprecision(1)
+              << std::setw(14) << (PROCESS_COUNT / generate_seconds / 1e3)
+              << std::setw(16) << (created / create_seconds / 1e3)
+              << std::setw(14) << std::setprecision(2) << mean_gap
+              << std::setw(10) << (mean_gap > 0 ? std::sqrt(variance) / mean_gap : 0.0) << "\n";
+    }
+    std::cout << table.str() << std::endl;
+}
+
+// Ticks of every quantum of budget ticks, as a core would run them. Ticks spent before a page
+// fault count toward the same quantum; SLEEP ends it and the sleep itself costs no core ticks.
+std::vector<int> quantum_trace(Process& process, int budget) {
+    std::vector<int> quanta;
+    reset_execution(process);
+    int pending = 0;
+    for (;;) {
+        int ticks = 0;
+        ExecStatus status = interpreter_run(process, budget - pending, ticks);
+        pending += ticks;
+        if (status == ExecStatus::BLOCKED && pending < budget) continue;
+        quanta.push_back(pending);
+        pending = 0;
+        if (status == ExecStatus::FINISHED || status == ExecStatus::TERMINATED) return quanta;
+        if (status == ExecStatus::SLEEPING) process.sleep_ticks_remaining = 0;
+    }
+}
+
+BenchResult time_images(Process& process, const std::vector<std::shared_ptr<const ProgramImage>>& images, int budget) {
+    BenchResult result;
+    auto start = bench_clock::now();
+    auto elapsed = bench_clock::duration::zero();
+    do {
+        for (const auto& image : images) {
+            load_program(process, image);
+            result.instructions += run_to_completion(process, budget);
+        }
+        elapsed = bench_clock::now() - start;
+    } while (elapsed < MIN_BENCH_TIME);
+    result.seconds = std::chrono::duration<double>(elapsed).count();
+    return result;
+}
+
+// ns/tick of the scheduler-start workload before and after optimize_program. Each program must
+// spend the same ticks in every quantum either way; differing programs are counted as mismatches.
+void bench_optimizer() {
+    const int PROGRAM_COUNT = 1000;
+    WorkloadConfig config = workload_config_from_globals();
+    if (config.seed == 0) config.seed = 1;
+    config.min_mem = config.max_mem = BENCH_MEMORY_SIZE; // Stay resident: time the interpreter, not paging
+    config.optimize = false;
+    WorkloadGenerator generator(config);
+
+    std::vector<std::shared_ptr<const ProgramImage>> plain, optimized;
+    size_t plain_length = 0, optimized_length = 0;
+    auto optimize_time = bench_clock::duration::zero();
+    for (int i = 0; i < PROGRAM_COUNT; ++i) {
+        plain.push_back(generator.next().program);
+        auto image = std::make_shared<ProgramImage>(*plain.back());
+        auto start = bench_clock::now();
+        optimize_program(*image);
+        optimize_time += bench_clock::now() - start;
+        optimized.push_back(image);
+        plain_length += plain.back()->code.size();
+        optimized_length += image->code.size();
+    }
+
+    Process process(BENCH_PROCESS_ID);
+    process.cold->processName = "bench";
+    memory_manager->allocate_for_process(process, BENCH_MEMORY_SIZE);
+
+    const int quantum = std::max(1, qCycles);
+    int mismatches = 0;
+    for (int i = 0; i < PROGRAM_COUNT; ++i) {
+        load_program(process, plain[i]);
+        std::vector<int> expected = quantum_trace(process, quantum);
+        load_program(process, optimized[i]);
+        if (quantum_trace(process, quantum) != expected) mismatches++;
+    }
+
+    std::cout << "\n" << PROGRAM_COUNT << " generated programs, " << config.min_ins << "-" << config.max_ins
+              << " instructions, " << plain_length / PROGRAM_COUNT << " -> " << optimized_length / PROGRAM_COUNT
+              << " compiled instructions per program\n";
+    std::cout << std::left << std::setw(22) << "Quantum" << std::right << std::setw(12) << "ns/tick"
+              << std::setw(12) << "optimized" << std::setw(10) << "speedup" << "\n";
+    double saved_ns = 0;
+    for (int budget : {quantum, INT_MAX}) {
+        BenchResult before = time_images(process, plain, budget);
+        BenchResult after = time_images(process, optimized, budget);
+        double before_ns = before.seconds * 1e9 / before.instructions;
+        double after_ns = after.seconds * 1e9 / after.instructions;
+        saved_ns = (before.seconds / before.instructions - after.seconds / after.instructions) * 1e9;
+        std::cout << std::left << std::setw(22) << (budget == INT_MAX ? std::string("unbounded") : std::to_string(budget) + " ticks")
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(12) << before_ns
+                  << std::setw(12) << after_ns << std::setw(9) << before_ns / after_ns << "x\n";
+    }
+    // Ticks per program are the same before and after, so the saving per run is per tick times ticks.
+    uint64_t ticks_per_program = 0;
+    for (const auto& image : plain) {
+        load_program(process, image);
+        ticks_per_program += run_to_completion(process);
+    }
+    ticks_per_program /= PROGRAM_COUNT;
+    std::cout << "optimize_program: " << std::setprecision(2)
+              << std::chrono::duration<double, std::micro>(optimize_time).count() / PROGRAM_COUNT
+              << " us/program, saves " << saved_ns * ticks_per_program / 1e3 << " us per run of "
+              << ticks_per_program << " ticks\n";
+    std::cout << "Tick mismatches: " << mismatches << "\n";
+    memory_manager->deallocate_for_process(process);
+
+    // Again with core-cache 1, on a table process so its accesses go through core 0's cache, which
+    // is emptied before every trace. Optimized code skips accesses and so misses, which is why
+    // build_program leaves programs unoptimized then; as built, the traces must still match.
+    CoreCacheConfig cache = core_cache_config_from_globals();
+    cache.enabled = true;
+    int optimized_mismatches = 0, built_mismatches = 0;
+    ProcessIndex index = g_process_table.create(BENCH_PROCESS_ID);
+    if (index == NO_PROCESS) {
+        std::cout << "The process table is full; skipped the core-cache 1 check.\n" << std::endl;
+        return;
+    }
+    Process& cached = g_process_table[index];
+    cached.cold->processName = "bench";
+    g_process_table.core(index) = 0;
+    memory_manager->allocate_for_process(cached, BENCH_MEMORY_SIZE);
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        auto trace = [&](const std::shared_ptr<const ProgramImage>& image) {
+            g_core_caches.configure(cache, CPU_COUNT);
+            load_program(cached, image);
+            return quantum_trace(cached, quantum);
+        };
+        g_core_caches.configure(cache, CPU_COUNT);
+        for (int i = 0; i < PROGRAM_COUNT; ++i) {
+            std::vector<int> expected = trace(plain[i]);
+            if (trace(optimized[i]) != expected) optimized_mismatches++;
+            if (trace(build_program(program_source(*plain[i]))) != expected) built_mismatches++;
+        }
+        g_core_caches.configure(core_cache_config_from_globals(), CPU_COUNT);
+    }
+    memory_manager->deallocate_for_process(cached);
+    g_process_table.release(index);
+    std::cout << "Tick mismatches with core-cache 1: " << optimized_mismatches << " optimized, "
+              << built_mismatches << " as build_program leaves them\n" << std::endl;
+}
+
+// Executed ticks per second of the running RR cores at several quantum sizes. Each size gets
+// two long-running processes per core; they are drained with a large quantum afterwards and show up
+// as finished bench-q* processes.
+void bench_quantum() {
+    if (scheduler != "rr") {
+        std::cout << "\nThe quantum benchmark needs scheduler \"rr\" in config.txt.\n" << std::endl;
+        return;
+    }
+    const auto WINDOW = std::chrono::milliseconds(300);
+    const auto DRAIN_TIMEOUT = std::chrono::seconds(30);
+    const int DRAIN_QUANTUM = 100000;
+    // About 1M ticks per process; the window ends long before any process would finish.
+    const std::vector<std::string> program = {"FOR([FOR([FOR([ADD x x 1], 100)], 100)], 100)"};
+    const int processes_per_size = 2 * CPU_COUNT;
+    const int saved_quantum = qCycles;
+
+    std::cout << "\n" << CPU_COUNT << " cores, " << processes_per_size << " processes per quantum size\n";
+    std::cout << std::left << std::setw(12) << "Quantum" << std::right << std::setw(16) << "M ticks/s"
+              << std::setw(18) << "ticks/s per core" << "\n";
+    for (int quantum : {1, 4, 100, 10000}) {
+        qCycles = quantum;
+        std::vector<std::string> names;
+        long start_ticks = get_active_cpu_ticks();
+        auto start = bench_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            for (int i = 0; i < processes_per_size; ++i) {
+                names.push_back("bench-q" + std::to_string(quantum) + "-" + std::to_string(i));
+                g_creation_queue.push_back({names.back(), static_cast<size_t>(std::max(MIN_MEM_PER_PROC, SYMBOL_TABLE_BYTES)), build_program(program)});
+            }
+        }
+        rr_g_scheduler_cv.notify_one();
+        std::this_thread::sleep_for(WINDOW);
+        double ticks = static_cast<double>(get_active_cpu_ticks() - start_ticks);
+        double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        std::cout << std::left << std::setw(12) << quantum << std::right << std::fixed
+                  << std::setw(16) << std::setprecision(2) << ticks / seconds / 1e6
+                  << std::setw(18) << std::setprecision(0) << ticks / seconds / std::max(1, CPU_COUNT.load()) << std::endl;
+
+        // Let the processes run out quickly before the next size.
+        qCycles = DRAIN_QUANTUM;
+        auto drain_start = bench_clock::now();
+        for (;;) {
+            size_t finished = 0;
+            {
+                std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+                for (ProcessIndex p : rr_g_finished_processes) {
+                    if (std::find(names.begin(), names.end(), g_process_table[p].cold->processName) != names.end()) finished++;
+                }
+            }
+            if (finished == names.size() || bench_clock::now() - drain_start > DRAIN_TIMEOUT) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    qCycles = saved_quantum;
+    std::cout << std::endl;
+}
+
+// 100k processes on 4 cores of the live RR scheduler that each sleep twice for the longest SLEEP.
+// Sleepers wait on the timer wheel instead of a core, so nearly all of them sleep at once and the
+// cores only spend the SLEEP instructions themselves. The core count is restored afterwards.
+void bench_sleep() {
+    if (scheduler != "rr") {
+        std::cout << "\nThe sleep benchmark needs scheduler \"rr\" in config.txt.\n" << std::endl;
+        return;
+    }
+    const int CORES = 4;
+    const int PROCESSES = 100000;
+    const int SLEEP_TICKS = 65535;
+    const auto TIMEOUT = std::chrono::seconds(300);
+    auto program = build_program({"SLEEP " + std::to_string(SLEEP_TICKS), "SLEEP " + std::to_string(SLEEP_TICKS)});
+    size_t memory_size = static_cast<size_t>(std::max(MIN_MEM_PER_PROC, SYMBOL_TABLE_BYTES));
+
+    const int saved_cores = rr_set_core_count(CORES);
+    long start_active = get_active_cpu_ticks();
+    long start_idle = get_idle_cpu_ticks();
+    long start_clock = get_cpu_clock_ticks();
+    size_t start_finished;
+    auto start = bench_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        start_finished = rr_g_finished_processes.size();
+        for (int i = 0; i < PROCESSES; ++i) {
+            g_creation_queue.push_back({"bench-sleep-" + std::to_string(i), memory_size, program});
+        }
+    }
+    rr_g_scheduler_cv.notify_one();
+
+    size_t peak_sleeping = 0;
+    size_t finished = 0;
+    while (finished < PROCESSES && bench_clock::now() - start < TIMEOUT) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        peak_sleeping = std::max(peak_sleeping, rr_g_sleep_wheel.size());
+        finished = rr_g_finished_processes.size() - start_finished;
+    }
+    double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    long active = get_active_cpu_ticks() - start_active;
+    long idle = get_idle_cpu_ticks() - start_idle;
+    long clock = get_cpu_clock_ticks() - start_clock;
+    rr_set_core_count(saved_cores);
+
+    std::cout << "\n" << PROCESSES << " processes x 2 SLEEP " << SLEEP_TICKS << " on " << CORES << " cores\n";
+    std::cout << "  Finished            : " << finished << (finished < PROCESSES ? " (timed out)" : "") << "\n";
+    std::cout << "  Peak sleeping       : " << peak_sleeping << "\n";
+    std::cout << "  Wall time           : " << std::fixed << std::setprecision(2) << seconds << " s\n";
+    std::cout << "  Clock ticks elapsed : " << clock << "\n";
+    std::cout << "  Active CPU ticks    : " << active << " (" << std::setprecision(1)
+              << static_cast<double>(active) / PROCESSES << " per process)\n";
+    std::cout << "  Idle ticks skipped  : " << idle << "\n";
+    std::cout << "  Sleeping on a core would have cost " << 2LL * SLEEP_TICKS * PROCESSES << " active ticks\n" << std::endl;
+}
+
+// Final values of the process's variables; the lockstep run must leave the same ones as the scalar run.
+std::vector<uint16_t> variable_values(Process& process) {
+    std::vector<uint16_t> values;
+    for (size_t slot = 0; slot < process.image->variable_names.size(); ++slot) {
+        int address = static_cast<int>(slot * sizeof(uint16_t));
+        char* low = memory_manager->access_memory(process, address, false);
+        char* high = low ? memory_manager->access_memory(process, address + 1, false) : nullptr;
+        values.push_back(low && high ? static_cast<uint16_t>(static_cast<unsigned char>(*low) | (static_cast<unsigned char>(*high) << 8)) : 0);
+    }
+    return values;
+}
+
+// 10k processes running the same few generated arithmetic programs, each a few ticks behind the
+// previous process on its program, stepped a quantum at a time by interpreter_run and by
+// interpreter_run_lockstep. Processes run in batches that fit in physical memory together.
+void bench_lockstep() {
+    const int PROCESS_COUNT = 10000;
+    const int PROGRAM_COUNT = 4;
+    const int PHASES = 8; // Distinct starting offsets on each program
+    const int PROGRAM_INSTRUCTIONS = 1000;
+    WorkloadConfig config = workload_config_from_globals();
+    if (config.seed == 0) config.seed = 1;
+    config.min_ins = config.max_ins = PROGRAM_INSTRUCTIONS;
+    config.min_mem = config.max_mem = BENCH_MEMORY_SIZE;
+    parse_instruction_mix("declare=1 add=3 subtract=3 for=1", config.mix);
+    WorkloadGenerator generator(config);
+    std::vector<std::shared_ptr<const ProgramImage>> programs;
+    for (int i = 0; i < PROGRAM_COUNT; ++i) programs.push_back(generator.next().program);
+
+    if (!schedulers_idle()) {
+        std::cout << "\nThe lockstep benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    // Only the symbol table is touched, so each process keeps the frames covering it. The processes
+    // get a memory manager of their own, large enough for all of them at once up to MAX_MEMORY, in
+    // place of the system's for the run; max-overall-mem does not limit the batch.
+    const size_t MAX_MEMORY = size_t(64) << 20;
+    const std::string backing_store_path = "csopesy-bench-lockstep.bin";
+    size_t table_bytes = (SYMBOL_TABLE_BYTES + MEM_PER_FRAME - 1) / MEM_PER_FRAME * MEM_PER_FRAME;
+    size_t batch = std::clamp<size_t>(MAX_MEMORY / table_bytes, 1, PROCESS_COUNT);
+    MemoryManager* system_memory = memory_manager;
+    memory_manager = new MemoryManager(rr_g_ready_queue, rr_g_running_processes, fcfs_g_ready_queue,
+                                       fcfs_g_running_processes, static_cast<int>(batch * table_bytes), backing_store_path);
+
+    std::cout << "\n" << PROCESS_COUNT << " processes on " << PROGRAM_COUNT << " arithmetic programs of "
+              << PROGRAM_INSTRUCTIONS << " instructions, " << PHASES << " start offsets each, batches of " << batch << "\n";
+    std::cout << std::left << std::setw(12) << "Quantum" << std::right << std::setw(16) << "scalar M/s"
+              << std::setw(16) << "lockstep M/s" << std::setw(10) << "speedup" << "\n";
+
+    int mismatches = 0;
+    for (int quantum : {std::max(1, qCycles), 100, INT_MAX}) {
+        BenchResult results[2];
+        std::vector<std::vector<uint16_t>> final_values[2];
+        for (int mode = 0; mode < 2; ++mode) {
+            for (size_t first = 0; first < PROCESS_COUNT; first += batch) {
+                size_t count = std::min(batch, PROCESS_COUNT - first);
+                std::vector<std::unique_ptr<Process>> owned;
+                std::vector<Process*> active;
+                for (size_t i = first; i < first + count; ++i) {
+                    auto process = std::make_unique<Process>(BENCH_PROCESS_ID - static_cast<int>(i));
+                    process->cold->processName = "bench-lockstep-" + std::to_string(i);
+                    memory_manager->allocate_for_process(*process, BENCH_MEMORY_SIZE);
+                    load_program(*process, programs[i % PROGRAM_COUNT]);
+                    int offset = static_cast<int>(i / PROGRAM_COUNT % PHASES), ticks = 0;
+                    if (offset > 0) interpreter_run(*process, offset, ticks);
+                    active.push_back(process.get());
+                    owned.push_back(std::move(process));
+                }
+
+                std::vector<ExecStatus> statuses;
+                std::vector<int> ticks;
+                auto start = bench_clock::now();
+                while (!active.empty()) {
+                    if (mode == 0) {
+                        statuses.resize(active.size());
+                        ticks.resize(active.size());
+                        for (size_t i = 0; i < active.size(); ++i) statuses[i] = interpreter_run(*active[i], quantum, ticks[i]);
+                    } else {
+                        interpreter_run_lockstep(active, quantum, statuses, ticks);
+                    }
+                    size_t kept = 0;
+                    for (size_t i = 0; i < active.size(); ++i) {
+                        results[mode].instructions += ticks[i];
+                        if (statuses[i] == ExecStatus::FINISHED || statuses[i] == ExecStatus::TERMINATED) continue;
+                        active[kept++] = active[i];
+                    }
+                    active.resize(kept);
+                }
+                results[mode].seconds += std::chrono::duration<double>(bench_clock::now() - start).count();
+
+                for (auto& process : owned) {
+                    final_values[mode].push_back(variable_values(*process));
+                    memory_manager->deallocate_for_process(*process);
+                }
+            }
+        }
+        if (final_values[0] != final_values[1] || results[0].instructions != results[1].instructions) mismatches++;
+
+        double scalar_rate = results[0].instructions / results[0].seconds;
+        double lockstep_rate = results[1].instructions / results[1].seconds;
+        std::cout << std::left << std::setw(12) << (quantum == INT_MAX ? std::string("unbounded") : std::to_string(quantum))
+                  << std::right << std::fixed << std::setprecision(1) << std::setw(16) << scalar_rate / 1e6
+                  << std::setw(16) << lockstep_rate / 1e6 << std::setw(9) << std::setprecision(2)
+                  << lockstep_rate / scalar_rate << "x" << std::endl;
+    }
+    delete memory_manager;
+    memory_manager = system_memory;
+    std::remove(backing_store_path.c_str());
+    std::cout << "Result mismatches: " << mismatches << "\n" << std::endl;
+}
+
+// The PCB as the schedulers kept it before the process table: name, command list and variables in
+// the PCB, state among them, and a fault lock and condition variable per process.
+struct BaselineMemoryData {
+    size_t memory_size_bytes = 0;
+    long long creation_timestamp = 0;
+    long backing_store_offset = 0;
+    std::vector<PageTableEntry> page_table;
+    bool terminated_by_error = false;
+    std::string termination_reason;
+    std::mutex page_fault_mutex;
+    std::condition_variable page_fault_cv;
+};
+
+struct BaselineProcess {
+    int id;
+    std::string processName;
+    ProcessState state = ProcessState::NEW;
+    int arrival_time = 0, cpu_burst_time = 0, io_burst_time = 0;
+    int remaining_burst_time = 0, io_remaining_time = 0, instructions_per_run = 0;
+    int assigned_core = -1;
+    int program_counter = 0;
+    int commands_executed_this_quantum = 0;
+    std::vector<std::string> commands;
+    size_t memory_size = 0;
+    std::vector<std::tuple<std::string, uint16_t>> variables;
+    std::chrono::time_point<std::chrono::system_clock> start_time;
+    std::chrono::time_point<std::chrono::system_clock> finish_time;
+    BaselineMemoryData mem_data;
+
+    explicit BaselineProcess(int id) : id(id), processName("P" + std::to_string(id)) {}
+};
+
+// Footprint, creation cost and state-scan cost of slab-allocated table PCBs against the baseline PCBs
+// behind shared_ptr. Both count every heap block a new process gets (malloc headers aside); the
+// baseline's command lists are left empty, although every process used to carry its own copy.
+// Uses a private table.
+void bench_processtable() {
+    const int PROCESS_COUNT = 1000000;
+    const int SCANS = 20;
+
+    std::cout << "\n" << PROCESS_COUNT << " processes; table PCB " << sizeof(Process) << " bytes plus a "
+              << sizeof(ProcessColdData) << "-byte cold record (its PRINT log comes with the first PRINT); baseline PCB "
+              << sizeof(BaselineProcess) << " bytes\n";
+    std::cout << std::left << std::setw(22) << "Layout" << std::right << std::setw(14) << "bytes/proc"
+              << std::setw(14) << "ns/create" << std::setw(14) << "ns/scanned" << "\n";
+
+    auto print_layout = [&](const std::string& label, size_t bytes, double create_seconds, double scan_seconds) {
+        std::cout << std::left << std::setw(22) << label << std::right << std::setw(14) << bytes
+                  << std::fixed << std::setprecision(1) << std::setw(14) << create_seconds * 1e9 / PROCESS_COUNT
+                  << std::setprecision(2) << std::setw(14) << scan_seconds * 1e9 / (double(PROCESS_COUNT) * SCANS) << "\n";
+    };
+
+    size_t ready = 0;
+    {
+        auto table = std::make_unique<ProcessTable>();
+        auto start = bench_clock::now();
+        for (int i = 0; i < PROCESS_COUNT; ++i) {
+            ProcessIndex index = table->create(i);
+            table->state(index) = i % 3 == 0 ? ProcessState::READY : ProcessState::BLOCKED;
+        }
+        double create_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+        start = bench_clock::now();
+        for (int scan = 0; scan < SCANS; ++scan) {
+            for (ProcessIndex index = 0; index < PROCESS_COUNT; ++index) {
+                ready += table->state(index) == ProcessState::READY;
+            }
+        }
+        double scan_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        print_layout("process table", ProcessTable::bytes_per_process() + sizeof(ProcessColdData), create_seconds, scan_seconds);
+    }
+    {
+        // The old scheduler loops dereferenced each PCB for its state.
+        std::vector<std::shared_ptr<BaselineProcess>> processes;
+        processes.reserve(PROCESS_COUNT);
+        auto start = bench_clock::now();
+        for (int i = 0; i < PROCESS_COUNT; ++i) {
+            processes.push_back(std::make_shared<BaselineProcess>(i));
+            processes.back()->state = i % 3 == 0 ? ProcessState::READY : ProcessState::BLOCKED;
+        }
+        double create_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+
+        start = bench_clock::now();
+        for (int scan = 0; scan < SCANS; ++scan) {
+            for (const auto& pcb : processes) {
+                ready += pcb->state == ProcessState::READY;
+            }
+        }
+        double scan_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        // make_shared puts the control block next to the PCB; the list adds a pointer pair per process.
+        print_layout("baseline shared_ptr", sizeof(BaselineProcess) + 2 * sizeof(void*) + sizeof(std::shared_ptr<BaselineProcess>),
+                     create_seconds, scan_seconds);
+    }
+    std::cout << "READY entries counted: " << ready << "\n" << std::endl;
+}
+
+// --- Ready-Queue Policies ---
+
+// A process a policy benchmark submits to the live RR scheduler, delay after the previous one.
+struct LiveJob {
+    std::string name;
+    std::shared_ptr<const ProgramImage> program;
+    std::chrono::microseconds delay;
+    size_t memory_size = 0; // 0 for the smallest size that holds the symbol table
+    uint32_t weight = 0;    // 0 for default-weight
+    uint64_t deadline = 0;  // CPU ticks after arrival, 0 for none
+};
+
+struct LiveRun {
+    std::vector<ProcessIndex> finished; // In finishing order
+    double seconds = 0;
+    long active_ticks = 0;
+    bool timed_out = false;
+    size_t start_finished = 0;
+    long start_active = 0;
+    bench_clock::time_point start;
+};
+
+// Puts back the ready-queue policy and quantum tuning config.txt asked for after a benchmark swapped
+// them out.
+void restore_configured_policy() {
+    ReadyPolicy configured = ReadyPolicy::FIFO;
+    parse_ready_policy(scheduler, configured);
+    std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+    rr_g_ready_queue.set_policy(configured, mlfq_config_from_globals());
+    rr_g_quantum_tuner.configure(quantum_tuner_config_from_globals(), qCycles);
+}
+
+// Turns the adaptive quantum on or off for the next live run, starting from quantum-cycles.
+void set_quantum_tuning(bool enabled) {
+    QuantumTunerConfig config = quantum_tuner_config_from_globals();
+    config.enabled = enabled;
+    std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+    rr_g_quantum_tuner.configure(config, qCycles);
+}
+
+size_t live_job_memory_size(const LiveJob& job) {
+    return job.memory_size > 0 ? job.memory_size : static_cast<size_t>(std::max(MIN_MEM_PER_PROC, SYMBOL_TABLE_BYTES));
+}
+
+// Prints a note when the frames cannot hold the pages every job touches (its variables and the data
+// its READs and WRITEs reach) at once. Page faults then decide the results rather than the policy,
+// and the runs may hit their timeout.
+void note_frame_shortage(const std::vector<LiveJob>& jobs) {
+    long long pages = 0;
+    for (const auto& job : jobs) {
+        int touched = SYMBOL_TABLE_BYTES;
+        for (const Instruction& ins : job.program->code) {
+            if (ins.op == Opcode::READ || ins.op == Opcode::WRITE || ins.op == Opcode::WRITE_READ) touched = std::max(touched, ins.address + 2);
+        }
+        size_t bytes = std::min(live_job_memory_size(job), static_cast<size_t>(touched));
+        pages += static_cast<long long>((bytes + MEM_PER_FRAME - 1) / MEM_PER_FRAME);
+    }
+    if (pages <= FRAME_COUNT) return;
+    std::cout << "Note: the processes touch " << pages << " pages and there are only " << FRAME_COUNT << " frames, so page faults "
+              << "rather than the policy decide the results and runs may time out; max-overall-mem "
+              << pages * MEM_PER_FRAME << " or more measures the policy.\n";
+}
+
+// Switches the live RR scheduler to policy and submits jobs, each after its delay.
+LiveRun start_live_jobs(ReadyPolicy policy, const std::vector<LiveJob>& jobs) {
+    LiveRun run;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        rr_g_ready_queue.set_policy(policy, mlfq_config_from_globals());
+        run.start_finished = rr_g_finished_processes.size();
+    }
+    run.start_active = get_active_cpu_ticks();
+    run.start = bench_clock::now();
+    auto next_submit = run.start;
+    for (const auto& job : jobs) {
+        next_submit += job.delay;
+        std::this_thread::sleep_until(next_submit);
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            g_creation_queue.push_back({job.name, live_job_memory_size(job), job.program, job.weight, job.deadline});
+        }
+        rr_g_scheduler_cv.notify_one();
+    }
+    return run;
+}
+
+// Waits until count processes have finished since start_live_jobs, or timeout has passed since it.
+void wait_live_jobs(LiveRun& run, size_t count, std::chrono::seconds timeout) {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            bool timed_out = bench_clock::now() - run.start > timeout;
+            if (rr_g_finished_processes.size() - run.start_finished >= count || timed_out) {
+                // On a timeout the results cover the processes that did finish.
+                run.finished.assign(rr_g_finished_processes.begin() + run.start_finished, rr_g_finished_processes.end());
+                run.timed_out = rr_g_finished_processes.size() - run.start_finished < count;
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    run.seconds = std::chrono::duration<double>(bench_clock::now() - run.start).count();
+    run.active_ticks = get_active_cpu_ticks() - run.start_active;
+}
+
+// Marks a row whose run hit its timeout; its figures cover only the processes that finished.
+std::string timed_out_note(const LiveRun& run) {
+    return run.timed_out ? "  (timed out, " + std::to_string(run.finished.size()) + " finished)" : "";
+}
+
+// Runs jobs on the live RR scheduler under policy and waits for all of them to finish.
+LiveRun run_live_jobs(ReadyPolicy policy, const std::vector<LiveJob>& jobs, std::chrono::seconds timeout) {
+    LiveRun run = start_live_jobs(policy, jobs);
+    wait_live_jobs(run, jobs.size(), timeout);
+    return run;
+}
+
+// Mean response (arrival to first dispatch) and turnaround (arrival to finish) in CPU clock ticks
+// of the finished processes whose name starts with prefix.
+struct TickMeans {
+    size_t count = 0;
+    double response = 0;
+    double turnaround = 0;
+};
+
+TickMeans tick_means(const std::vector<ProcessIndex>& finished, const std::string& prefix) {
+    TickMeans means;
+    for (ProcessIndex index : finished) {
+        const Process& p = g_process_table[index];
+        if (p.cold->processName.compare(0, prefix.size(), prefix) != 0) continue;
+        means.count++;
+        means.response += static_cast<double>(p.first_run_tick - p.arrival_tick);
+        means.turnaround += static_cast<double>(p.finish_tick - p.arrival_tick);
+    }
+    if (means.count > 0) {
+        means.response /= means.count;
+        means.turnaround /= means.count;
+    }
+    return means;
+}
+
+// Mixed workload on the live RR scheduler under round robin and under MLFQ: long CPU-bound processes
+// arrive first, then short interactive ones (a few instructions between SLEEPs) trickle in while the
+// CPU-bound ones are still running.
+void bench_mlfq() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe mlfq benchmark needs an RR-family scheduler (e.g. \"rr\" or \"mlfq\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe mlfq benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int CPU_BOUND = 32 * std::max(1, CPU_COUNT.load());
+    const int INTERACTIVE = 200;
+    const auto INTERACTIVE_GAP = std::chrono::microseconds(500);
+    const auto TIMEOUT = std::chrono::seconds(120);
+    // Unoptimized, so the loop really takes its ~10k ticks.
+    auto cpu_bound = build_program({"FOR([FOR([ADD x x 1], 100)], 100)"}, false);
+    std::vector<std::string> interactive_commands;
+    for (int i = 0; i < 5; ++i) {
+        interactive_commands.insert(interactive_commands.end(), {"ADD x x 1", "ADD x x 1", "SLEEP 20"});
+    }
+    auto interactive = build_program(interactive_commands, false);
+
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < CPU_BOUND; ++i) jobs.push_back({"bench-mlfq-cpu-" + std::to_string(i), cpu_bound, std::chrono::microseconds(0)});
+    for (int i = 0; i < INTERACTIVE; ++i) jobs.push_back({"bench-mlfq-io-" + std::to_string(i), interactive, INTERACTIVE_GAP});
+
+    MlfqConfig mlfq = mlfq_config_from_globals();
+    std::cout << "\n" << CPU_BOUND << " CPU-bound + " << INTERACTIVE << " interactive processes on " << CPU_COUNT
+              << " cores; RR quantum " << std::max(1, qCycles) << ", MLFQ quanta";
+    for (int quantum : mlfq.quanta) std::cout << " " << quantum;
+    std::cout << ", boost every " << mlfq.boost_ticks << " ticks\n";
+    note_frame_shortage(jobs);
+    std::cout << std::left << std::setw(8) << "Policy" << std::right << std::setw(16) << "io response" << std::setw(18) << "io turnaround"
+              << std::setw(16) << "cpu response" << std::setw(18) << "cpu turnaround" << std::setw(12) << "procs/s" << std::setw(12) << "M ticks/s" << "\n";
+    for (ReadyPolicy policy : {ReadyPolicy::FIFO, ReadyPolicy::MLFQ}) {
+        LiveRun run = run_live_jobs(policy, jobs, TIMEOUT);
+        TickMeans io = tick_means(run.finished, "bench-mlfq-io-");
+        TickMeans cpu = tick_means(run.finished, "bench-mlfq-cpu-");
+        std::cout << std::left << std::setw(8) << (policy == ReadyPolicy::MLFQ ? "MLFQ" : "RR") << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << io.response << std::setw(18) << io.turnaround
+                  << std::setw(16) << cpu.response << std::setw(18) << cpu.turnaround
+                  << std::setw(12) << run.finished.size() / run.seconds
+                  << std::setw(12) << std::setprecision(2) << run.active_ticks / run.seconds / 1e6
+                  << timed_out_note(run) << std::endl;
+    }
+    std::cout << "Response and turnaround are mean CPU clock ticks.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// ns per push and pop of the SJF / SRTF heap holding 100k ready processes at once, then turnaround on
+// the live RR scheduler for one seeded generated workload under FCFS, RR, SJF and SRTF. All processes
+// arrive together, so the policies differ only in the order they run them. FCFS is the RR cores with
+// an unbounded quantum, which runs processes in arrival order to completion like the FCFS scheduler.
+void bench_sjf() {
+    const int HEAP_SIZE = 100000;
+    IndexedHeap heap;
+    WorkloadEngine keys(1);
+    auto start = bench_clock::now();
+    for (ProcessIndex i = 0; i < HEAP_SIZE; ++i) heap.push(i, keys() % 100000);
+    double push_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / HEAP_SIZE;
+    start = bench_clock::now();
+    uint64_t last_key = 0;
+    bool ordered = true;
+    while (!heap.empty()) {
+        ordered = ordered && heap.top_key() >= last_key;
+        last_key = heap.top_key();
+        heap.pop();
+    }
+    double pop_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / HEAP_SIZE;
+    std::cout << "\nReady heap of " << HEAP_SIZE << ": " << std::fixed << std::setprecision(1) << push_ns << " ns/push, "
+              << pop_ns << " ns/pop" << (ordered ? "" : " (OUT OF ORDER)") << "\n";
+
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "The turnaround comparison needs an RR-family scheduler (e.g. \"rr\" or \"sjf\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "The turnaround comparison needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int PROCESS_COUNT = 1000;
+    const auto TIMEOUT = std::chrono::seconds(300);
+    WorkloadConfig config = workload_config_from_globals();
+    if (config.seed == 0) config.seed = 1;
+    // Spread the lengths so that the order matters.
+    config.min_ins = 10;
+    config.max_ins = 1000;
+    // One page each, so paging does not drown out the scheduling order.
+    config.min_mem = config.max_mem = static_cast<size_t>(std::max(MEM_PER_FRAME, SYMBOL_TABLE_BYTES));
+    WorkloadGenerator generator(config);
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESS_COUNT; ++i) {
+        GeneratedProcess generated = generator.next();
+        jobs.push_back({"bench-sjf-" + std::to_string(i), generated.program, std::chrono::microseconds(0), generated.memory_size});
+    }
+
+    std::cout << PROCESS_COUNT << " processes, " << config.min_ins << "-" << config.max_ins << " instructions, seed "
+              << config.seed << ", " << CPU_COUNT << " cores, quantum " << std::max(1, qCycles) << "\n";
+    note_frame_shortage(jobs);
+    std::cout << std::left << std::setw(8) << "Policy" << std::right << std::setw(18) << "mean turnaround"
+              << std::setw(16) << "mean response" << std::setw(12) << "wall s" << "\n";
+    const int saved_quantum = qCycles;
+    const std::vector<std::pair<std::string, ReadyPolicy>> policies = {
+        {"FCFS", ReadyPolicy::FIFO}, {"RR", ReadyPolicy::FIFO}, {"SJF", ReadyPolicy::SJF}, {"SRTF", ReadyPolicy::SRTF},
+    };
+    for (const auto& [label, policy] : policies) {
+        qCycles = label == "FCFS" ? INT_MAX : saved_quantum;
+        LiveRun run = run_live_jobs(policy, jobs, TIMEOUT);
+        TickMeans means = tick_means(run.finished, "bench-sjf-");
+        std::cout << std::left << std::setw(8) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(18) << means.turnaround << std::setw(16) << means.response
+                  << std::setw(12) << std::setprecision(2) << run.seconds << timed_out_note(run) << std::endl;
+    }
+    qCycles = saved_quantum;
+    std::cout << "Turnaround and response are mean CPU clock ticks.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// ns per pick of the stride heap and the lottery tree holding 100k weighted processes, then the CPU
+// share 1000 CPU-bound processes with seeded weights 1-10 get on the live RR scheduler under RR,
+// stride and lottery. Each process asks for weight / total weight of the executed ticks; the report
+// is how far the share it got over the window strays from that. The window is cut short if any
+// process finishes, since the shares of the rest change from then on.
+void bench_stride() {
+    const int PICK_COUNT = 100000;
+    WorkloadEngine weights(1);
+    IndexedHeap heap;
+    auto start = bench_clock::now();
+    for (ProcessIndex i = 0; i < PICK_COUNT; ++i) heap.push(i, ReadyQueue::STRIDE_UNIT / (1 + weights() % 10));
+    for (int i = 0; i < PICK_COUNT; ++i) {
+        // A pick charges its process one quantum and queues it again, as the scheduler does.
+        ProcessIndex top = heap.top();
+        heap.update(top, heap.top_key() + ReadyQueue::STRIDE_UNIT / (1 + top % 10));
+    }
+    double stride_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / (2.0 * PICK_COUNT);
+    TicketTree tree;
+    start = bench_clock::now();
+    for (ProcessIndex i = 0; i < PICK_COUNT; ++i) tree.add(i, static_cast<uint32_t>(1 + weights() % 10));
+    for (int i = 0; i < PICK_COUNT; ++i) {
+        ProcessIndex winner = tree.draw(weights);
+        tree.add(winner, static_cast<uint32_t>(1 + winner % 10));
+    }
+    double lottery_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / (2.0 * PICK_COUNT);
+    std::cout << "\nPick among " << PICK_COUNT << " weighted processes: stride heap " << std::fixed << std::setprecision(1)
+              << stride_ns << " ns, lottery tree " << lottery_ns << " ns\n";
+
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "The share comparison needs an RR-family scheduler (e.g. \"rr\" or \"stride\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "The share comparison needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int PROCESS_COUNT = 1000;
+    const int MAX_WEIGHT = 10;
+    const auto WINDOW = std::chrono::seconds(5);
+    const auto SAMPLE_PERIOD = std::chrono::milliseconds(100);
+    const auto TIMEOUT = std::chrono::seconds(300);
+    const std::string PREFIX = "bench-share-";
+    // Unoptimized, so each process really takes its ~20k ticks and outlasts the window.
+    auto cpu_bound = build_program({"FOR([FOR([ADD x x 1], 100)], 200)"}, false);
+    const size_t memory_size = static_cast<size_t>(std::max(MEM_PER_FRAME, SYMBOL_TABLE_BYTES));
+    WorkloadEngine draws(WORKLOAD_SEED != 0 ? WORKLOAD_SEED : 1);
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESS_COUNT; ++i) {
+        jobs.push_back({PREFIX + std::to_string(i), cpu_bound, std::chrono::microseconds(0), memory_size,
+                        static_cast<uint32_t>(1 + draws() % MAX_WEIGHT)});
+    }
+
+    if (FRAME_COUNT < PROCESS_COUNT) {
+        std::cout << "Note: " << FRAME_COUNT << " frames for " << PROCESS_COUNT << " one-page processes, so page faults rather than the "
+                  << "policy decide the shares; max-overall-mem " << static_cast<long long>(PROCESS_COUNT) * MEM_PER_FRAME << " or more measures the policy.\n";
+    }
+    std::cout << PROCESS_COUNT << " CPU-bound processes, weights 1-" << MAX_WEIGHT << ", " << CPU_COUNT << " cores, quantum "
+              << std::max(1, qCycles) << ", " << WINDOW.count() << " s window\n";
+    std::cout << std::left << std::setw(9) << "Policy" << std::right << std::setw(12) << "window s" << std::setw(12) << "ticks"
+              << std::setw(14) << "mean |dev|" << std::setw(12) << "p99 |dev|" << std::setw(12) << "max |dev|"
+              << std::setw(16) << "w10/w1 share" << "\n";
+    const int saved_quantum = qCycles;
+    const std::vector<std::pair<std::string, ReadyPolicy>> policies = {
+        {"RR", ReadyPolicy::FIFO}, {"Stride", ReadyPolicy::STRIDE}, {"Lottery", ReadyPolicy::LOTTERY},
+    };
+    for (const auto& [label, policy] : policies) {
+        size_t table_start = g_process_table.size();
+        LiveRun run = start_live_jobs(policy, jobs);
+
+        // The window opens once the scheduler has created every process, so all of them compete.
+        std::vector<ProcessIndex> members;
+        while (members.size() < jobs.size() && bench_clock::now() - run.start < TIMEOUT) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            members.clear();
+            for (ProcessIndex index = static_cast<ProcessIndex>(table_start); index < static_cast<ProcessIndex>(g_process_table.size()); ++index) {
+                if (g_process_table[index].cold->processName.compare(0, PREFIX.size(), PREFIX) == 0) members.push_back(index);
+            }
+        }
+        auto sample = [&](std::vector<uint64_t>& ticks) {
+            ticks.clear();
+            for (ProcessIndex index : members) ticks.push_back(g_process_table[index].ticks_executed.load(std::memory_order_relaxed));
+        };
+        auto any_finished = [&] {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            return rr_g_finished_processes.size() > run.start_finished;
+        };
+        std::vector<uint64_t> opened, closed, next;
+        sample(opened);
+        closed = opened;
+        auto window_start = bench_clock::now();
+        auto window_end = window_start;
+        while (bench_clock::now() - window_start < WINDOW) {
+            std::this_thread::sleep_for(SAMPLE_PERIOD);
+            sample(next);
+            if (any_finished()) break;
+            closed = next;
+            window_end = bench_clock::now();
+        }
+
+        // Finish the rest quickly: one long quantum each, in arrival order.
+        qCycles = INT_MAX;
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            rr_g_ready_queue.set_policy(ReadyPolicy::FIFO);
+        }
+        wait_live_jobs(run, jobs.size(), TIMEOUT);
+        qCycles = saved_quantum;
+
+        // Share deviation: achieved share / requested share - 1 for each process.
+        uint64_t total_ticks = 0, total_weight = 0;
+        for (size_t i = 0; i < members.size(); ++i) {
+            total_ticks += closed[i] - opened[i];
+            total_weight += g_process_table[members[i]].weight;
+        }
+        std::vector<double> deviations;
+        double light_share = 0, heavy_share = 0;
+        int light_count = 0, heavy_count = 0;
+        for (size_t i = 0; i < members.size() && total_ticks > 0; ++i) {
+            uint32_t weight = g_process_table[members[i]].weight;
+            double achieved = static_cast<double>(closed[i] - opened[i]) / total_ticks;
+            double requested = static_cast<double>(weight) / total_weight;
+            deviations.push_back(std::abs(achieved / requested - 1.0));
+            if (weight == 1) { light_share += achieved; light_count++; }
+            if (weight == static_cast<uint32_t>(MAX_WEIGHT)) { heavy_share += achieved; heavy_count++; }
+        }
+        std::sort(deviations.begin(), deviations.end());
+        double mean = 0;
+        for (double deviation : deviations) mean += deviation;
+        if (!deviations.empty()) mean /= deviations.size();
+        double p99 = deviations.empty() ? 0 : deviations[deviations.size() * 99 / 100];
+        double max = deviations.empty() ? 0 : deviations.back();
+        double ratio = light_count > 0 && heavy_count > 0 && light_share > 0 ? (heavy_share / heavy_count) / (light_share / light_count) : 0;
+        std::cout << std::left << std::setw(9) << label << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << std::chrono::duration<double>(window_end - window_start).count()
+                  << std::setw(12) << total_ticks << std::setprecision(1)
+                  << std::setw(13) << mean * 100 << "%" << std::setw(11) << p99 * 100 << "%" << std::setw(11) << max * 100 << "%"
+                  << std::setw(16) << std::setprecision(2) << ratio << timed_out_note(run) << std::endl;
+    }
+    std::cout << "|dev| is |achieved share / requested share - 1| per process; w10/w1 is the mean share of a weight-"
+              << MAX_WEIGHT << " process over that of a weight-1 process (" << MAX_WEIGHT << " requested).\n" << std::endl;
+    restore_configured_policy();
+}
+
+// Deadline outcomes on the live RR scheduler for one seeded batch of jobs under RR, SJF and EDF.
+// The jobs arrive together with 100-1000 ticks of work each, and each deadline falls between 0.1x
+// and 0.9x the CPU clock ticks the cores need for the whole batch, so the batch overloads the cores
+// and some deadlines cannot be met whatever the order. EDF's admission test turns those jobs away
+// up front (they still run, as best effort) so the admitted ones can finish in time.
+void bench_edf() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe edf benchmark needs an RR-family scheduler (e.g. \"rr\" or \"edf\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe edf benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int PROCESS_COUNT = 400;
+    const auto TIMEOUT = std::chrono::seconds(300);
+    const std::string PREFIX = "bench-edf-";
+    const int cores = std::max(1, CPU_COUNT.load());
+    WorkloadEngine draws(WORKLOAD_SEED != 0 ? WORKLOAD_SEED : 1);
+    std::vector<uint64_t> work(PROCESS_COUNT);
+    uint64_t total_work = 0;
+    for (auto& ticks : work) {
+        ticks = 100 + draws() % 901;
+        total_work += ticks;
+    }
+    const uint64_t batch_ticks = total_work / cores;
+    const size_t memory_size = static_cast<size_t>(std::max(MEM_PER_FRAME, SYMBOL_TABLE_BYTES));
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESS_COUNT; ++i) {
+        // Unoptimized, so the loop really takes its ticks.
+        auto program = build_program({"FOR([ADD x x 1], " + std::to_string(work[i]) + ")"}, false);
+        uint64_t deadline = batch_ticks / 10 + draws() % (batch_ticks * 8 / 10 + 1);
+        jobs.push_back({PREFIX + std::to_string(i), program, std::chrono::microseconds(0), memory_size, 0, std::max(work[i], deadline)});
+    }
+
+    std::cout << "\n" << PROCESS_COUNT << " jobs of 100-1000 ticks (" << total_work << " in all) on " << cores
+              << " cores, deadlines " << batch_ticks / 10 << "-" << batch_ticks * 9 / 10 << " ticks after arrival, quantum "
+              << std::max(1, qCycles) << "\n";
+    note_frame_shortage(jobs);
+    std::cout << std::left << std::setw(8) << "Policy" << std::right << std::setw(10) << "missed" << std::setw(10) << "rejected"
+              << std::setw(18) << "admitted missed" << std::setw(12) << "p50 late" << std::setw(12) << "p99 late"
+              << std::setw(12) << "max late" << std::setw(10) << "wall s" << "\n";
+    const std::vector<std::pair<std::string, ReadyPolicy>> policies = {
+        {"RR", ReadyPolicy::FIFO}, {"SJF", ReadyPolicy::SJF}, {"EDF", ReadyPolicy::EDF},
+    };
+    for (const auto& [label, policy] : policies) {
+        LiveRun run = run_live_jobs(policy, jobs, TIMEOUT);
+        std::vector<int64_t> lateness;
+        size_t missed = 0, rejected = 0, admitted_missed = 0;
+        for (ProcessIndex index : run.finished) {
+            const Process& p = g_process_table[index];
+            if (p.cold->processName.compare(0, PREFIX.size(), PREFIX) != 0) continue;
+            int64_t late = static_cast<int64_t>(p.finish_tick) - static_cast<int64_t>(p.deadline_tick);
+            lateness.push_back(late);
+            if (p.deadline_rejected) rejected++;
+            if (late > 0) {
+                missed++;
+                if (!p.deadline_rejected) admitted_missed++;
+            }
+        }
+        std::sort(lateness.begin(), lateness.end());
+        auto quantile = [&](double q) { return lateness.empty() ? 0 : lateness[static_cast<size_t>(q * (lateness.size() - 1))]; };
+        std::cout << std::left << std::setw(8) << label << std::right << std::setw(10) << missed << std::setw(10) << rejected
+                  << std::setw(18) << admitted_missed << std::setw(12) << quantile(0.50) << std::setw(12) << quantile(0.99)
+                  << std::setw(12) << (lateness.empty() ? 0 : lateness.back()) << std::setw(10) << std::fixed << std::setprecision(2)
+                  << run.seconds << timed_out_note(run) << std::endl;
+    }
+    std::cout << "Lateness is finish tick - deadline tick in CPU clock ticks; negative is early.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// The bench_mlfq mix of CPU-bound and interactive processes under round robin at every static quantum
+// of a sweep, then with the adaptive quantum, which starts from quantum-cycles. The best static
+// quantum is the one with the quickest interactive response among those within
+// target-switch-overhead of the sweep's peak throughput.
+void bench_adaptive() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe adaptive benchmark needs an RR-family scheduler (e.g. \"rr\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe adaptive benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int CPU_BOUND = 8 * std::max(1, CPU_COUNT.load());
+    const int INTERACTIVE = 200;
+    const auto INTERACTIVE_GAP = std::chrono::microseconds(500);
+    const auto TIMEOUT = std::chrono::seconds(120);
+    const std::vector<int> SWEEP = {1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+    auto cpu_bound = build_program({"FOR([FOR([ADD x x 1], 100)], 100)"}, false);
+    std::vector<std::string> interactive_commands;
+    for (int i = 0; i < 5; ++i) {
+        interactive_commands.insert(interactive_commands.end(), {"ADD x x 1", "ADD x x 1", "SLEEP 20"});
+    }
+    auto interactive = build_program(interactive_commands, false);
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < CPU_BOUND; ++i) jobs.push_back({"bench-adaptive-cpu-" + std::to_string(i), cpu_bound, std::chrono::microseconds(0)});
+    for (int i = 0; i < INTERACTIVE; ++i) jobs.push_back({"bench-adaptive-io-" + std::to_string(i), interactive, INTERACTIVE_GAP});
+
+    QuantumTunerConfig tuning = quantum_tuner_config_from_globals();
+    std::cout << "\n" << CPU_BOUND << " CPU-bound + " << INTERACTIVE << " interactive processes on " << CPU_COUNT
+              << " cores; adaptive bounds " << tuning.min_quantum << "-" << tuning.max_quantum << ", target response "
+              << tuning.target_response_ticks << " ticks, target switch overhead " << tuning.target_overhead * 100 << "%\n";
+    note_frame_shortage(jobs);
+    std::cout << std::left << std::setw(10) << "Quantum" << std::right << std::setw(12) << "M ticks/s" << std::setw(16) << "io response"
+              << std::setw(18) << "io turnaround" << std::setw(18) << "cpu turnaround" << "\n";
+
+    struct Row {
+        std::string label;
+        double ticks_per_second;
+        TickMeans io;
+        TickMeans cpu;
+    };
+    auto measure = [&](const std::string& label) {
+        LiveRun run = run_live_jobs(ReadyPolicy::FIFO, jobs, TIMEOUT);
+        Row row{label, run.active_ticks / run.seconds, tick_means(run.finished, "bench-adaptive-io-"), tick_means(run.finished, "bench-adaptive-cpu-")};
+        std::cout << std::left << std::setw(10) << row.label << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << row.ticks_per_second / 1e6 << std::setprecision(1) << std::setw(16) << row.io.response
+                  << std::setw(18) << row.io.turnaround << std::setw(18) << row.cpu.turnaround
+                  << timed_out_note(run) << std::endl;
+        return row;
+    };
+
+    const int saved_quantum = qCycles;
+    set_quantum_tuning(false);
+    std::vector<Row> sweep;
+    for (int quantum : SWEEP) {
+        qCycles = quantum;
+        sweep.push_back(measure(std::to_string(quantum)));
+    }
+    qCycles = saved_quantum;
+    // The tuner's own order of goals: switching costs at most the target share of the peak throughput,
+    // then the quickest response.
+    double peak = 0;
+    for (const Row& row : sweep) peak = std::max(peak, row.ticks_per_second);
+    const Row* best = nullptr;
+    for (const Row& row : sweep) {
+        if (row.ticks_per_second >= (1 - tuning.target_overhead) * peak && (!best || row.io.response < best->io.response)) best = &row;
+    }
+
+    set_quantum_tuning(true);
+    Row adaptive = measure("adaptive");
+    std::vector<QuantumTuner::Sample> samples;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        samples = rr_g_quantum_tuner.log();
+    }
+    std::cout << "Best static quantum " << best->label << ": " << std::setprecision(3) << best->ticks_per_second / 1e6
+              << " M ticks/s, io response " << std::setprecision(1) << best->io.response << "; adaptive "
+              << std::setprecision(3) << adaptive.ticks_per_second / 1e6 << " M ticks/s, io response "
+              << std::setprecision(1) << adaptive.io.response << "\n";
+    double switch_ns = 0, tick_ns = 0;
+    for (const auto& sample : samples) {
+        switch_ns += sample.switch_ns;
+        tick_ns += sample.tick_ns;
+    }
+    if (!samples.empty()) {
+        std::cout << "Measured: switch " << std::setprecision(0) << switch_ns / samples.size() << " ns, tick "
+                  << std::setprecision(1) << tick_ns / samples.size() << " ns\n";
+    }
+    // About a dozen evenly spaced points of the quantum the tuner chose.
+    std::cout << "Adaptive quantum over " << samples.size() << " updates (tick: quantum / ready):";
+    size_t step = std::max<size_t>(1, samples.size() / 12);
+    for (size_t i = 0; i < samples.size(); i += step) {
+        std::cout << " " << samples[i].tick << ": " << samples[i].quantum << "/" << samples[i].ready;
+    }
+    std::cout << "\nResponse and turnaround are mean CPU clock ticks.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// Processes that each sweep a working set of three quarters of a core cache over and over, four per
+// core, under round robin with cache-affinity dispatch off and on. All of them together overflow a
+// core's cache, but the four that stay on one core fit in it, so only affinity lets lines survive
+// the quantum a process spends off its core. Throughput counts instructions, not stall ticks.
+void bench_affinity() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe affinity benchmark needs an RR-family scheduler (e.g. \"rr\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe affinity benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    CoreCacheConfig cache = core_cache_config_from_globals();
+    cache.enabled = true;
+    const int PROCESSES = 4 * std::max(1, CPU_COUNT.load());
+    const int LINES = std::max(1, cache.sets * cache.ways * 3 / 16); // Three quarters of a cache / 4 processes
+    const int SWEEPS = 200;
+    const auto TIMEOUT = std::chrono::seconds(120);
+    std::string body;
+    for (int line = 0; line < LINES; ++line) {
+        if (line > 0) body += "; ";
+        body += "READ x " + std::to_string(SYMBOL_TABLE_BYTES + line * cache.line_bytes);
+    }
+    auto program = build_program({"FOR([" + body + "], " + std::to_string(SWEEPS) + ")"}, false);
+    const size_t memory_size = std::bit_ceil(static_cast<size_t>(SYMBOL_TABLE_BYTES + LINES * cache.line_bytes));
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESSES; ++i) jobs.push_back({"bench-affinity-" + std::to_string(i), program, std::chrono::microseconds(0), memory_size});
+
+    std::cout << "\n" << PROCESSES << " processes x " << LINES << " cache lines on " << CPU_COUNT << " cores; caches of "
+              << cache.sets << " sets x " << cache.ways << " ways x " << cache.line_bytes << " bytes, " << cache.miss_penalty
+              << " ticks per miss, migration-cost " << MIGRATION_COST << ", quantum " << qCycles << "\n";
+    if (static_cast<size_t>(FRAME_COUNT) * MEM_PER_FRAME < memory_size * PROCESSES) {
+        std::cout << "Note: the working sets need " << memory_size * PROCESSES << " bytes of memory and only " << MAX_OVERALL_MEM
+                  << " are configured, so paging blurs the comparison.\n";
+    }
+    std::cout << std::left << std::setw(10) << "Affinity" << std::right << std::setw(10) << "Hit rate" << std::setw(14) << "Migrations"
+              << std::setw(14) << "Stall ticks" << std::setw(12) << "Ins/tick" << std::setw(12) << "M ins/s" << std::setw(10) << "Seconds" << "\n";
+
+    const int saved_affinity = CACHE_AFFINITY;
+    for (int affinity : {0, 1}) {
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            CACHE_AFFINITY = affinity;
+            g_core_caches.configure(cache, CPU_COUNT);
+        }
+        LiveRun run = run_live_jobs(ReadyPolicy::FIFO, jobs, TIMEOUT);
+        uint64_t hits = g_core_caches.hits(), misses = g_core_caches.misses(), stalls = g_core_caches.stall_ticks();
+        double instructions = static_cast<double>(run.active_ticks) - static_cast<double>(stalls);
+        std::cout << std::left << std::setw(10) << (affinity ? "on" : "off") << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << (hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0) << "%"
+                  << std::setw(14) << g_core_caches.migrations() << std::setw(14) << stalls << std::setprecision(3)
+                  << std::setw(12) << (run.active_ticks > 0 ? instructions / run.active_ticks : 0.0)
+                  << std::setw(12) << instructions / run.seconds / 1e6 << std::setprecision(2) << std::setw(10) << run.seconds
+                  << timed_out_note(run) << std::endl;
+    }
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        CACHE_AFFINITY = saved_affinity;
+        g_core_caches.configure(core_cache_config_from_globals(), CPU_COUNT);
+    }
+    std::cout << "Ins/tick is instructions per CPU tick spent on the cores, cache stalls included.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// Processes that sweep a few pages of their own over and over, four per core, under round robin
+// with cache-affinity dispatch so each keeps to one node, once per NUMA placement policy: every
+// fault from the lowest free frame, from the faulting core's node, interleaved over the nodes, and
+// the lowest free frame again with hot pages migrated to their process's node. Uses numa-nodes, or
+// two nodes when config.txt has one. The core caches are off so stall ticks are all remote accesses.
+void bench_numa() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe numa benchmark needs an RR-family scheduler (e.g. \"rr\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe numa benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    NumaTopology topology = numa_topology_from_globals(CPU_COUNT, FRAME_COUNT);
+    if (!topology.enabled()) topology.build(2, "", "", CPU_COUNT, FRAME_COUNT);
+    const int PROCESSES = 4 * std::max(1, CPU_COUNT.load());
+    const int PAGES = std::clamp(FRAME_COUNT / PROCESSES / 2, 1, 4); // Half of memory at most, so nothing pages out
+    const int STRIDE = 32;
+    const int SWEEPS = 2000;
+    const auto TIMEOUT = std::chrono::seconds(120);
+    const size_t memory_size = static_cast<size_t>(PAGES) * MEM_PER_FRAME;
+    std::string body;
+    for (int address = SYMBOL_TABLE_BYTES; address + 1 < static_cast<int>(memory_size); address += STRIDE) {
+        if (!body.empty()) body += "; ";
+        body += "READ x " + std::to_string(address);
+    }
+    auto program = build_program({"FOR([" + body + "], " + std::to_string(SWEEPS) + ")"}, false);
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESSES; ++i) jobs.push_back({"bench-numa-" + std::to_string(i), program, std::chrono::microseconds(0), memory_size});
+
+    std::cout << "\n" << PROCESSES << " processes x " << PAGES << " pages on " << CPU_COUNT << " cores in " << topology.nodes()
+              << " nodes; " << NUMA_REMOTE_PENALTY << " ticks per remote access\n";
+    if (static_cast<size_t>(FRAME_COUNT) < static_cast<size_t>(PAGES) * PROCESSES) {
+        std::cout << "Note: the processes need " << PAGES * PROCESSES << " frames and only " << FRAME_COUNT
+                  << " are configured, so paging blurs the comparison.\n";
+    }
+    std::cout << std::left << std::setw(22) << "Placement" << std::right << std::setw(10) << "Local" << std::setw(12) << "Migrated"
+              << std::setw(14) << "Stall ticks" << std::setw(12) << "Ins/tick" << std::setw(12) << "M ins/s" << std::setw(10) << "Seconds" << "\n";
+
+    const NumaTopology saved_topology = memory_manager->numa_topology();
+    const NumaPlacement saved_placement = memory_manager->numa_placement();
+    const bool saved_migrate = memory_manager->numa_migrates();
+    const int saved_affinity = CACHE_AFFINITY;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        CACHE_AFFINITY = 1;
+        g_core_caches.configure(CoreCacheConfig(), CPU_COUNT);
+    }
+    struct Setting {
+        NumaPlacement placement;
+        bool migrate;
+    };
+    for (const Setting& setting : {Setting{NumaPlacement::FIRST_FREE, false}, Setting{NumaPlacement::INTERLEAVE, false},
+                                   Setting{NumaPlacement::LOCAL, false}, Setting{NumaPlacement::FIRST_FREE, true}}) {
+        memory_manager->configure_numa(topology, setting.placement, setting.migrate);
+        long local_before = memory_manager->numa_local_accesses, remote_before = memory_manager->numa_remote_accesses;
+        long migrated_before = memory_manager->numa_pages_migrated;
+        LiveRun run = run_live_jobs(ReadyPolicy::FIFO, jobs, TIMEOUT);
+        long local = memory_manager->numa_local_accesses - local_before, remote = memory_manager->numa_remote_accesses - remote_before;
+        double stalls = static_cast<double>(remote) * NUMA_REMOTE_PENALTY;
+        double instructions = static_cast<double>(run.active_ticks) - stalls;
+        std::string label = std::string(numa_placement_name(setting.placement)) + (setting.migrate ? " + migration" : "");
+        std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << (local + remote > 0 ? 100.0 * local / (local + remote) : 0.0) << "%"
+                  << std::setw(12) << memory_manager->numa_pages_migrated - migrated_before << std::setprecision(0) << std::setw(14) << stalls
+                  << std::setprecision(3) << std::setw(12) << (run.active_ticks > 0 ? instructions / run.active_ticks : 0.0)
+                  << std::setw(12) << instructions / run.seconds / 1e6 << std::setprecision(2) << std::setw(10) << run.seconds
+                  << timed_out_note(run) << std::endl;
+    }
+    memory_manager->configure_numa(saved_topology, saved_placement, saved_migrate);
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        CACHE_AFFINITY = saved_affinity;
+        g_core_caches.configure(core_cache_config_from_globals(), CPU_COUNT);
+    }
+    std::cout << "Local is the share of memory accesses that stayed on the core's node.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// The same CPU-bound batch on 1, 2, 4, ... 128 cores, switched between runs with cpu-set, then once
+// more while cores are retired under it, halving every RETIRE_GAP down to one, to check that the
+// processes of retired cores go back to the ready queue and still finish.
+void bench_scaling() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe scaling benchmark needs an RR-family scheduler (e.g. \"rr\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe scaling benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int PROCESSES = CoreCaches::MAX_CORES; // One per core at the largest count
+    const auto RETIRE_GAP = std::chrono::milliseconds(20);
+    const auto TIMEOUT = std::chrono::seconds(120);
+    // Unoptimized, so every process really takes its ~5k ticks.
+    auto program = build_program({"FOR([FOR([ADD x x 1], 50)], 100)"}, false);
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESSES; ++i) jobs.push_back({"bench-scaling-" + std::to_string(i), program, std::chrono::microseconds(0)});
+
+    const int saved_cores = CPU_COUNT;
+    std::cout << "\n" << PROCESSES << " processes x ~5k ticks at each core count, quantum " << qCycles << "; the host has "
+              << std::thread::hardware_concurrency() << " hardware threads\n";
+    std::cout << std::left << std::setw(8) << "Cores" << std::right << std::setw(12) << "M ticks/s" << std::setw(10) << "Speedup"
+              << std::setw(12) << "Efficiency" << std::setw(10) << "Seconds" << "\n";
+    double one_core_rate = 0;
+    int largest = 1;
+    for (int cores = 1; cores <= CoreCaches::MAX_CORES; cores *= 2) {
+        rr_set_core_count(cores);
+        LiveRun run = run_live_jobs(ReadyPolicy::FIFO, jobs, TIMEOUT);
+        double rate = run.seconds > 0 ? run.active_ticks / run.seconds : 0.0;
+        if (cores == 1) one_core_rate = rate;
+        double speedup = one_core_rate > 0 ? rate / one_core_rate : 0.0;
+        std::cout << std::left << std::setw(8) << cores << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << rate / 1e6 << std::setw(9) << speedup << "x" << std::setprecision(1)
+                  << std::setw(11) << 100.0 * speedup / cores << "%" << std::setprecision(2) << std::setw(10) << run.seconds
+                  << timed_out_note(run) << std::endl;
+        largest = cores;
+    }
+
+    rr_set_core_count(largest);
+    std::thread retire([&] {
+        for (int cores = largest / 2; cores >= 1; cores /= 2) {
+            std::this_thread::sleep_for(RETIRE_GAP);
+            rr_set_core_count(cores);
+        }
+    });
+    LiveRun run = run_live_jobs(ReadyPolicy::FIFO, jobs, TIMEOUT);
+    retire.join();
+    std::cout << "Retiring " << largest << " -> 1 cores during a run: " << run.finished.size() << "/" << PROCESSES
+              << " processes finished in " << std::fixed << std::setprecision(2) << run.seconds << " s"
+              << (run.timed_out ? " (timed out)" : "") << "\n";
+
+    rr_set_core_count(saved_cores);
+    std::cout << "Speedup is against one core; past the host's hardware threads the cores share them.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// CPU time the whole program has used, user and kernel, and how often its threads were switched
+// out where the OS counts that (-1 elsewhere).
+struct HostUsage {
+    double cpu_seconds = 0;
+    long context_switches = -1;
+};
+
+HostUsage host_usage() {
+    HostUsage usage;
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        auto seconds = [](const FILETIME& time) {
+            return static_cast<double>((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e7;
+        };
+        usage.cpu_seconds = seconds(kernel) + seconds(user);
+    }
+#else
+    rusage self;
+    if (getrusage(RUSAGE_SELF, &self) == 0) {
+        usage.cpu_seconds = self.ru_utime.tv_sec + self.ru_stime.tv_sec + (self.ru_utime.tv_usec + self.ru_stime.tv_usec) / 1e6;
+        usage.context_switches = self.ru_nvcsw + self.ru_nivcsw;
+    }
+#endif
+    return usage;
+}
+
+// One CPU-bound batch on 128 virtual cores with a host thread per core, with the host pool
+// (host-threads, or the hardware concurrency), and with the pool resuming process coroutines, with
+// the host CPU time each takes.
+void bench_threads() {
+    if (!rr_runs_scheduler(scheduler)) {
+        std::cout << "\nThe threads benchmark needs an RR-family scheduler (e.g. \"rr\") in config.txt.\n" << std::endl;
+        return;
+    }
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe threads benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int CORES = CoreCaches::MAX_CORES;
+    const int PROCESSES = 2 * CORES;
+    const auto TIMEOUT = std::chrono::seconds(120);
+    const int hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const int pool_size = HOST_THREADS > 0 ? HOST_THREADS : hardware_threads;
+    // Unoptimized, so every process really takes its ~5k ticks.
+    auto program = build_program({"FOR([FOR([ADD x x 1], 50)], 100)"}, false);
+    std::vector<LiveJob> jobs;
+    for (int i = 0; i < PROCESSES; ++i) jobs.push_back({"bench-threads-" + std::to_string(i), program, std::chrono::microseconds(0)});
+
+    const int saved_cores = rr_set_core_count(CORES);
+    std::cout << "\n" << PROCESSES << " processes x ~5k ticks on " << CORES << " virtual cores, quantum " << qCycles
+              << "; the host has " << hardware_threads << " hardware threads\n";
+    std::cout << std::left << std::setw(12) << "Design" << std::right << std::setw(14) << "Host threads" << std::setw(12) << "M ticks/s"
+              << std::setw(12) << "Host CPU" << std::setw(16) << "CPU ms/M ticks" << std::setw(12) << "Switches" << std::setw(10) << "Seconds" << "\n";
+    for (const char* mode : {"per-core", "pool", "coroutine"}) {
+        const bool pooled = std::string(mode) != "per-core";
+        rr_set_core_threads(mode, HOST_THREADS);
+        HostUsage before = host_usage();
+        LiveRun run = run_live_jobs(ReadyPolicy::FIFO, jobs, TIMEOUT);
+        HostUsage after = host_usage();
+        double cpu_seconds = after.cpu_seconds - before.cpu_seconds;
+        double ticks = static_cast<double>(run.active_ticks);
+        std::cout << std::left << std::setw(12) << mode << std::right << std::setw(14) << (pooled ? pool_size : CORES)
+                  << std::fixed << std::setprecision(2) << std::setw(12) << (run.seconds > 0 ? ticks / run.seconds / 1e6 : 0.0)
+                  << std::setprecision(1) << std::setw(11) << (run.seconds > 0 ? 100.0 * cpu_seconds / run.seconds / hardware_threads : 0.0) << "%"
+                  << std::setw(16) << (ticks > 0 ? 1e3 * cpu_seconds / (ticks / 1e6) : 0.0) << std::setw(12);
+        if (after.context_switches >= 0) std::cout << after.context_switches - before.context_switches;
+        else std::cout << "n/a";
+        std::cout << std::setprecision(2) << std::setw(10) << run.seconds << timed_out_note(run) << std::endl;
+    }
+    rr_set_core_threads(CORE_THREADS, HOST_THREADS);
+    rr_set_core_count(saved_cores);
+    std::cout << "Host CPU is the share of all hardware threads the run kept busy; switches counts the host\n"
+              << "threads' context switches.\n" << std::endl;
+    restore_configured_policy();
+}
+
+// --- Process Coroutines ---
+
+// The smallest coroutine there is, suspending at every co_await: the raw cost of a suspend/resume pair.
+struct YieldLoop {
+    struct promise_type {
+        YieldLoop get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+};
+
+YieldLoop yield_forever(uint64_t& count) {
+    for (;;) {
+        ++count;
+        co_await std::suspend_always{};
+    }
+}
+
+// PCBs in a private table for the coroutine executor, outside g_process_table and the schedulers.
+ProcessIndex add_coroutine_process(ProcessTable& table, int id, const std::shared_ptr<const ProgramImage>& program) {
+    ProcessIndex index = table.create(id);
+    Process& process = table[index];
+    process.table_index = NO_PROCESS;
+    process.mem_data.memory_size_bytes = 0;
+    load_program(process, program);
+    return index;
+}
+
+// Processes as coroutines on a handful of host threads. A million processes that sleep between
+// short bursts are all live at once; processes that touch fresh pages suspend on each fault while
+// the pager brings the page in; and the cost of a suspend/resume pair, bare and as a dispatch
+// through the executor's run queue.
+void bench_coroutines() {
+    if (!rr_scheduler_idle()) {
+        std::cout << "\nThe coroutines benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int LIVE = 1000000;
+    const int FAULT_PAGES = 4;      // Pages each faulting process touches
+    const int PAIRS = 10000000;     // Bare suspend/resume pairs
+    const int DISPATCH_PROCESSES = 1000;
+    const int host_threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 2, 8);
+    const int pid_base = 1 << 30; // Frame owners must not collide with scheduler PIDs
+
+    std::cout << "\n" << host_threads << " host threads and a pager thread\n";
+    {
+        auto table = std::make_unique<ProcessTable>();
+        auto program = build_program({"FOR([SLEEP 2], 4)"}, false);
+        CoroutineExecutor executor(*table, host_threads, std::max(1, qCycles));
+        auto start = bench_clock::now();
+        for (int i = 0; i < LIVE; ++i) executor.spawn(add_coroutine_process(*table, pid_base + i, program));
+        double spawn_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        size_t frame_bytes = ProcessTask::live_frame_bytes();
+        start = bench_clock::now();
+        executor.run();
+        double run_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        std::cout << std::fixed << std::setprecision(1) << executor.peak_live() << " live processes: "
+                  << static_cast<double>(frame_bytes) / LIVE << " bytes/coroutine frame + " << ProcessTable::bytes_per_process()
+                  << " bytes/PCB, " << spawn_seconds * 1e9 / LIVE << " ns/spawn\n"
+                  << "  " << executor.resumes() << " resumes (" << executor.sleeps() << " sleeps) in " << std::setprecision(2)
+                  << run_seconds << " s: " << executor.resumes() / run_seconds / 1e6 << " M resumes/s, "
+                  << executor.finished() << " finished\n";
+    }
+    {
+        const size_t memory_size = static_cast<size_t>(FAULT_PAGES) * MEM_PER_FRAME;
+        // Half the frames, so every page fits and none has to be evicted.
+        const int processes = std::clamp(FRAME_COUNT / FAULT_PAGES / 2, 1, 256);
+        std::vector<std::string> commands = {"DECLARE x 0"};
+        for (int page = 1; page < FAULT_PAGES; ++page) commands.push_back("WRITE " + std::to_string(page * MEM_PER_FRAME) + " 1");
+        commands.push_back("FOR([ADD x x 1], 100)");
+        auto program = build_program(commands, false);
+        auto table = std::make_unique<ProcessTable>();
+        CoroutineExecutor executor(*table, host_threads, std::max(1, qCycles));
+        std::vector<ProcessIndex> indices;
+        for (int i = 0; i < processes; ++i) {
+            indices.push_back(add_coroutine_process(*table, pid_base + LIVE + i, program));
+            memory_manager->allocate_for_process((*table)[indices.back()], memory_size);
+            executor.spawn(indices.back());
+        }
+        auto start = bench_clock::now();
+        executor.run();
+        double run_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        for (ProcessIndex index : indices) memory_manager->deallocate_for_process((*table)[index]);
+        std::cout << std::fixed << std::setprecision(2) << processes << " processes x " << FAULT_PAGES << " pages: "
+                  << executor.page_faults() << " faults suspended and paged in off the host threads, "
+                  << executor.finished() << " finished, " << executor.terminated() << " terminated in " << run_seconds << " s; "
+                  << "page-in p50 " << memory_manager->fault_latency.percentile_ns(0.50) << " ns\n";
+    }
+    {
+        uint64_t count = 0;
+        std::vector<YieldLoop> loops;
+        for (int i = 0; i < 1000; ++i) loops.push_back(yield_forever(count));
+        auto start = bench_clock::now();
+        for (int i = 0; i < PAIRS; ++i) loops[static_cast<size_t>(i) % loops.size()].handle.resume();
+        double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+        for (auto& loop : loops) loop.handle.destroy();
+        std::cout << "Bare suspend/resume pair: " << std::setprecision(1) << seconds * 1e9 / PAIRS << " ns (" << count << " resumes)\n";
+    }
+    {
+        // One host thread, the same work at a one-tick quantum and at a quantum that never expires;
+        // the extra time per extra resume is the cost of a dispatch through the run queue.
+        auto program = build_program({"FOR([SLEEP 0], 1000)"}, false);
+        auto run_with_quantum = [&](int quantum, uint64_t& resumes) {
+            auto table = std::make_unique<ProcessTable>();
+            CoroutineExecutor executor(*table, 1, quantum);
+            for (int i = 0; i < DISPATCH_PROCESSES; ++i) executor.spawn(add_coroutine_process(*table, pid_base + i, program));
+            auto start = bench_clock::now();
+            executor.run();
+            resumes = executor.resumes();
+            return std::chrono::duration<double>(bench_clock::now() - start).count();
+        };
+        uint64_t short_resumes = 0, long_resumes = 0;
+        double short_seconds = run_with_quantum(1, short_resumes);
+        double long_seconds = run_with_quantum(INT_MAX, long_resumes);
+        std::cout << "Dispatch through the run queue (suspend, requeue, resume): " << std::setprecision(1)
+                  << (short_seconds - long_seconds) * 1e9 / static_cast<double>(short_resumes - long_resumes) << " ns ("
+                  << short_resumes << " vs " << long_resumes << " resumes)\n" << std::endl;
+    }
+}
+
+// Save and restore of 100k finished processes, each with a few lines of output, on a few shared
+// programs. Runs on the live system, so memory must not change between the two; the restored copies
+// and the originals are released again afterwards.
+void bench_checkpoint() {
+    if (!schedulers_idle()) {
+        std::cout << "\nThe checkpoint benchmark needs an idle scheduler; run it before scheduler-start.\n" << std::endl;
+        return;
+    }
+    const int PROCESSES = 100000;
+    const int PROGRAMS = 8;
+    const int OUTPUT_LINES = 4;
+    const std::string path = "csopesy-bench-checkpoint.bin";
+    std::vector<std::shared_ptr<const ProgramImage>> programs;
+    for (int i = 0; i < PROGRAMS; ++i) {
+        programs.push_back(build_program({"DECLARE x " + std::to_string(i), "FOR([ADD x x 1], 10)", "PRINT(\"x is \" + x)"}, false));
+    }
+
+    size_t start_finished;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        start_finished = rr_g_finished_processes.size();
+        for (int i = 0; i < PROCESSES; ++i) {
+            ProcessIndex index = g_process_table.create(BENCH_PROCESS_ID - i);
+            if (index == NO_PROCESS) break;
+            Process& process = g_process_table[index];
+            process.cold->processName = "bench-checkpoint-" + std::to_string(i);
+            load_program(process, programs[i % PROGRAMS]);
+            process.program_counter = static_cast<int>(process.image->code.size());
+            for (int line = 0; line < OUTPUT_LINES; ++line) process_print_log(process).append("x is " + std::to_string(line), 0, 0);
+            g_process_table.state(index) = ProcessState::FINISHED;
+            rr_g_finished_processes.push_back(index);
+        }
+    }
+
+    std::string error;
+    auto start = bench_clock::now();
+    bool saved = checkpoint_save(path, error);
+    double save_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    double restore_seconds = 0;
+    bool restored = false;
+    if (saved) {
+        start = bench_clock::now();
+        restored = checkpoint_restore(path, error);
+        restore_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    }
+    std::ifstream image(path, std::ios::binary | std::ios::ate);
+    long long image_bytes = image ? static_cast<long long>(image.tellg()) : 0;
+    image.close();
+    std::remove(path.c_str());
+
+    // Both the originals and their restored copies are on the finished list now.
+    size_t created;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        created = rr_g_finished_processes.size() - start_finished;
+        for (size_t i = start_finished; i < rr_g_finished_processes.size(); ++i) g_process_table.release(rr_g_finished_processes[i]);
+        rr_g_finished_processes.resize(start_finished);
+    }
+
+    if (!saved || !restored) {
+        std::cout << "\nCheckpoint " << (saved ? "restore" : "save") << " failed: " << error << "\n" << std::endl;
+        return;
+    }
+    size_t processes = created / 2;
+    std::cout << "\n" << processes << " finished processes on " << PROGRAMS << " programs, " << OUTPUT_LINES
+              << " output lines each; image " << std::fixed << std::setprecision(1) << image_bytes / 1048576.0 << " MiB\n";
+    std::cout << "  Save    : " << std::setprecision(3) << save_seconds << " s (" << std::setprecision(1)
+              << save_seconds * 1e9 / processes << " ns/process)\n";
+    std::cout << "  Restore : " << std::setprecision(3) << restore_seconds << " s (" << std::setprecision(1)
+              << restore_seconds * 1e9 / processes << " ns/process)\n" << std::endl;
+}
+
+// Runs event(process, i) events times on each of threads threads, each with a process of its own,
+// and returns the ns per event one thread saw.
+template <typename Event>
+double events_ns(int threads, int events, Event event) {
+    std::vector<std::unique_ptr<Process>> processes;
+    for (int t = 0; t < threads; ++t) processes.push_back(std::make_unique<Process>(BENCH_PROCESS_ID - t));
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            Process& process = *processes[t];
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int i = 0; i < events; ++i) event(process, i);
+        });
+    }
+    auto start = bench_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) worker.join();
+    return std::chrono::duration<double>(bench_clock::now() - start).count() * 1e9 / events;
+}
+
+// What the paging statistics add to each page fault and eviction, without the paging itself: the
+// process's and the manager's counters and the histogram update as handle_page_fault and
+// evict_page_oldest_process do them, then again with the steady_clock reads around the event, whose
+// cost depends on the host's clock source. The baseline is the one global counter the manager kept
+// before. With several hardware threads, all threads charge the same manager-wide counters and
+// histograms, as cores faulting at once do.
+void bench_faultstats() {
+    const int EVENTS = 2000000;
+    const int threads = std::min(static_cast<int>(std::thread::hardware_concurrency()), 8);
+    std::atomic<int> pages_paged_in{0}, pages_paged_out{0};
+    std::atomic<long> minor_page_faults{0}, major_page_faults{0};
+    LatencyHistogram fault_latency, eviction_latency;
+    auto elapsed_ns = [](bench_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count());
+    };
+
+    auto baseline = [&](Process&, int) { pages_paged_in++; };
+    // Every fourth fault reads the backing store, as a mix of minor and major faults would. Untimed
+    // events record a made-up latency.
+    // The faulting process's counters are bumped without an atomic add, as count_fault does under
+    // the process's page_fault_mutex.
+    auto fault_counters = [&](Process& process, int i, uint64_t ns) {
+        auto bump = [](std::atomic<uint64_t>& counter, uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        };
+        pages_paged_in++;
+        if ((i & 3) == 0) {
+            bump(process.mem_data.major_faults, 1);
+            bump(process.mem_data.bytes_read_from_store, MEM_PER_FRAME);
+            major_page_faults++;
+        } else {
+            bump(process.mem_data.minor_faults, 1);
+            minor_page_faults++;
+        }
+        fault_latency.record(ns);
+    };
+    // Every other victim is dirty and written back.
+    auto eviction_counters = [&](Process& process, int i, uint64_t ns) {
+        if (i & 1) {
+            pages_paged_out++;
+            process.mem_data.bytes_written_to_store.fetch_add(MEM_PER_FRAME, std::memory_order_relaxed);
+        }
+        process.mem_data.pages_evicted.fetch_add(1, std::memory_order_relaxed);
+        eviction_latency.record(ns);
+    };
+    auto untimed = [](auto counters) {
+        return [counters](Process& process, int i) { counters(process, i, 200 + (i & 1023)); };
+    };
+    auto timed = [&](auto counters) {
+        return [counters, elapsed_ns](Process& process, int i) {
+            auto start = bench_clock::now();
+            counters(process, i, elapsed_ns(start));
+        };
+    };
+
+    std::cout << "\nPaging statistics per event, " << EVENTS << " events per thread";
+    if (threads < 2) std::cout << " (one hardware thread, so no shared run)";
+    std::cout << "\n" << std::left << std::setw(26) << "Event" << std::right << std::setw(14) << "ns, 1 thread";
+    if (threads >= 2) std::cout << std::setw(16) << ("ns, " + std::to_string(threads) + " threads");
+    std::cout << "\n";
+    auto print_event = [&](const std::string& label, auto event) {
+        std::cout << std::left << std::setw(26) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << events_ns(1, EVENTS, event);
+        if (threads >= 2) std::cout << std::setw(16) << events_ns(threads, EVENTS, event);
+        std::cout << "\n";
+    };
+    print_event("Baseline counter", baseline);
+    print_event("Fault counters", untimed(fault_counters));
+    print_event("Eviction counters", untimed(eviction_counters));
+    print_event("Fault, timed", timed(fault_counters));
+    print_event("Eviction, timed", timed(eviction_counters));
+    std::cout << "Recorded: " << fault_latency.samples() << " faults (" << major_page_faults << " major), "
+              << eviction_latency.samples() << " evictions\n" << std::endl;
+}
+
+struct BenchmarkEntry {
+    std::string name;
+    std::string description;
+    std::function<void()> run;
+};
+
+const std::vector<BenchmarkEntry>& registry() {
+    static const std::vector<BenchmarkEntry> entries = {
+        {"interpreter", "ns/instruction for each opcode", bench_interpreter},
+        {"programs", "bytes/process and creation rate of generated processes", bench_programs},
+        {"workload", "creation rate and arrival statistics of the workload generator", bench_workload},
+        {"optimizer", "interpreter speedup from optimize_program on generated programs", bench_optimizer},
+        {"quantum", "executed ticks/s of the RR cores at quantum sizes 1 to 10k", bench_quantum},
+        {"sleep", "100k concurrently sleeping processes on the RR timer wheel", bench_sleep},
+        {"lockstep", "instructions/s of 10k processes on shared programs, scalar vs lockstep", bench_lockstep},
+        {"processtable", "bytes, creation and state-scan cost of 1M table PCBs vs the baseline shared_ptr PCBs", bench_processtable},
+        {"mlfq", "response time and throughput of RR vs MLFQ on a mixed CPU-bound/interactive workload", bench_mlfq},
+        {"sjf", "ready-heap cost at 100k processes and turnaround of FCFS, RR, SJF and SRTF", bench_sjf},
+        {"stride", "pick cost at 100k processes and CPU-share deviation of 1k weighted processes under RR, stride and lottery", bench_stride},
+        {"edf", "deadline misses and lateness of an overloaded batch under RR, SJF and EDF with admission control", bench_edf},
+        {"adaptive", "throughput and response of a static quantum sweep vs the adaptive quantum", bench_adaptive},
+        {"affinity", "simulated cache hit rate and throughput with cache-affinity dispatch off and on", bench_affinity},
+        {"numa", "local/remote access ratio and throughput per NUMA placement policy", bench_numa},
+        {"scaling", "throughput of one batch at 1 to 128 cores via cpu-set, and draining retired cores", bench_scaling},
+        {"threads", "host CPU time and ticks/s at 128 virtual cores, a host thread per core vs the host pool", bench_threads},
+        {"coroutines", "1M live processes as coroutines on a few host threads, deferred page faults and suspend/resume cost", bench_coroutines},
+        {"checkpoint", "save and restore time of 100k finished processes", bench_checkpoint},
+        {"faultstats", "ns the paging counters and latency histograms add to each page fault and eviction", bench_faultstats},
+    };
+    return entries;
+}
+
+} // end anonymous namespace
+
+namespace benchmark {
+
+void list() {
+    std::cout << "Available benchmarks:\n";
+    for (const auto& entry : registry()) {
+        std::cout << "  " << std::left << std::setw(14) << entry.name << entry.description << "\n";
+    }
+    std::cout << std::right;
+}
+
+bool run(const std::string& name) {
+    for (const auto& entry : registry()) {
+        if (entry.name == name) {
+            entry.run();
+            return true;
+        }
+    }
+    list();
+    return false;
+}
+
+} // namespace benchmark
@@ -0,0 +1,14 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+// --- Built-in Microbenchmarks ---
+// Run from the CLI with "benchmark <name>"; results go to stdout.
+namespace benchmark {
+    // Runs the named benchmark. Returns false (after listing the available ones) if the name is unknown.
+    bool run(const std::string& name);
+    void list();
+}
+
+#endif // BENCHMARK_H
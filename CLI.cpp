@@ -25,25 +25,34 @@
 #include "RR.h"
 #include "Process.h"
 #include "MemoryManager.h"
+#include "MemorySnapshot.h"
+#include "Checkpoint.h"
+#include "Interpreter.h"
+#include "Benchmark.h"
 
 using namespace std;
 
 std::deque<ProcessCreationRequest> g_creation_queue;
+CoreCaches g_core_caches;
 
 // RR Scheduler Globals
-std::deque<std::shared_ptr<Process>> rr_g_ready_queue;
-std::vector<std::shared_ptr<Process>> rr_g_running_processes(128, nullptr);
-std::vector<std::shared_ptr<Process>> rr_g_finished_processes;
-std::deque<std::shared_ptr<Process>> rr_g_blocked_queue;
+ReadyQueue rr_g_ready_queue;
+QuantumTuner rr_g_quantum_tuner;
+std::vector<ProcessIndex> rr_g_running_processes(128, NO_PROCESS);
+std::vector<ProcessIndex> rr_g_finished_processes;
+std::deque<ProcessIndex> rr_g_blocked_queue;
+std::deque<ProcessIndex> rr_g_fault_queue;
+TimerWheel rr_g_sleep_wheel;
 std::mutex rr_g_process_mutex;
 std::condition_variable rr_g_scheduler_cv;
 std::atomic<bool> rr_g_is_running(true);
 
 // FCFS Scheduler Globals
-std::deque<std::shared_ptr<Process>> fcfs_g_ready_queue;
-std::vector<std::shared_ptr<Process>> fcfs_g_running_processes(128, nullptr);
-std::vector<std::shared_ptr<Process>> fcfs_g_finished_processes;
-std::deque<std::shared_ptr<Process>> fcfs_g_blocked_queue;
+std::deque<ProcessIndex> fcfs_g_ready_queue;
+std::vector<ProcessIndex> fcfs_g_running_processes(128, NO_PROCESS);
+std::vector<ProcessIndex> fcfs_g_finished_processes;
+std::deque<ProcessIndex> fcfs_g_blocked_queue;
+TimerWheel fcfs_g_sleep_wheel;
 std::mutex fcfs_g_process_mutex;
 std::condition_variable fcfs_g_scheduler_cv;
 std::atomic<bool> fcfs_g_is_running(true);
@@ -51,9 +60,11 @@ std::atomic<bool> fcfs_g_is_running(true);
 bool initFlag = false;
 
 bool process_maker_running = false;
+// scheduler-start's generator threads; main() joins them on exit.
+std::vector<std::thread> process_generators;
 
 //config parameters
-int CPU_COUNT = 128; // cpus available [1, 128]
+std::atomic<int> CPU_COUNT{128}; // cpus available [1, 128]
 string scheduler = ""; // fcfs or rr
 int qCycles = 100000; // quantum [1, 2^32]
 int processFrequency = 100000; // every x cycles, generate a new process for scheduler-start [1, 2^32]
@@ -65,6 +76,49 @@ int MAX_OVERALL_MEM = 0;
 int MEM_PER_FRAME = 0;
 int MIN_MEM_PER_PROC = 0;
 int MAX_MEM_PER_PROC = 0;
+int HUGE_PAGE_FRAMES = 0; // frames per huge page, 0 or 1 disables huge pages
+
+// workload generator for scheduler-start
+string ARRIVAL_MODEL = "fixed"; // fixed, poisson or bursty
+int BURST_SIZE = 8; // processes per burst for the bursty arrival model
+unsigned long long WORKLOAD_SEED = 0; // 0 seeds from std::random_device
+string INSTRUCTION_MIX = ""; // e.g. "print=1 add=4 for=1"; empty weighs every kind equally
+
+// MLFQ policy of the RR scheduler (scheduler "mlfq")
+int MLFQ_LEVELS = 3; // [1, 64]
+string MLFQ_QUANTA = ""; // ticks per dispatch from the top level down, e.g. "4 8 16"; unlisted levels double the one above
+int MLFQ_BOOST_TICKS = 10000; // CPU ticks between priority boosts, 0 disables
+
+// Stride and lottery policies of the RR scheduler (scheduler "stride" / "lottery")
+int DEFAULT_WEIGHT = 100; // weight of processes whose screen -s names none, [1, 10000]
+
+// Adaptive quantum of the RR scheduler; quantum-cycles is then only the starting point
+int ADAPTIVE_QUANTUM = 0; // 1 re-tunes the quantum from switch overhead, ready-queue length and target response
+int QUANTUM_MIN = 1;
+int QUANTUM_MAX = 1000;
+int TARGET_RESPONSE_TICKS = 200; // CPU clock ticks a ready process should wait for a core
+int TARGET_SWITCH_OVERHEAD = 10; // largest percentage of core time to spend switching processes
+
+// Simulated per-core caches and cache-affinity dispatch
+int CORE_CACHE = 0; // 1 charges every memory access to the running core's cache
+int CACHE_SETS = 64; // power of two
+int CACHE_WAYS = 4;
+int CACHE_LINE_BYTES = 16; // power of two
+int CACHE_MISS_PENALTY = 10; // extra ticks per miss
+int CACHE_AFFINITY = 0; // 1 makes the RR scheduler prefer the core a process last ran on
+int MIGRATION_COST = 500; // CPU ticks after leaving a core during which a process counts as cache-hot there
+
+// Simulated NUMA nodes, each owning a range of cores and a range of frames
+int NUMA_NODES = 1; // 1 makes every access local
+string NUMA_NODE_CORES = ""; // cores per node, e.g. "2 2"; unlisted nodes split the rest evenly
+string NUMA_NODE_FRAMES = ""; // frames per node, likewise
+string NUMA_PLACEMENT = "local"; // first-free, local or interleave
+int NUMA_REMOTE_PENALTY = 20; // extra ticks per access to another node's frame
+int NUMA_MIGRATE = 0; // 1 moves hot pages to the node of their process's core every working-set sample
+
+// Host threads behind the RR scheduler's virtual cores
+string CORE_THREADS = "pool"; // pool: host-threads threads step the cores in turns; per-core: one thread per core; coroutine: a pool that resumes process coroutines, with page faults taken by a pager thread
+int HOST_THREADS = 0; // pool size, 0 for the host's hardware concurrency
 
 int FRAME_COUNT = 0;
 
@@ -77,6 +131,7 @@ std::atomic<bool> g_system_initialized = false;
 std::mutex g_cout_mutex;
 // --- MODIFIED: Changed to a global pointer to be initialized later ---
 MemoryManager* memory_manager = nullptr;
+ProcessTable g_process_table;
 // Color definitions 
 const int LIGHT_GREEN = 10;     // Light green text 
 const int LIGHT_YELLOW = 14;    // Light yellow text 
@@ -332,6 +387,8 @@ bool readConfig(){
                 scheduler = value;
             } else if (key == "quantum-cycles") {
                 qCycles = std::stoi(value);
+            } else if (key == "batch-process-freq") {
+                processFrequency = std::stoi(value);
             } else if (key == "min-ins") {
                 MIN_INS = std::stoi(value);
             } else if (key == "max-ins") {
@@ -346,11 +403,74 @@ bool readConfig(){
                 MIN_MEM_PER_PROC = std::stoi(value);
             } else if (key == "max-mem-per-proc") {
                 MAX_MEM_PER_PROC = std::stoi(value);
+            } else if (key == "huge-page-frames") {
+                HUGE_PAGE_FRAMES = std::stoi(value);
+            } else if (key == "arrival-model") {
+                ARRIVAL_MODEL = value;
+            } else if (key == "burst-size") {
+                BURST_SIZE = std::stoi(value);
+            } else if (key == "workload-seed") {
+                WORKLOAD_SEED = std::stoull(value);
+            } else if (key == "instruction-mix") {
+                INSTRUCTION_MIX = value;
+            } else if (key == "mlfq-levels") {
+                MLFQ_LEVELS = std::stoi(value);
+            } else if (key == "mlfq-quanta") {
+                MLFQ_QUANTA = value;
+            } else if (key == "mlfq-boost-ticks") {
+                MLFQ_BOOST_TICKS = std::stoi(value);
+            } else if (key == "default-weight") {
+                DEFAULT_WEIGHT = std::stoi(value);
+            } else if (key == "adaptive-quantum") {
+                ADAPTIVE_QUANTUM = std::stoi(value);
+            } else if (key == "quantum-min") {
+                QUANTUM_MIN = std::stoi(value);
+            } else if (key == "quantum-max") {
+                QUANTUM_MAX = std::stoi(value);
+            } else if (key == "target-response") {
+                TARGET_RESPONSE_TICKS = std::stoi(value);
+            } else if (key == "target-switch-overhead") {
+                TARGET_SWITCH_OVERHEAD = std::stoi(value);
+            } else if (key == "core-cache") {
+                CORE_CACHE = std::stoi(value);
+            } else if (key == "cache-sets") {
+                CACHE_SETS = std::stoi(value);
+            } else if (key == "cache-ways") {
+                CACHE_WAYS = std::stoi(value);
+            } else if (key == "cache-line") {
+                CACHE_LINE_BYTES = std::stoi(value);
+            } else if (key == "cache-miss-penalty") {
+                CACHE_MISS_PENALTY = std::stoi(value);
+            } else if (key == "cache-affinity") {
+                CACHE_AFFINITY = std::stoi(value);
+            } else if (key == "migration-cost") {
+                MIGRATION_COST = std::stoi(value);
+            } else if (key == "numa-nodes") {
+                NUMA_NODES = std::stoi(value);
+            } else if (key == "numa-node-cores") {
+                NUMA_NODE_CORES = value;
+            } else if (key == "numa-node-frames") {
+                NUMA_NODE_FRAMES = value;
+            } else if (key == "numa-placement") {
+                NUMA_PLACEMENT = value;
+            } else if (key == "numa-remote-penalty") {
+                NUMA_REMOTE_PENALTY = std::stoi(value);
+            } else if (key == "numa-migrate") {
+                NUMA_MIGRATE = std::stoi(value);
+            } else if (key == "core-threads") {
+                CORE_THREADS = value;
+            } else if (key == "host-threads") {
+                HOST_THREADS = std::stoi(value);
             }
         }
     }
     configFile.close();
     FRAME_COUNT = MAX_OVERALL_MEM / MEM_PER_FRAME;
+    DEFAULT_WEIGHT = std::clamp(DEFAULT_WEIGHT, 1, ReadyQueue::MAX_WEIGHT);
+    // Huge pages must be a power-of-two run of frames that fits in memory.
+    if (HUGE_PAGE_FRAMES < 2 || (HUGE_PAGE_FRAMES & (HUGE_PAGE_FRAMES - 1)) != 0 || HUGE_PAGE_FRAMES > FRAME_COUNT) {
+        HUGE_PAGE_FRAMES = 0;
+    }
     initFlag = true;
     return true;
 }
@@ -386,6 +506,41 @@ bool vmStat(){
     // Read the page counters directly from the MemoryManager's atomic variables.
     std::cout << "Num paged in     : " << memory_manager->pages_paged_in << "\n";
     std::cout << "Num paged out    : " << memory_manager->pages_paged_out << "\n";
+
+    // Translation statistics per page size.
+    auto hit_rate = [](long hits, long misses) {
+        long total = hits + misses;
+        return total > 0 ? static_cast<int>(100.0 * hits / total) : 0;
+    };
+    long base_hits = memory_manager->tlb_base_hits, base_misses = memory_manager->tlb_base_misses;
+    long huge_hits = memory_manager->tlb_huge_hits, huge_misses = memory_manager->tlb_huge_misses;
+    std::cout << "Huge page size   : " << (HUGE_PAGE_FRAMES ? std::to_string(HUGE_PAGE_FRAMES * MEM_PER_FRAME) + " bytes" : "disabled") << "\n";
+    std::cout << "Base page faults : " << memory_manager->base_page_faults << "\n";
+    std::cout << "Huge page faults : " << memory_manager->huge_page_faults << "\n";
+    std::cout << "Huge pages split : " << memory_manager->huge_pages_split << "\n";
+    std::cout << "TLB hit (base)   : " << hit_rate(base_hits, base_misses) << "% (" << base_hits << "/" << base_hits + base_misses << ")\n";
+    std::cout << "TLB hit (huge)   : " << hit_rate(huge_hits, huge_misses) << "% (" << huge_hits << "/" << huge_hits + huge_misses << ")\n";
+    if (g_core_caches.enabled()) {
+        long cache_hits = static_cast<long>(g_core_caches.hits()), cache_misses = static_cast<long>(g_core_caches.misses());
+        std::cout << "Core cache hit   : " << hit_rate(cache_hits, cache_misses) << "% (" << cache_hits << "/" << cache_hits + cache_misses << ")\n";
+        std::cout << "Cache stall ticks: " << g_core_caches.stall_ticks() << "\n";
+        std::cout << "Core migrations  : " << g_core_caches.migrations() << "\n";
+    }
+    const NumaTopology& numa = memory_manager->numa_topology();
+    if (numa.enabled()) {
+        long local = memory_manager->numa_local_accesses, remote = memory_manager->numa_remote_accesses;
+        std::cout << "NUMA nodes       : " << numa.nodes() << " (" << numa_placement_name(memory_manager->numa_placement())
+                  << " placement, migration " << (memory_manager->numa_migrates() ? "on" : "off") << ")\n";
+        std::cout << "NUMA local access: " << hit_rate(local, remote) << "% (" << local << "/" << local + remote << ")\n";
+        std::cout << "Pages migrated   : " << memory_manager->numa_pages_migrated << "\n";
+    }
+
+    // Fault classes and latency distributions.
+    std::cout << "Minor faults     : " << memory_manager->minor_page_faults << "\n";
+    std::cout << "Major faults     : " << memory_manager->major_page_faults << "\n";
+    memory_manager->fault_latency.print(std::cout, "Page fault latency");
+    memory_manager->eviction_latency.print(std::cout, "Eviction latency  ");
+    std::cout << "Memory snapshots : " << snapshot_captured_count() << " (" << snapshot_dropped_count() << " dropped)\n";
     return true;
 }
 
@@ -402,7 +557,7 @@ string processCommand(const string& cmd) {
     
     vector<string> validCommands = {
         "initialize", "screen", "scheduler-start", "marquee",
-        "scheduler-stop", "report-util", "vmstat", "process-smi", "clear", "exit"
+        "scheduler-stop", "report-util", "vmstat", "process-smi", "heatmap", "clear", "exit"
     };
 
     //handles empty inputs
@@ -422,6 +577,7 @@ string processCommand(const string& cmd) {
             // --- CRITICAL FIX: Create the MemoryManager HERE ---
             if (memory_manager == nullptr) {
                 memory_manager = new MemoryManager(rr_g_ready_queue, rr_g_running_processes, fcfs_g_ready_queue, fcfs_g_running_processes);
+                snapshot_stream_start();
             }
             
             // Set the flag to true, main() will now launch the threads.
@@ -431,27 +587,46 @@ string processCommand(const string& cmd) {
             return "Initialization finished. Running '" + scheduler + "' scheduler.";
         }
 
-        //can use the exit command
-        if (cmd == "exit") exit(0);
+        //can use the exit command; main() runs the shutdown sequence
+        if (cmd == "exit") return "";
         return "use the 'initialize' command before using other commands";
     }
 
     // Handle screen commands 
     if (tokens[0] == "screen" && initFlag == true) {
         if (tokens.size() >= 4 &&  tokens[1] == "-s") {
+            // screen -s <name> <memory> [weight] [-d <deadline ticks>]
             try {
                 size_t mem_size = stoull(tokens[3]); 
 
                 if (!isValidMemorySize(mem_size)) {
                     return "Invalid memory allocation: must be power of 2 between 64-65536 bytes.";
                 } 
+                auto is_number = [](const string& token, size_t max_digits) {
+                    return !token.empty() && token.size() <= max_digits && std::all_of(token.begin(), token.end(), ::isdigit);
+                };
+                uint32_t weight = 0;
+                uint64_t deadline = 0;
+                size_t next = 4;
+                if (tokens.size() > next && tokens[next] != "-d") {
+                    if (!is_number(tokens[next], 5) || stoi(tokens[next]) < 1 || stoi(tokens[next]) > ReadyQueue::MAX_WEIGHT) {
+                        return "Invalid weight: must be between 1 and " + std::to_string(ReadyQueue::MAX_WEIGHT) + ".";
+                    }
+                    weight = static_cast<uint32_t>(stoi(tokens[next++]));
+                }
+                if (tokens.size() > next) {
+                    if (tokens[next] != "-d" || tokens.size() != next + 2 || !is_number(tokens[next + 1], 12) || stoull(tokens[next + 1]) == 0) {
+                        return "Usage: screen -s <name> <memory> [weight] [-d <deadline ticks>]";
+                    }
+                    deadline = stoull(tokens[next + 1]);
+                }
                 manager->createScreen(tokens[2]); 
 
                 {
                     // Lock the mutex to safely access the shared g_creation_queue
                     std::lock_guard<std::mutex> lock(rr_g_process_mutex);
                     // Add the new process information to the queue
-                    g_creation_queue.push_back({tokens[2], mem_size});
+                    g_creation_queue.push_back({tokens[2], mem_size, nullptr, weight, deadline});
                 }
                 // Notify the sleeping scheduler thread that there is a new request for it to handle
                 rr_g_scheduler_cv.notify_one();
@@ -461,9 +636,13 @@ string processCommand(const string& cmd) {
                 return "Invalid memory size format.";
             }
         } else if (tokens.size() >= 3 && tokens[1] == "-r") { // Added size check for safety
+            // screen -r <name> [lines]
             if (manager->screenExists(tokens[2])) {
-                manager->attachScreen(tokens[2]); 
-                rr_searchTest(tokens[2]);
+                size_t lines = SCREEN_DEFAULT_LINES;
+                if (tokens.size() >= 4 && !tokens[3].empty() && tokens[3].size() <= 9 && std::all_of(tokens[3].begin(), tokens[3].end(), ::isdigit)) {
+                    lines = std::min<size_t>(stoull(tokens[3]), PRINT_LOG_LINES);
+                }
+                manager->attachScreen(tokens[2], lines); 
                 return "";
             } else {
                 return "Screen not found: " + tokens[2]; 
@@ -471,16 +650,21 @@ string processCommand(const string& cmd) {
         } else if (tokens.size() >= 2 && tokens[1] == "-ls") { // Added size check for safety
             if (scheduler == "fcfs") {
                 fcfs_displayTest();
-            } else if (scheduler == "rr") {
+            } else if (rr_runs_scheduler(scheduler)) {
                 rr_displayTest();
             }
             return "";
         }else if (tokens.size() >= 2 && tokens[1] == "-c") { // Added size check for safety
-            //TODO: Ability to add a set of user-defined instructions when creating a process.
+            // screen -c <name> [memory size] "<instructions>"
+            if (tokens.size() < 4) return "usage: screen -c <name> [memory size] \"<instructions>\"";
             string processName = tokens[2];
-            size_t memorySize = tokens.size() == 5
-                ? stoi(tokens[3]) 
-                : 0;
+            size_t memorySize = 0;
+            if (!tokens[3].empty() && std::all_of(tokens[3].begin(), tokens[3].end(), ::isdigit)) {
+                memorySize = stoull(tokens[3]);
+                if (!isValidMemorySize(memorySize)) {
+                    return "Invalid memory allocation: must be power of 2 between 64-65536 bytes.";
+                }
+            }
 
             size_t quote_start = cmd.find('"');
             size_t quote_end = cmd.rfind('"');
@@ -489,31 +673,25 @@ string processCommand(const string& cmd) {
                 return "invalid command: missing instruction quotes";
 
             std::string instructionBlock = cmd.substr(quote_start + 1, quote_end - quote_start - 1);
+            // PRINT strings arrive escaped inside the outer quotes.
+            for (size_t pos = instructionBlock.find("\\\""); pos != std::string::npos; pos = instructionBlock.find("\\\"", pos)) {
+                instructionBlock.erase(pos, 1);
+                pos++;
+            }
 
-            vector<std::string> instructions;
-            std::stringstream ss(instructionBlock);
-            std::string instruction;
-
-            while (std::getline(ss, instruction, ';')) {
-                instruction.erase(0, instruction.find_first_not_of(" \t\r\n")); // trim left
-                instruction.erase(instruction.find_last_not_of(" \t\r\n") + 1); // trim right
-                if (!instruction.empty()) {
-                    instructions.push_back(instruction);
-                }
-            }   
+            vector<std::string> instructions = split_statements(instructionBlock);
 
             if (instructions.size() < 1 || instructions.size() > 50) {
                  return "invalid command: instruction count must be between 1 and 50";
             }
-            
-            //just to check
-            // std::cout << "\nParsed Instructions (" << instructions.size() << "):" << std::endl;
-            // for (size_t i = 0; i < instructions.size(); ++i) {
-            //     std::cout << i + 1 << ": " << instructions[i] << "\n" << std::endl;
-            // }
+
+            ProgramImage program;
+            if (!compile_program(instructions, program)) {
+                return "invalid command: " + program.error;
+            }
 
             //call function depending on scheduler
-            if (scheduler == "rr") {
+            if (rr_runs_scheduler(scheduler)) {
                 rr_create_process_with_commands(processName, memorySize, instructions);
             } else if (scheduler == "fcfs") {
                 fcfs_create_process_with_commands(processName, memorySize, instructions);
@@ -526,6 +704,43 @@ string processCommand(const string& cmd) {
         return "use the 'initialize' command before using other commands";
     }
 
+    // Handle checkpoint [file]
+    if (tokens[0] == "checkpoint") {
+        if (!initFlag) return "use the 'initialize' command before using other commands";
+        string path = tokens.size() >= 2 ? tokens[1] : CHECKPOINT_FILE;
+        string error;
+        auto start = std::chrono::steady_clock::now();
+        if (!checkpoint_save(path, error)) {
+            return "checkpoint failed: " + error;
+        }
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        return "Checkpoint written to " + path + " in " + to_string(elapsed_ms) + " ms";
+    }
+
+    // Handle cpu-set N: adds or retires cores of the running scheduler
+    if (tokens[0] == "cpu-set") {
+        if (!initFlag) return "use the 'initialize' command before using other commands";
+        int cores = 0;
+        try {
+            if (tokens.size() >= 2) cores = std::stoi(tokens[1]);
+        } catch (const std::exception&) {
+            cores = 0;
+        }
+        if (cores < 1 || cores > CoreCaches::MAX_CORES) return "usage: cpu-set <1-" + to_string(CoreCaches::MAX_CORES) + ">";
+        int previous = rr_runs_scheduler(scheduler) ? rr_set_core_count(cores) : fcfs_set_core_count(cores);
+        return "Cores: " + to_string(previous) + " -> " + to_string(cores);
+    }
+
+    // Handle benchmark [name]
+    if (tokens[0] == "benchmark") {
+        if (!initFlag) return "use the 'initialize' command before using other commands";
+        if (tokens.size() < 2) {
+            benchmark::list();
+            return "";
+        }
+        return benchmark::run(tokens[1]) ? "" : "Unknown benchmark: " + tokens[1];
+    }
+
     // Handle quit 
     if (manager->screenActive() && (tokens[0] == "quit" || tokens[0] == "exit")) {
         manager->detachScreen(); 
@@ -555,16 +770,16 @@ string processCommand(const string& cmd) {
                    void fcfs_create_processes(MemoryManager& mm); // Forward declare
                    fcfs_create_processes(*memory_manager);      // Call with dereferenced pointer
                });
-               process_generator_fcfs.detach();
+               process_generators.push_back(std::move(process_generator_fcfs));
                return "running FCFS scheduler process generator";
-           }else if (scheduler == "rr"){
+           }else if (rr_runs_scheduler(scheduler)){
                // Using a lambda for the RR scheduler as well for safety and consistency
                thread process_generator_rr([](){
                    // The code inside this lambda runs in the new thread.
                    void rr_create_processes(MemoryManager& mm); // Forward declare
                    rr_create_processes(*memory_manager);      // Call with dereferenced pointer
                });
-               process_generator_rr.detach();
+               process_generators.push_back(std::move(process_generator_rr));
                return "running RR scheduler process generator";
             }
             return "error: cannot define scheduler";
@@ -593,8 +808,15 @@ string processCommand(const string& cmd) {
             return "";
         }
 
+        if (cmd == "heatmap"){
+            std::cout << '\n'; 
+            process_smi::printHeatmap(); 
+            std::cout << std::endl; 
+            return "";
+        }
+
         if (cmd == "report-util"){
-            if (scheduler == "rr") {
+            if (rr_runs_scheduler(scheduler)) {
                 rr_writeTest();
             } else if (scheduler == "fcfs") {
                 fcfs_writeTest();
@@ -602,7 +824,8 @@ string processCommand(const string& cmd) {
             return "Report written to csopesy-log.txt";
         }
 
-        if (cmd == "exit") exit(0);
+        // main() runs the shutdown sequence, which stops the working-set sampler before exiting.
+        if (cmd == "exit") return "";
     }
     
     return "Unknown command: " + cmd;
@@ -639,23 +862,36 @@ int main() {
         }
         
         // --- Initialization and Scheduler Launching Logic ---
-        if (!initFlag && input == "initialize") {
+        // 'initialize --restore [file]' resumes from a checkpoint before the scheduler starts.
+        vector<string> init_tokens = tokenize(input);
+        bool is_restore = init_tokens.size() >= 2 && init_tokens[0] == "initialize" && init_tokens[1] == "--restore";
+        if (!initFlag && (input == "initialize" || is_restore)) {
             cout << "Initializing..." << endl;
             if (readConfig()) {
                 if (memory_manager == nullptr) {
                     memory_manager = new MemoryManager(rr_g_ready_queue, rr_g_running_processes, fcfs_g_ready_queue, fcfs_g_running_processes);
+                    snapshot_stream_start();
+                }
+                if (is_restore) {
+                    string path = init_tokens.size() >= 3 ? init_tokens[2] : CHECKPOINT_FILE;
+                    string error;
+                    auto start = std::chrono::steady_clock::now();
+                    if (checkpoint_restore(path, error)) {
+                        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+                        cout << "Restored " << path << " in " << elapsed_ms << " ms" << endl;
+                    } else {
+                        cout << "Restore failed: " << error << ". Starting empty." << endl;
+                    }
                 }
                 initFlag = true;
                 cout << "Initialization successful. Scheduler: " << scheduler << endl;
 
-                // Launch the appropriate scheduler thread and detach it.
+                // Launch the appropriate scheduler thread; the shutdown sequence joins it.
                 if (!scheduler_is_launched) {
-                    if (scheduler == "rr") {
+                    if (rr_runs_scheduler(scheduler)) {
                         scheduler_thread = std::thread(RR);
-                        scheduler_thread.detach();
                     } else if (scheduler == "fcfs") {
                         scheduler_thread = std::thread(FCFS);
-                        scheduler_thread.detach();
                     }
                     scheduler_is_launched = true;
                 }
@@ -669,7 +905,8 @@ int main() {
         // --- Process all other commands ---
         string cmd_output = processCommand(input);
         
-        if (input == "exit") {
+        // 'exit' inside a screen only detaches it.
+        if (input == "exit" && cmd_output.empty()) {
             break; // Exit the main input loop to begin shutdown.
         }
 
@@ -700,9 +937,14 @@ int main() {
     rr_g_scheduler_cv.notify_all();
     fcfs_g_scheduler_cv.notify_all();
     
-    // Give detached threads a moment to clean up and exit.
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // Wait for them: the cores finish the quantum or tick in hand, and nothing may still run a
+    // process when the process table and the scheduler lists are destroyed on return.
+    for (auto& generator : process_generators) {
+        generator.join();
+    }
+    if (scheduler_thread.joinable()) scheduler_thread.join();
 
+    snapshot_stream_stop(); // Drain pending memory snapshots to disk.
     delete memory_manager; // Clean up the dynamically allocated memory manager.
     cout << "Program finished." << endl;
     return 0;
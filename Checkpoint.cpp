@@ -0,0 +1,483 @@
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Checkpoint.h"
+#include "global.h"
+#include "config.h"
+#include "Interpreter.h"
+#include "vmstat.h"
+#include "RR.h"
+#include "FCFS.h"
+
+// --- File-local helpers ---
+namespace {
+
+// Which list a process is restored into. Running processes are saved as ready.
+enum class SavedQueue : uint8_t {
+    RR_READY,
+    RR_BLOCKED,
+    RR_FINISHED,
+    FCFS_READY,
+    FCFS_BLOCKED,
+    FCFS_FINISHED
+};
+
+// Keeps both schedulers' cores paused between instructions while it lives, so no process is saved
+// halfway through one.
+class PausedCores {
+public:
+    PausedCores() {
+        rr_pause_cores();
+        fcfs_pause_cores();
+    }
+    ~PausedCores() {
+        fcfs_resume_cores();
+        rr_resume_cores();
+    }
+    PausedCores(const PausedCores&) = delete;
+    PausedCores& operator=(const PausedCores&) = delete;
+};
+
+// Read-only view of the whole image file.
+class MappedFile {
+public:
+    const char* data = nullptr;
+    size_t size = 0;
+
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapping) return;
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data) size = static_cast<size_t>(file_size.QuadPart);
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return;
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) return;
+        madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+        size = static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#else
+    int fd = -1;
+#endif
+};
+
+int64_t to_ticks(const std::chrono::system_clock::time_point& tp) {
+    return static_cast<int64_t>(tp.time_since_epoch().count());
+}
+
+std::chrono::system_clock::time_point from_ticks(int64_t ticks) {
+    return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(ticks));
+}
+
+void save_process(CheckpointWriter& out, ProcessIndex index, SavedQueue queue, uint32_t program_id) {
+    const Process& p = g_process_table[index];
+    const MemoryData& mem = p.mem_data;
+    out.put(static_cast<int32_t>(p.id));
+    out.put(static_cast<uint8_t>(queue));
+    out.put_string(p.cold->processName);
+    out.put(program_id);
+    out.put(static_cast<int32_t>(p.program_counter));
+    out.put(static_cast<int32_t>(g_process_table.core(index)));
+    out.put(static_cast<uint64_t>(p.memory_size));
+    out.put(to_ticks(p.start_time));
+    out.put(to_ticks(p.finish_time));
+    out.put(p.weight);
+    out.put(p.ticks_executed.load());
+    out.put(p.deadline_tick);
+    out.put(p.work_ticks);
+    out.put(static_cast<uint8_t>(p.deadline_rejected));
+
+    // Interpreter state; the program image is re-interned from the program table on restore and
+    // variable values travel with the process memory.
+    out.put(static_cast<uint8_t>(p.loop_depth));
+    for (int i = 0; i < p.loop_depth; ++i) {
+        out.put(static_cast<int32_t>(p.loop_stack[i].body_pc));
+        out.put(p.loop_stack[i].remaining);
+    }
+    // A sleeping process is saved as ready with the sleep it has left and goes back to sleep when dispatched.
+    int32_t sleep_ticks = p.sleep_ticks_remaining;
+    if (g_process_table.state(index) == ProcessState::SLEEPING) {
+        uint64_t now = static_cast<uint64_t>(get_cpu_clock_ticks());
+        sleep_ticks = p.wake_tick > now ? static_cast<int32_t>(p.wake_tick - now) : 0;
+    }
+    out.put(sleep_ticks);
+    std::vector<PrintLog::Line> output = p.cold->output ? p.cold->output->tail(PrintLog::CAPACITY) : std::vector<PrintLog::Line>();
+    out.put(static_cast<uint32_t>(output.size()));
+    for (const auto& line : output) {
+        out.put(line.timestamp_ms);
+        out.put(static_cast<int32_t>(line.core));
+        out.put_string(line.text);
+    }
+
+    out.put(static_cast<uint64_t>(mem.memory_size_bytes));
+    out.put(static_cast<int64_t>(mem.creation_timestamp));
+    out.put(static_cast<int64_t>(mem.backing_store_offset));
+    out.put(static_cast<uint8_t>(mem.terminated_by_error));
+    out.put_string(p.cold->termination_reason);
+    out.put(mem.minor_faults.load());
+    out.put(mem.major_faults.load());
+    out.put(mem.pages_evicted.load());
+    out.put(mem.bytes_read_from_store.load());
+    out.put(mem.bytes_written_to_store.load());
+
+    out.put(static_cast<uint32_t>(p.cold->page_table.size()));
+    for (const auto& pte : p.cold->page_table) {
+        uint8_t flags = (pte.is_present ? 1 : 0) | (pte.is_dirty ? 2 : 0) | (pte.is_huge ? 4 : 0) | (pte.in_backing_store ? 8 : 0);
+        out.put(flags);
+        out.put(pte.reference_history);
+        out.put(static_cast<int32_t>(pte.frame_index));
+    }
+}
+
+bool restore_process(CheckpointReader& in, const std::vector<std::shared_ptr<const ProgramImage>>& programs,
+                     ProcessIndex& index, SavedQueue& queue) {
+    int32_t id, program_counter, assigned_core;
+    uint8_t queue_tag;
+    uint32_t program_id, page_count;
+    uint64_t memory_size, memory_size_bytes;
+    int64_t start_ticks, finish_ticks, creation_timestamp, backing_store_offset;
+    uint8_t terminated_by_error;
+    uint64_t minor_faults, major_faults, pages_evicted, bytes_read, bytes_written;
+
+    if (!in.get(id) || !in.get(queue_tag) || queue_tag > static_cast<uint8_t>(SavedQueue::FCFS_FINISHED)) return false;
+    // A record that fails to parse or check leaves its table entry for checkpoint_restore() to release.
+    index = g_process_table.create(id);
+    if (index == NO_PROCESS) return false;
+    Process* p = &g_process_table[index];
+    queue = static_cast<SavedQueue>(queue_tag);
+    if (!in.get_string(p->cold->processName) || !in.get(program_id) || program_id >= programs.size()) return false;
+    if (!in.get(program_counter) || !in.get(assigned_core) || !in.get(memory_size)) return false;
+    if (!in.get(start_ticks) || !in.get(finish_ticks)) return false;
+    uint64_t ticks_executed;
+    uint8_t deadline_rejected;
+    if (!in.get(p->weight) || !in.get(ticks_executed)) return false;
+    if (!in.get(p->deadline_tick) || !in.get(p->work_ticks) || !in.get(deadline_rejected)) return false;
+    p->deadline_rejected = deadline_rejected != 0;
+    p->ticks_executed = ticks_executed;
+    p->program_counter = program_counter;
+    g_process_table.core(index) = static_cast<int16_t>(assigned_core);
+    p->memory_size = memory_size;
+    p->start_time = from_ticks(start_ticks);
+    p->finish_time = from_ticks(finish_ticks);
+
+    uint8_t loop_depth;
+    int32_t sleep_ticks_remaining;
+    uint32_t output_line_count;
+    if (!in.get(loop_depth) || loop_depth > MAX_FOR_DEPTH) return false;
+    p->loop_depth = loop_depth;
+    for (int i = 0; i < p->loop_depth; ++i) {
+        int32_t body_pc;
+        if (!in.get(body_pc) || !in.get(p->loop_stack[i].remaining)) return false;
+        if (body_pc < 0) return false;
+        p->loop_stack[i].body_pc = body_pc;
+    }
+    if (!in.get(sleep_ticks_remaining) || !in.get(output_line_count)) return false;
+    p->sleep_ticks_remaining = sleep_ticks_remaining;
+    for (uint32_t i = 0; i < output_line_count; ++i) {
+        int64_t timestamp_ms;
+        int32_t core;
+        std::string line;
+        if (!in.get(timestamp_ms) || !in.get(core) || !in.get_string(line)) return false;
+        if (!p->cold->output) p->cold->output = std::make_shared<PrintLog>();
+        p->cold->output->append(line, core, timestamp_ms);
+    }
+    load_program(*p, programs[program_id]);
+    // The interpreter indexes the code with these unchecked; the end of the code means finished.
+    size_t code_size = p->image ? p->image->code.size() : 0;
+    if (program_counter < 0 || static_cast<size_t>(program_counter) > code_size) return false;
+    for (int i = 0; i < p->loop_depth; ++i) {
+        if (static_cast<size_t>(p->loop_stack[i].body_pc) > code_size) return false;
+    }
+
+    MemoryData& mem = p->mem_data;
+    if (!in.get(memory_size_bytes) || !in.get(creation_timestamp) || !in.get(backing_store_offset)) return false;
+    if (!in.get(terminated_by_error) || !in.get_string(p->cold->termination_reason)) return false;
+    if (!in.get(minor_faults) || !in.get(major_faults) || !in.get(pages_evicted) || !in.get(bytes_read) || !in.get(bytes_written)) return false;
+    mem.memory_size_bytes = memory_size_bytes;
+    mem.creation_timestamp = creation_timestamp;
+    mem.backing_store_offset = backing_store_offset;
+    mem.terminated_by_error = terminated_by_error;
+    mem.minor_faults = minor_faults;
+    mem.major_faults = major_faults;
+    mem.pages_evicted = pages_evicted;
+    mem.bytes_read_from_store = bytes_read;
+    mem.bytes_written_to_store = bytes_written;
+
+    // Frames are checked against the frame table once it is read; see MemoryManager::restore_checkpoint().
+    if (!in.get(page_count) || page_count != (memory_size_bytes + MEM_PER_FRAME - 1) / MEM_PER_FRAME) return false;
+    if (!in.can_hold(page_count, sizeof(uint8_t) + sizeof(unsigned char) + sizeof(int32_t))) return false;
+    p->cold->page_table.resize(page_count);
+    for (auto& pte : p->cold->page_table) {
+        uint8_t flags; int32_t frame_index;
+        if (!in.get(flags) || !in.get(pte.reference_history) || !in.get(frame_index)) return false;
+        pte.is_present = flags & 1;
+        pte.is_dirty = flags & 2;
+        pte.is_huge = flags & 4;
+        pte.in_backing_store = flags & 8;
+        pte.frame_index = frame_index;
+    }
+
+    // A finished process's frames were freed when it finished; images saved before its page table
+    // was cleared along with them still list the frames.
+    if (queue == SavedQueue::RR_FINISHED || queue == SavedQueue::FCFS_FINISHED) {
+        for (auto& pte : p->cold->page_table) {
+            pte.is_present = false;
+            pte.frame_index = -1;
+        }
+    }
+
+    switch (queue) {
+        case SavedQueue::RR_READY: case SavedQueue::FCFS_READY: g_process_table.state(index) = ProcessState::READY; break;
+        case SavedQueue::RR_BLOCKED: case SavedQueue::FCFS_BLOCKED: g_process_table.state(index) = ProcessState::BLOCKED; break;
+        default: g_process_table.state(index) = ProcessState::FINISHED; break;
+    }
+    return true;
+}
+
+} // end anonymous namespace
+
+bool checkpoint_save(const std::string& path, std::string& error) {
+    if (memory_manager == nullptr) {
+        error = "system not initialized";
+        return false;
+    }
+
+    CheckpointWriter out;
+    out.put_bytes(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.put(CHECKPOINT_VERSION);
+    out.put(static_cast<int32_t>(MAX_OVERALL_MEM));
+    out.put(static_cast<int32_t>(MEM_PER_FRAME));
+    out.put(static_cast<int32_t>(HUGE_PAGE_FRAMES));
+
+    // Every core is stopped between instructions first, since a quantum runs outside the scheduler
+    // locks; the locks then keep processes from moving between lists while they are written.
+    PausedCores paused;
+    std::scoped_lock lock(rr_g_process_mutex, fcfs_g_process_mutex);
+    out.put(static_cast<int32_t>(cpuClocks));
+
+    out.put(static_cast<uint32_t>(g_creation_queue.size()));
+    for (const auto& request : g_creation_queue) {
+        out.put_string(request.name);
+        out.put(static_cast<uint64_t>(request.memory_size));
+        out.put(request.weight);
+        out.put(request.deadline);
+        // Generated requests carry their program inline; the rest get the scheduler's fixed workload.
+        out.put(static_cast<uint8_t>(request.program != nullptr));
+        if (request.program) {
+            out.put(static_cast<uint8_t>(request.program->optimized));
+            std::vector<std::string> source = program_source(*request.program);
+            out.put(static_cast<uint32_t>(source.size()));
+            for (const auto& command : source) out.put_string(command);
+        }
+    }
+
+    // Generated processes share a handful of programs, so each distinct command list is stored once.
+    std::vector<std::pair<ProcessIndex, SavedQueue>> saved;
+    auto collect = [&](const auto& process_list, SavedQueue queue) {
+        for (ProcessIndex p : process_list) {
+            if (p != NO_PROCESS) saved.emplace_back(p, queue);
+        }
+    };
+    collect(rr_g_running_processes, SavedQueue::RR_READY);
+    rr_g_ready_queue.for_each([&](ProcessIndex p) { saved.emplace_back(p, SavedQueue::RR_READY); });
+    collect(rr_g_blocked_queue, SavedQueue::RR_BLOCKED);
+    // A process waiting for the pager retries its faulting instruction after the restore.
+    collect(rr_g_fault_queue, SavedQueue::RR_BLOCKED);
+    rr_g_sleep_wheel.for_each([&](ProcessIndex p, uint64_t) { saved.emplace_back(p, SavedQueue::RR_READY); });
+    collect(rr_g_finished_processes, SavedQueue::RR_FINISHED);
+    collect(fcfs_g_running_processes, SavedQueue::FCFS_READY);
+    collect(fcfs_g_ready_queue, SavedQueue::FCFS_READY);
+    collect(fcfs_g_blocked_queue, SavedQueue::FCFS_BLOCKED);
+    fcfs_g_sleep_wheel.for_each([&](ProcessIndex p, uint64_t) { saved.emplace_back(p, SavedQueue::FCFS_READY); });
+    collect(fcfs_g_finished_processes, SavedQueue::FCFS_FINISHED);
+
+    // Interned images are already unique, so the image pointer identifies the program.
+    std::map<const ProgramImage*, uint32_t> program_ids;
+    std::vector<const ProgramImage*> programs;
+    std::vector<uint32_t> process_program(saved.size());
+    for (size_t i = 0; i < saved.size(); ++i) {
+        auto [it, inserted] = program_ids.try_emplace(g_process_table[saved[i].first].image.get(), static_cast<uint32_t>(programs.size()));
+        if (inserted) programs.push_back(it->first);
+        process_program[i] = it->second;
+    }
+
+    out.put(static_cast<uint32_t>(programs.size()));
+    for (const auto* image : programs) {
+        // A process without an image is saved with an empty program. Saved program counters index
+        // the optimized code of optimized images, so restore must optimize exactly those again.
+        out.put(static_cast<uint8_t>(image && image->optimized));
+        std::vector<std::string> source = image ? program_source(*image) : std::vector<std::string>();
+        out.put(static_cast<uint32_t>(source.size()));
+        for (const auto& command : source) out.put_string(command);
+    }
+
+    out.put(static_cast<uint32_t>(saved.size()));
+    for (size_t i = 0; i < saved.size(); ++i) {
+        save_process(out, saved[i].first, saved[i].second, process_program[i]);
+    }
+
+    memory_manager->save_checkpoint(out);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        error = "unable to open " + path + " for writing";
+        return false;
+    }
+    file.write(out.buffer.data(), out.buffer.size());
+    if (!file) {
+        error = "unable to write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool checkpoint_restore(const std::string& path, std::string& error) {
+    if (memory_manager == nullptr) {
+        error = "system not initialized";
+        return false;
+    }
+
+    MappedFile image(path);
+    if (!image.data) {
+        error = "unable to map " + path;
+        return false;
+    }
+    CheckpointReader in(image.data, image.size);
+
+    char magic[4];
+    uint32_t version;
+    int32_t max_overall_mem, mem_per_frame, huge_page_frames, saved_cpu_clocks;
+    if (!in.get_bytes(magic, sizeof(magic)) || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        !in.get(version) || version != CHECKPOINT_VERSION) {
+        error = path + " is not a version " + std::to_string(CHECKPOINT_VERSION) + " checkpoint";
+        return false;
+    }
+    if (!in.get(max_overall_mem) || !in.get(mem_per_frame) || !in.get(huge_page_frames) || !in.get(saved_cpu_clocks)) {
+        error = "truncated checkpoint header";
+        return false;
+    }
+    if (max_overall_mem != MAX_OVERALL_MEM || mem_per_frame != MEM_PER_FRAME || huge_page_frames != HUGE_PAGE_FRAMES) {
+        error = "checkpoint memory layout does not match config.txt";
+        return false;
+    }
+
+    std::deque<ProcessCreationRequest> creation_requests;
+    uint32_t request_count;
+    if (!in.get(request_count)) { error = "truncated creation queue"; return false; }
+    for (uint32_t i = 0; i < request_count; ++i) {
+        ProcessCreationRequest request;
+        uint64_t memory_size;
+        uint8_t has_program;
+        if (!in.get_string(request.name) || !in.get(memory_size) || !in.get(request.weight) || !in.get(request.deadline) || !in.get(has_program)) { error = "truncated creation queue"; return false; }
+        request.memory_size = memory_size;
+        if (has_program) {
+            uint8_t optimized;
+            uint32_t command_count;
+            if (!in.get(optimized) || !in.get(command_count) || !in.can_hold(command_count, sizeof(uint32_t))) { error = "truncated creation queue"; return false; }
+            std::vector<std::string> commands(command_count);
+            for (auto& command : commands) {
+                if (!in.get_string(command)) { error = "truncated creation queue"; return false; }
+            }
+            request.program = build_program(std::move(commands), optimized != 0);
+        }
+        creation_requests.push_back(std::move(request));
+    }
+
+    uint32_t program_count;
+    if (!in.get(program_count) || !in.can_hold(program_count, sizeof(uint8_t) + sizeof(uint32_t))) { error = "truncated program table"; return false; }
+    std::vector<std::shared_ptr<const ProgramImage>> programs(program_count);
+    for (auto& image : programs) {
+        uint8_t optimized;
+        uint32_t command_count;
+        if (!in.get(optimized) || !in.get(command_count) || !in.can_hold(command_count, sizeof(uint32_t))) { error = "truncated program table"; return false; }
+        std::vector<std::string> commands(command_count);
+        for (auto& command : commands) {
+            if (!in.get_string(command)) { error = "truncated program table"; return false; }
+        }
+        // Saved program counters index the code as it was built, stalls on or off.
+        image = intern_program(commands, optimized != 0);
+    }
+
+    // Processes go into table entries that are on no queue and memory is only replaced once the whole
+    // image checks out, so a failed restore hands the entries back and leaves the system empty.
+    uint32_t process_count;
+    // A record holds at least its id, queue tag and name length.
+    if (!in.get(process_count) || !in.can_hold(process_count, sizeof(int32_t) + sizeof(uint8_t) + sizeof(uint32_t))) { error = "truncated process table"; return false; }
+    std::vector<std::pair<ProcessIndex, SavedQueue>> restored(process_count, {NO_PROCESS, SavedQueue::RR_READY});
+    auto discard_restored = [&]() {
+        for (auto& [p, queue] : restored) {
+            if (p != NO_PROCESS) g_process_table.release(p);
+        }
+    };
+    std::vector<const Process*> restored_processes;
+    restored_processes.reserve(process_count);
+    for (auto& [p, queue] : restored) {
+        if (!restore_process(in, programs, p, queue)) {
+            discard_restored();
+            error = "truncated or corrupt process record";
+            return false;
+        }
+        restored_processes.push_back(&g_process_table[p]);
+    }
+
+    if (!memory_manager->restore_checkpoint(in, restored_processes)) {
+        discard_restored();
+        error = "truncated or corrupt memory image";
+        return false;
+    }
+
+    std::scoped_lock lock(rr_g_process_mutex, fcfs_g_process_mutex);
+    cpuClocks = std::max(cpuClocks, static_cast<int>(saved_cpu_clocks));
+    g_creation_queue.insert(g_creation_queue.end(), creation_requests.begin(), creation_requests.end());
+    for (auto& [p, queue] : restored) {
+        Process& process = g_process_table[p];
+        print_log_register(process.cold->processName, process.cold->output);
+        switch (queue) {
+            case SavedQueue::RR_READY:      rr_g_ready_queue.push_back(p); break;
+            case SavedQueue::RR_BLOCKED:    rr_g_blocked_queue.push_back(p); break;
+            case SavedQueue::RR_FINISHED:   rr_g_finished_processes.push_back(p); break;
+            case SavedQueue::FCFS_READY:    fcfs_g_ready_queue.push_back(p); break;
+            case SavedQueue::FCFS_BLOCKED:  fcfs_g_blocked_queue.push_back(p); break;
+            case SavedQueue::FCFS_FINISHED: fcfs_g_finished_processes.push_back(p); break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// --- Checkpoint Image Format ---
+// Host byte order, fixed-width fields. The version must be bumped whenever the layout changes.
+// Header:   magic "CSCK", u32 version, i32 max_overall_mem, i32 mem_per_frame, i32 huge_page_frames, i32 cpu_clocks
+// Sections: creation requests, programs (deduplicated command lists, flagged if optimized), processes,
+//           then the MemoryManager state (frame table, physical memory, backing store).
+const char CHECKPOINT_MAGIC[4] = {'C', 'S', 'C', 'K'};
+const uint32_t CHECKPOINT_VERSION = 8;
+const std::string CHECKPOINT_FILE = "csopesy-checkpoint.bin";
+
+// Appends fixed-width fields to an in-memory image.
+class CheckpointWriter {
+public:
+    std::vector<char> buffer;
+
+    template <typename T>
+    void put(const T& value) { put_bytes(&value, sizeof(T)); }
+
+    void put_bytes(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    void put_string(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        put_bytes(value.data(), value.size());
+    }
+};
+
+// Reads fields back out of a mapped image. Every getter fails instead of reading past the end.
+class CheckpointReader {
+public:
+    CheckpointReader(const char* data, size_t size) : cursor(data), end(data + size) {}
+
+    template <typename T>
+    bool get(T& value) { return get_bytes(&value, sizeof(T)); }
+
+    bool get_bytes(void* out, size_t size) {
+        const char* data = view(size);
+        if (!data) return false;
+        std::memcpy(out, data, size);
+        return true;
+    }
+
+    bool get_string(std::string& value) {
+        uint32_t size;
+        if (!get(size)) return false;
+        const char* data = view(size);
+        if (!data) return false;
+        value.assign(data, size);
+        return true;
+    }
+
+    // Whether count records of at least record_bytes each still fit in the image, so that a corrupt
+    // count fails before anything is sized by it.
+    bool can_hold(uint64_t count, size_t record_bytes) const {
+        return count <= static_cast<size_t>(end - cursor) / record_bytes;
+    }
+
+    // Returns a pointer into the image and skips past it, or nullptr if the image is too short.
+    const char* view(size_t size) {
+        if (static_cast<size_t>(end - cursor) < size) return nullptr;
+        const char* data = cursor;
+        cursor += size;
+        return data;
+    }
+
+private:
+    const char* cursor;
+    const char* end;
+};
+
+// Serializes every process, the scheduler queues and all memory state. Returns false and sets error on failure.
+bool checkpoint_save(const std::string& path, std::string& error);
+// Loads an image written by checkpoint_save. Must run after the MemoryManager exists and before the scheduler starts.
+bool checkpoint_restore(const std::string& path, std::string& error);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,90 @@
+#include "CoreCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+
+#include "global.h"
+
+CoreCacheConfig core_cache_config_from_globals() {
+    CoreCacheConfig config;
+    config.enabled = CORE_CACHE != 0;
+    config.sets = static_cast<int>(std::bit_floor(static_cast<unsigned>(std::max(1, CACHE_SETS))));
+    config.ways = std::max(1, CACHE_WAYS);
+    config.line_bytes = static_cast<int>(std::bit_floor(static_cast<unsigned>(std::max(2, CACHE_LINE_BYTES))));
+    config.miss_penalty = std::max(0, CACHE_MISS_PENALTY);
+    return config;
+}
+
+void CoreCache::reset(int sets, int ways) {
+    sets_ = sets;
+    ways_ = ways;
+    tags_.assign(static_cast<size_t>(sets) * ways, 0);
+    hits_ = 0;
+    misses_ = 0;
+}
+
+bool CoreCache::access(uint64_t line) {
+    // Sets are picked by the low line bits, with the PID folded in so processes do not all start at set 0.
+    size_t set = static_cast<size_t>((line ^ (line >> 32) * 0x9E3779B1u) & static_cast<uint64_t>(sets_ - 1));
+    uint64_t* ways = &tags_[set * ways_];
+    uint64_t tag = line + 1;
+    int way = 0;
+    while (way < ways_ && ways[way] != tag) way++;
+    bool hit = way < ways_;
+    if (!hit) way = ways_ - 1;
+    // Shift the more recent ways down one and put this line in front.
+    for (; way > 0; --way) ways[way] = ways[way - 1];
+    ways[0] = tag;
+    if (hit) hits_.fetch_add(1, std::memory_order_relaxed);
+    else misses_.fetch_add(1, std::memory_order_relaxed);
+    return hit;
+}
+
+void CoreCaches::configure(const CoreCacheConfig& config, int cores) {
+    config_ = config;
+    line_shift_ = std::countr_zero(static_cast<unsigned>(config_.line_bytes));
+    cores_ = std::make_unique<CoreCache[]>(static_cast<size_t>(MAX_CORES));
+    cores_count_ = 0;
+    add_cores(cores);
+    migrations_ = 0;
+}
+
+void CoreCaches::add_cores(int cores) {
+    // cpu-set before the first configure() has no caches to add to; configure() brings up its cores.
+    if (!cores_) return;
+    cores = std::clamp(cores, 0, MAX_CORES);
+    int count = cores_count_.load(std::memory_order_relaxed);
+    for (int i = count; i < cores; ++i) cores_[i].reset(config_.sets, config_.ways);
+    if (cores > count) cores_count_.store(cores, std::memory_order_release);
+}
+
+uint64_t CoreCaches::hits() const {
+    uint64_t total = 0;
+    for (int i = 0; i < cores(); ++i) total += cores_[i].hits();
+    return total;
+}
+
+uint64_t CoreCaches::misses() const {
+    uint64_t total = 0;
+    for (int i = 0; i < cores(); ++i) total += cores_[i].misses();
+    return total;
+}
+
+void write_core_cache_report(std::ostream& out) {
+    if (!g_core_caches.enabled()) return;
+    auto hit_rate = [](uint64_t hits, uint64_t misses) {
+        return hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0;
+    };
+    const CoreCacheConfig& config = g_core_caches.config();
+    out << "Core caches: " << config.sets << " sets x " << config.ways << " ways x " << config.line_bytes << " bytes, "
+        << config.miss_penalty << " ticks per miss, affinity " << (CACHE_AFFINITY ? "on" : "off") << "\n";
+    out << std::fixed << std::setprecision(1);
+    out << "  all cores: " << hit_rate(g_core_caches.hits(), g_core_caches.misses()) << "% hits, "
+        << g_core_caches.stall_ticks() << " stall ticks, " << g_core_caches.migrations() << " migrations\n";
+    for (int i = 0; i < g_core_caches.cores(); ++i) {
+        const CoreCache& cache = g_core_caches.core(i);
+        out << "  core " << i << ": " << hit_rate(cache.hits(), cache.misses()) << "% hits (" << cache.hits() << "/"
+            << cache.hits() + cache.misses() << ")\n";
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef CORE_CACHE_H
+#define CORE_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Geometry and miss cost of the simulated per-core caches, read from config.txt by
+// core_cache_config_from_globals().
+struct CoreCacheConfig {
+    bool enabled = false;
+    int sets = 64;         // Power of two
+    int ways = 4;
+    int line_bytes = 16;   // Power of two
+    int miss_penalty = 10; // Extra ticks an access that misses costs the process
+};
+
+CoreCacheConfig core_cache_config_from_globals();
+
+// --- Per-Core Cache ---
+// One core's set-associative cache over emulated addresses, tagged by PID and logical line so
+// processes never share lines. Each set keeps its ways in LRU order, most recent first, so a hit
+// moves the line to the front and a miss drops the last way. Only the thread running the core's
+// process touches the tags; the counters are relaxed atomics so reports can read them meanwhile.
+class CoreCache {
+public:
+    void reset(int sets, int ways);
+
+    // True on a hit; a miss fills the line.
+    bool access(uint64_t line);
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    int sets_ = 0;
+    int ways_ = 0;
+    std::vector<uint64_t> tags_; // sets_ * ways_, line + 1 so that 0 means empty
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+// --- Core Caches ---
+// The caches of every core, shared by whichever scheduler runs. The interpreter charges every
+// READ, WRITE and variable access of a process on a core to that core's cache; a process that
+// moves to another core finds its lines cold there. The scheduler reports each dispatch so
+// migrations can be counted.
+class CoreCaches {
+public:
+    static constexpr int MAX_CORES = 128;
+
+    // Empties every cache and clears the counters. Not safe while processes run.
+    void configure(const CoreCacheConfig& config, int cores);
+    // cpu-set: brings up empty caches for cores up to cores. Room for MAX_CORES is allocated by
+    // configure(), so the caches of running cores never move. Retired cores keep their caches and
+    // counters; a core that comes back finds its old lines.
+    void add_cores(int cores);
+    bool enabled() const { return config_.enabled; }
+    const CoreCacheConfig& config() const { return config_; }
+
+    // Extra ticks the access costs: 0 on a hit, miss_penalty on a miss.
+    int access(int core, int pid, int address) {
+        if (!config_.enabled || core < 0 || core >= cores_count_.load(std::memory_order_relaxed)) return 0;
+        uint64_t line = (static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) | (static_cast<uint32_t>(address) >> line_shift_);
+        return cores_[core].access(line) ? 0 : config_.miss_penalty;
+    }
+
+    // A process from previous_core (-1 if it never ran) goes to core.
+    void record_dispatch(int previous_core, int core) {
+        if (previous_core >= 0 && previous_core != core) migrations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int cores() const { return cores_count_.load(std::memory_order_relaxed); }
+    const CoreCache& core(int index) const { return cores_[index]; }
+    uint64_t hits() const;
+    uint64_t misses() const;
+    uint64_t stall_ticks() const { return misses() * static_cast<uint64_t>(config_.miss_penalty); }
+    uint64_t migrations() const { return migrations_.load(std::memory_order_relaxed); }
+
+private:
+    CoreCacheConfig config_;
+    int line_shift_ = 4;
+    std::atomic<int> cores_count_{0}; // Caches brought up so far
+    std::unique_ptr<CoreCache[]> cores_;
+    std::atomic<uint64_t> migrations_{0};
+};
+
+// Hit rate and stall ticks of g_core_caches per core, and the migrations, for report-util. Writes
+// nothing while core-cache is off.
+void write_core_cache_report(std::ostream& out);
+
+#endif // CORE_CACHE_H
@@ -18,11 +18,26 @@
 #include "global.h" // Corrected to 'global.h' as you specified
 #include "FCFS.h"
 #include "config.h"
+#include "MemorySnapshot.h"
+#include "Interpreter.h"
+#include "Workload.h"
+#include "vmstat.h"
 
 // --- File-local variables ---
 std::random_device fcfs_rd;
 std::mt19937 fcfs_gen(fcfs_rd());
 
+// How often the scheduler checks for due sleepers while every busy core runs to completion.
+const auto FCFS_SLEEP_POLL = std::chrono::milliseconds(10);
+// One worker thread per core, indexed by core id; see rr_core_workers.
+static std::vector<std::thread>& fcfs_core_workers = *new std::vector<std::thread>();
+static std::mutex fcfs_core_workers_mutex;
+// fcfs_pause_cores(): while set, workers stop between ticks and start no new process. A core is
+// ticking from claiming a process until it next takes fcfs_g_process_mutex with the pause set.
+// Both guarded by fcfs_g_process_mutex.
+static bool fcfs_cores_paused = false;
+static bool fcfs_core_ticking[CoreCaches::MAX_CORES] = {};
+
 // --- Forward Declarations ---
 void fcfs_scheduler_thread_func();
 void fcfs_core_worker_func(int core_id);
@@ -36,17 +51,72 @@ std::string fcfs_format_time(const std::chrono::system_clock::time_point& tp, co
     return ss.str();
 }
 
+// --- Program for Generated Processes ---
+void fcfs_load_generated_program(Process& pcb, size_t memory_size) {
+    // Every generated process shares one image instead of carrying its own copy.
+    static const std::shared_ptr<const ProgramImage> workload = intern_program({"write 0x0 111", "read 0x0"});
+    static const std::shared_ptr<const ProgramImage> empty = intern_program({});
+    load_program(pcb, memory_size > 2 ? workload : empty);
+}
+
+// --- Process Table Entries ---
+// A table entry for a new process named name. When the table is full, the oldest finished processes
+// leave the report history and their entries are reused; if every entry holds a live process the
+// request is rejected with a message. Caller holds fcfs_g_process_mutex.
+static ProcessIndex fcfs_new_process(const std::string& name) {
+    int id = cpuClocks++;
+    ProcessIndex index = g_process_table.create(id);
+    if (index == NO_PROCESS && recycle_finished(g_process_table, fcfs_g_finished_processes) > 0) {
+        index = g_process_table.create(id);
+    }
+    if (index == NO_PROCESS) {
+        std::lock_guard<std::mutex> lock(g_cout_mutex);
+        std::cout << "\nProcess table full: " << name << " was not created" << std::endl;
+    }
+    return index;
+}
+
+// --- Sleeping Processes ---
+// Caller holds fcfs_g_process_mutex. Same as rr_wake_sleepers: due sleepers go back to the ready
+// queue, and with every core idle the clock skips to the next wake-up.
+void fcfs_wake_sleepers() {
+    static std::vector<ProcessIndex> woken;
+    uint64_t now = static_cast<uint64_t>(get_cpu_clock_ticks());
+    bool cores_idle = std::all_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.begin() + CPU_COUNT, [](ProcessIndex p){ return p == NO_PROCESS; });
+    if (cores_idle && fcfs_g_ready_queue.empty() && !fcfs_g_sleep_wheel.empty() && fcfs_g_sleep_wheel.next_event_tick() > now) {
+        vmstats_add_idle_ticks(static_cast<long>(fcfs_g_sleep_wheel.next_event_tick() - now) * CPU_COUNT);
+        now = fcfs_g_sleep_wheel.next_event_tick();
+    }
+    fcfs_g_sleep_wheel.advance(now, woken);
+    for (ProcessIndex process : woken) {
+        g_process_table.state(process) = ProcessState::READY;
+        g_process_table[process].sleep_ticks_remaining = 0;
+        fcfs_g_ready_queue.push_back(process);
+    }
+    woken.clear();
+}
+
 // --- The Scheduler Thread ---
 void fcfs_scheduler_thread_func() {
     while (fcfs_g_is_running) {
         std::unique_lock<std::mutex> lock(fcfs_g_process_mutex);
 
-        fcfs_g_scheduler_cv.wait(lock, [&]() {
+        // Running FCFS processes only signal when they leave their core, so while processes sleep the
+        // scheduler also looks at the clock every FCFS_SLEEP_POLL.
+        auto ready_to_schedule = [&]() {
             if (!fcfs_g_is_running) return true;
-            bool core_is_free = std::any_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.end(), [](const auto& p){ return p == nullptr; });
+            bool core_is_free = std::any_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.begin() + CPU_COUNT, [](ProcessIndex p){ return p == NO_PROCESS; });
+            bool cores_idle = std::all_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.begin() + CPU_COUNT, [](ProcessIndex p){ return p == NO_PROCESS; });
+            bool sleeper_due = static_cast<uint64_t>(get_cpu_clock_ticks()) >= fcfs_g_sleep_wheel.next_event_tick();
             // CORRECTION: The scheduler should also wake up for creation requests.
-            return !g_creation_queue.empty() || !fcfs_g_blocked_queue.empty() || (core_is_free && !fcfs_g_ready_queue.empty());
-        });
+            return !g_creation_queue.empty() || !fcfs_g_blocked_queue.empty() || (core_is_free && !fcfs_g_ready_queue.empty()) ||
+                   (core_is_free && sleeper_due) || (cores_idle && fcfs_g_ready_queue.empty() && !fcfs_g_sleep_wheel.empty());
+        };
+        if (fcfs_g_sleep_wheel.empty()) {
+            fcfs_g_scheduler_cv.wait(lock, ready_to_schedule);
+        } else if (!fcfs_g_scheduler_cv.wait_for(lock, FCFS_SLEEP_POLL, ready_to_schedule)) {
+            continue;
+        }
 
         if (!fcfs_g_is_running) break;
 
@@ -55,35 +125,49 @@ void fcfs_scheduler_thread_func() {
             ProcessCreationRequest request = g_creation_queue.front();
             g_creation_queue.pop_front();
             
-            std::shared_ptr<Process> pcb = std::make_shared<Process>(cpuClocks++);
+            ProcessIndex index = fcfs_new_process(request.name);
+            if (index == NO_PROCESS) continue;
+            Process* pcb = &g_process_table[index];
             pcb->start_time = std::chrono::system_clock::now();
-            pcb->processName = request.name;
+            pcb->arrival_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+            pcb->cold->processName = request.name;
+            pcb->weight = request.weight > 0 ? request.weight : static_cast<uint32_t>(DEFAULT_WEIGHT);
+            print_log_register(pcb->cold->processName, pcb->cold->output);
             
             memory_manager->allocate_for_process(*pcb, request.memory_size);
 
-            // Add valid commands
-            if (request.memory_size > 2) {
-                pcb->commands.push_back("write 0x0 111");
-                pcb->commands.push_back("read 0x0");
+            if (request.program) {
+                load_program(*pcb, std::move(request.program));
+            } else {
+                fcfs_load_generated_program(*pcb, request.memory_size);
             }
-            fcfs_g_ready_queue.push_back(pcb); 
+            if (request.deadline > 0 && pcb->image) {
+                pcb->deadline_tick = pcb->arrival_tick + request.deadline;
+                pcb->work_ticks = program_ticks(*pcb->image);
+            }
+            g_process_table.state(index) = ProcessState::READY;
+            fcfs_g_ready_queue.push_back(index); 
         }
 
         // --- Unblock processes ---
         while (!fcfs_g_blocked_queue.empty()) {
-            std::shared_ptr<Process> unblocked_process = fcfs_g_blocked_queue.front();
+            ProcessIndex unblocked_process = fcfs_g_blocked_queue.front();
             fcfs_g_blocked_queue.pop_front();
-            unblocked_process->state = ProcessState::READY;
+            g_process_table.state(unblocked_process) = ProcessState::READY;
             fcfs_g_ready_queue.push_back(unblocked_process);
         }
 
+        // --- Wake sleeping processes ---
+        fcfs_wake_sleepers();
+
         // --- Assign ready processes to cores ---
         for (int i = 0; i < CPU_COUNT; ++i) {
-            if (fcfs_g_running_processes[i] == nullptr && !fcfs_g_ready_queue.empty()) {
-                std::shared_ptr<Process> process = fcfs_g_ready_queue.front();
+            if (fcfs_g_running_processes[i] == NO_PROCESS && !fcfs_g_ready_queue.empty()) {
+                ProcessIndex process = fcfs_g_ready_queue.front();
                 fcfs_g_ready_queue.pop_front();
-                process->state = ProcessState::RUNNING;
-                process->assigned_core = i;
+                g_core_caches.record_dispatch(g_process_table.core(process), i);
+                g_process_table.state(process) = ProcessState::RUNNING;
+                g_process_table.core(process) = static_cast<int16_t>(i);
                 fcfs_g_running_processes[i] = process;
             }
         }
@@ -93,72 +177,117 @@ void fcfs_scheduler_thread_func() {
 // --- The CPU Worker Thread ---
 void fcfs_core_worker_func(int core_id) {
     while (fcfs_g_is_running) {
-        std::shared_ptr<Process> my_process = nullptr;
+        ProcessIndex my_index;
         {
             std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
-            my_process = fcfs_g_running_processes[core_id];
+            my_index = fcfs_g_running_processes[core_id];
+            if (core_id >= CPU_COUNT) {
+                // Retired by cpu-set: a process assigned just before keeps its turn at the front.
+                if (my_index != NO_PROCESS) {
+                    g_process_table.state(my_index) = ProcessState::READY;
+                    fcfs_g_ready_queue.push_front(my_index);
+                    fcfs_g_running_processes[core_id] = NO_PROCESS;
+                    fcfs_g_scheduler_cv.notify_one();
+                }
+                break;
+            }
+            // A process assigned while paused waits on the core until fcfs_resume_cores().
+            if (fcfs_cores_paused) my_index = NO_PROCESS;
+            fcfs_core_ticking[core_id] = my_index != NO_PROCESS;
         }
 
-        if (my_process) {
-            while (my_process->program_counter < my_process->commands.size()) {
-                const std::string& command_str = my_process->commands[my_process->program_counter];
-                std::istringstream iss(command_str);
-                std::string command_token;
-                iss >> command_token;
-
-                if (command_token == "read" || command_token == "write") {
-                    int address;
-                    iss >> std::hex >> address;
-                    bool is_write_op = (command_token == "write");
-                    char* physical_ptr = memory_manager->access_memory(*my_process, address, is_write_op);
-
-                    if (my_process->mem_data.terminated_by_error) {
-                        {
-                           std::lock_guard<std::mutex> lock(g_cout_mutex);
-                           std::cout << "\nProcess " << my_process->processName << " terminated: " << my_process->mem_data.termination_reason << std::endl;
-                        }
-                        {
-                            std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
-                            my_process->state = ProcessState::FINISHED;
-                            fcfs_g_finished_processes.push_back(my_process);
-                            fcfs_g_running_processes[core_id] = nullptr;
-                            memory_manager->deallocate_for_process(*my_process);
-                            fcfs_g_scheduler_cv.notify_one();
-                        }
-                        goto next_process_loop;
-                    } 
-                    if (physical_ptr == nullptr) {
+        if (my_index != NO_PROCESS) {
+            Process* my_process = &g_process_table[my_index];
+            // Run one tick at a time until the program ends, pacing each tick like the original loop.
+            for (;;) {
+                int ticks = 0;
+                uint64_t tick_start = static_cast<uint64_t>(get_cpu_clock_ticks());
+                ExecStatus status = interpreter_run(*my_process, 1, ticks);
+                for (int t = 0; t < ticks; ++t) vmstats_increment_active_ticks();
+                my_process->ticks_executed.fetch_add(static_cast<uint64_t>(ticks), std::memory_order_relaxed);
+                if (ticks > 0 && my_process->first_run_tick == NOT_YET_TICK) my_process->first_run_tick = tick_start;
+                if (status == ExecStatus::FINISHED) break;
+
+                if (status == ExecStatus::TERMINATED) {
+                    {
+                       std::lock_guard<std::mutex> lock(g_cout_mutex);
+                       std::cout << "\nProcess " << my_process->cold->processName << " terminated: " << my_process->cold->termination_reason << std::endl;
+                    }
+                    {
                         std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
-                        my_process->state = ProcessState::BLOCKED;
-                        fcfs_g_blocked_queue.push_back(my_process);
-                        fcfs_g_running_processes[core_id] = nullptr;
+                        g_process_table.state(my_index) = ProcessState::FINISHED;
+                        my_process->finish_time = std::chrono::system_clock::now();
+                        my_process->finish_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+                        fcfs_g_finished_processes.push_back(my_index);
+                        fcfs_g_running_processes[core_id] = NO_PROCESS;
+                        memory_manager->deallocate_for_process(*my_process);
+                        fcfs_g_scheduler_cv.notify_one();
+                    }
+                    goto next_process_loop;
+                }
+                if (status == ExecStatus::BLOCKED) {
+                    std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+                    g_process_table.state(my_index) = ProcessState::BLOCKED;
+                    fcfs_g_blocked_queue.push_back(my_index);
+                    fcfs_g_running_processes[core_id] = NO_PROCESS;
+                    fcfs_g_scheduler_cv.notify_one();
+                    goto next_process_loop;
+                }
+                if (status == ExecStatus::SLEEPING) {
+                    // SLEEP: park the process on the timer wheel and free the core for the next ready process.
+                    std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+                    g_process_table.state(my_index) = ProcessState::SLEEPING;
+                    my_process->wake_tick = static_cast<uint64_t>(get_cpu_clock_ticks()) + my_process->sleep_ticks_remaining;
+                    fcfs_g_sleep_wheel.schedule(my_index, my_process->wake_tick);
+                    fcfs_g_running_processes[core_id] = NO_PROCESS;
+                    fcfs_g_scheduler_cv.notify_one();
+                    goto next_process_loop;
+                }
+                {
+                    // Retired by cpu-set mid-run, or the scheduler is stopping: the process goes back
+                    // to the front of the ready queue, so the next free core continues it before
+                    // anything that arrived later.
+                    std::unique_lock<std::mutex> lock(fcfs_g_process_mutex);
+                    if (core_id >= CPU_COUNT || !fcfs_g_is_running) {
+                        g_process_table.state(my_index) = ProcessState::READY;
+                        fcfs_g_ready_queue.push_front(my_index);
+                        fcfs_g_running_processes[core_id] = NO_PROCESS;
                         fcfs_g_scheduler_cv.notify_one();
                         goto next_process_loop;
                     }
-                    if (is_write_op) {
-                        int value_to_write;
-                        iss >> value_to_write;
-                        *(reinterpret_cast<uint16_t*>(physical_ptr)) = static_cast<uint16_t>(value_to_write);
+                    // Paused: wait here, between two instructions, until the pause is over.
+                    if (fcfs_cores_paused) {
+                        fcfs_core_ticking[core_id] = false;
+                        while (fcfs_cores_paused && fcfs_g_is_running) {
+                            lock.unlock();
+                            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                            lock.lock();
+                        }
+                        fcfs_core_ticking[core_id] = true;
                     }
                 }
-                my_process->program_counter++;
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
             }
 
             {
                 std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
-                my_process->state = ProcessState::FINISHED;
+                g_process_table.state(my_index) = ProcessState::FINISHED;
                 my_process->finish_time = std::chrono::system_clock::now();
-                fcfs_g_finished_processes.push_back(my_process);
-                fcfs_g_running_processes[core_id] = nullptr;
+                my_process->finish_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+                fcfs_g_finished_processes.push_back(my_index);
+                fcfs_g_running_processes[core_id] = NO_PROCESS;
                 memory_manager->deallocate_for_process(*my_process);
                 fcfs_g_scheduler_cv.notify_one();
             }
+            snapshot_capture();
         } else {
+            vmstats_increment_idle_ticks();
             std::this_thread::sleep_for(std::chrono::milliseconds(50));
         }
     next_process_loop:;
     }
+    std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+    fcfs_core_ticking[core_id] = false;
 }
 
 // --- UI Functions ---
@@ -168,8 +297,8 @@ void fcfs_display_processes() {
     
     // --- NEW: Calculate CPU Utilization ---
     int busyCores = 0;
-    for (const auto& p : fcfs_g_running_processes) {
-        if (p != nullptr) {
+    for (ProcessIndex p : fcfs_g_running_processes) {
+        if (p != NO_PROCESS) {
             busyCores++;
         }
     }
@@ -183,23 +312,26 @@ void fcfs_display_processes() {
 
     // The rest of your original display logic remains.
     std::cout << "\nRunning processes:\n";
-    for (const auto& p : fcfs_g_running_processes) {
-        if (p) {
+    for (ProcessIndex index : fcfs_g_running_processes) {
+        if (index != NO_PROCESS) {
+            const Process* p = &g_process_table[index];
             // Updated to use your original, more detailed format
             std::cout << "process" << (p->id < 10 ? "0" : "") << std::to_string(p->id)
                       << " (" << fcfs_format_time(p->start_time, "%m/%d/%Y %I:%M:%S%p") << ")"
-                      << "\tCore: " << p->assigned_core
-                      << "\t" << p->program_counter << " / " << p->commands.size() << std::endl;
+                      << "\tCore: " << g_process_table.core(index)
+                      << "\t" << p->program_counter << " / " << program_length(*p) << std::endl;
         }
     }
 
+    std::cout << "\nSleeping processes: " << fcfs_g_sleep_wheel.size() << "\n";
     std::cout << "\nFinished processes:\n";
-    for (const auto& p : fcfs_g_finished_processes) {
+    for (ProcessIndex index : fcfs_g_finished_processes) {
+        const Process* p = &g_process_table[index];
         // Updated to use your original, more detailed format
         std::cout << "process" << (p->id < 10 ? "0" : "") << std::to_string(p->id)
                   << " (" << fcfs_format_time(p->finish_time, "%m/%d/%Y %I:%M:%S%p") << ")"
                   << "\tFinished"
-                  << "\t" << p->program_counter << " / " << p->commands.size() << std::endl;
+                  << "\t" << p->program_counter << " / " << program_length(*p) << std::endl;
     }
     std::cout << "-------------------------------------------------------------\n\n";
 }
@@ -221,8 +353,8 @@ void fcfs_write_processes() {
 
     // --- NEW: Calculate CPU Utilization (same as the display function) ---
     int busyCores = 0;
-    for (const auto& p : fcfs_g_running_processes) {
-        if (p != nullptr) {
+    for (ProcessIndex p : fcfs_g_running_processes) {
+        if (p != NO_PROCESS) {
             busyCores++;
         }
     }
@@ -231,24 +363,27 @@ void fcfs_write_processes() {
 
     // --- Print the lists (using your original detailed format) ---
     outfile << "\nRunning processes:\n";
-    for (const auto& p : fcfs_g_running_processes) {
-        if (p) {
+    for (ProcessIndex index : fcfs_g_running_processes) {
+        if (index != NO_PROCESS) {
+            const Process* p = &g_process_table[index];
             outfile << "process" << (p->id < 10 ? "0" : "") << std::to_string(p->id)
                     << " (" << fcfs_format_time(p->start_time, "%m/%d/%Y %I:%M:%S%p") << ")"
-                    << "\tCore: " << p->assigned_core
-                    << "\t" << p->program_counter << " / " << p->commands.size() << std::endl;
+                    << "\tCore: " << g_process_table.core(index)
+                    << "\t" << p->program_counter << " / " << program_length(*p) << std::endl;
         }
     }
 
     outfile << "\nFinished processes:\n";
-    for (const auto& p : fcfs_g_finished_processes) {
-        if (p) {
-            outfile << "process" << (p->id < 10 ? "0" : "") << std::to_string(p->id)
-                    << " (" << fcfs_format_time(p->finish_time, "%m/%d/%Y %I:%M:%S%p") << ")"
-                    << "\tFinished"
-                    << "\t" << p->program_counter << " / " << p->commands.size() << std::endl;
-        }
+    for (ProcessIndex index : fcfs_g_finished_processes) {
+        const Process* p = &g_process_table[index];
+        outfile << "process" << (p->id < 10 ? "0" : "") << std::to_string(p->id)
+                << " (" << fcfs_format_time(p->finish_time, "%m/%d/%Y %I:%M:%S%p") << ")"
+                << "\tFinished"
+                << "\t" << p->program_counter << " / " << program_length(*p) << std::endl;
     }
+    outfile << "\n";
+    write_deadline_report(outfile, fcfs_g_finished_processes);
+    write_core_cache_report(outfile);
     outfile << "-------------------------------------------------------------\n\n";
     
     outfile.close();
@@ -256,17 +391,23 @@ void fcfs_write_processes() {
 
 void fcfs_create_process_with_commands(std::string processName, size_t memory_size, const std::vector<std::string>& commands) {
     // Create a new process
-    std::shared_ptr<Process> pcb;
-    
-    pcb = std::make_shared<Process>(cpuClocks);
-    pcb->start_time = std::chrono::system_clock::now(); 
-    pcb->processName = processName;
-    pcb->memory_size = memory_size;
-
-    pcb->commands = commands;
-
-    cpuClocks++;
-    fcfs_g_ready_queue.push_back(pcb);
+    {
+        std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+        ProcessIndex index = fcfs_new_process(processName);
+        if (index == NO_PROCESS) return;
+        Process* pcb = &g_process_table[index];
+        pcb->start_time = std::chrono::system_clock::now(); 
+        pcb->arrival_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+        pcb->cold->processName = processName;
+        print_log_register(pcb->cold->processName, pcb->cold->output);
+        pcb->memory_size = memory_size;
+        load_program(*pcb, intern_program(commands));
+
+        // READ / WRITE need backing memory, like processes from the creation queue.
+        memory_manager->allocate_for_process(*pcb, memory_size > 0 ? memory_size : MIN_MEM_PER_PROC);
+        g_process_table.state(index) = ProcessState::READY;
+        fcfs_g_ready_queue.push_back(index);
+    }
 
     // Notify scheduler that a new process is available
     fcfs_g_scheduler_cv.notify_one();
@@ -276,26 +417,19 @@ void fcfs_create_process_with_commands(std::string processName, size_t memory_si
 // CORRECTION: This now adds requests to the shared queue.
 void fcfs_create_processes(MemoryManager& mm) {
     process_maker_running = true;
-    while (process_maker_running) {
-        {
-            // Lock the appropriate mutex. FCFS should use its own, but we can share for simplicity.
-            std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
-            g_creation_queue.push_back({"fcfs_proc" + std::to_string(cpuClocks), 128});
-        }
-        fcfs_g_scheduler_cv.notify_one();
-        std::this_thread::sleep_for(std::chrono::milliseconds(processFrequency));
-    }
+    run_workload_generator(fcfs_g_process_mutex, fcfs_g_scheduler_cv, "fcfs_proc");
 
     // --- Shutdown Logic ---
     while (true) {
         bool all_done;
         {
             std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
-            bool running_is_empty = std::all_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.end(), [](const auto& p){ return p == nullptr; });
+            bool running_is_empty = std::all_of(fcfs_g_running_processes.begin(), fcfs_g_running_processes.end(), [](ProcessIndex p){ return p == NO_PROCESS; });
             all_done = g_creation_queue.empty() && fcfs_g_ready_queue.empty() && fcfs_g_blocked_queue.empty() && running_is_empty;
         }
-        if (all_done) break;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        // exit stops the scheduler whether or not its processes are done.
+        if (all_done || !fcfs_g_is_running) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     fcfs_g_is_running = false;
     fcfs_g_scheduler_cv.notify_all();
@@ -304,17 +438,91 @@ void fcfs_create_processes(MemoryManager& mm) {
 // --- The Main Scheduler Entry Point ---
 int FCFS() {
     fcfs_g_is_running = true;
+    g_core_caches.configure(core_cache_config_from_globals(), CPU_COUNT);
+    {
+        std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+        fcfs_g_running_processes.assign(static_cast<size_t>(CPU_COUNT), NO_PROCESS);
+    }
     
     std::thread scheduler(fcfs_scheduler_thread_func);
-    std::vector<std::thread> core_workers;
-    for (int i = 0; i < CPU_COUNT; ++i) {
-        core_workers.emplace_back(fcfs_core_worker_func, i);
+    {
+        std::lock_guard<std::mutex> lock(fcfs_core_workers_mutex);
+        for (int i = 0; i < CPU_COUNT; ++i) {
+            fcfs_core_workers.emplace_back(fcfs_core_worker_func, i);
+        }
     }
     
     scheduler.join();
+    std::vector<std::thread> core_workers;
+    {
+        std::lock_guard<std::mutex> lock(fcfs_core_workers_mutex);
+        core_workers.swap(fcfs_core_workers);
+    }
     for (auto& worker : core_workers) {
         worker.join();
     }
     
     return 0;
+}
+
+// --- Pausing the Cores ---
+// As rr_pause_cores(): a worker runs its process's ticks outside fcfs_g_process_mutex, so pausing
+// waits until every core has stopped between two ticks or let go of its process.
+void fcfs_pause_cores() {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+            fcfs_cores_paused = true;
+            // A core that let go of its process may still be marked until its next claim.
+            bool ticking = false;
+            for (size_t i = 0; i < fcfs_g_running_processes.size(); ++i) {
+                ticking = ticking || (fcfs_core_ticking[i] && fcfs_g_running_processes[i] != NO_PROCESS);
+            }
+            if (!ticking) return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void fcfs_resume_cores() {
+    std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+    fcfs_cores_paused = false;
+}
+
+// --- Core Hotplug ---
+// As rr_set_core_count(), except that FCFS runs a process to completion: a retiring core hands its
+// process back at the next tick, to the front of the ready queue.
+int fcfs_set_core_count(int cores) {
+    cores = std::clamp(cores, 1, CoreCaches::MAX_CORES);
+    std::lock_guard<std::mutex> workers_lock(fcfs_core_workers_mutex);
+    std::vector<std::thread> retired;
+    int previous;
+    {
+        std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+        previous = CPU_COUNT;
+        if (cores > previous) {
+            fcfs_g_running_processes.resize(static_cast<size_t>(cores), NO_PROCESS);
+            g_core_caches.add_cores(cores);
+        }
+        memory_manager->set_numa_cores(cores);
+        vmstats_set_core_count(cores);
+        if (!fcfs_core_workers.empty()) {
+            for (int i = static_cast<int>(fcfs_core_workers.size()); i < cores; ++i) {
+                fcfs_core_workers.emplace_back(fcfs_core_worker_func, i);
+            }
+            for (size_t i = static_cast<size_t>(cores); i < fcfs_core_workers.size(); ++i) {
+                retired.push_back(std::move(fcfs_core_workers[i]));
+            }
+            fcfs_core_workers.resize(std::min(fcfs_core_workers.size(), static_cast<size_t>(cores)));
+        }
+    }
+    fcfs_g_scheduler_cv.notify_one();
+    for (auto& worker : retired) {
+        worker.join();
+    }
+    if (cores < previous) {
+        std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+        fcfs_g_running_processes.resize(static_cast<size_t>(CPU_COUNT));
+    }
+    return previous;
 }
\ No newline at end of file
@@ -4,11 +4,21 @@
 #include <string>
 #include <vector>
 class MemoryManager; // Forward declaration is enough
+class Process;
 
 // --- Public Function Declarations ONLY ---
 int FCFS();
 void fcfs_create_processes(MemoryManager& mm);
 void fcfs_display_processes();
 void fcfs_write_processes();
+// Fills in the fixed program every scheduler-generated process runs.
+void fcfs_load_generated_program(Process& pcb, size_t memory_size);
+// cpu-set: runs on cores cores from now on, clamped to [1, 128], and returns the previous count.
+// A retired core's process goes back to the front of the ready queue.
+int fcfs_set_core_count(int cores);
+// As rr_pause_cores(): returns once every core has stopped between two ticks of its process, and
+// until fcfs_resume_cores() none runs another. For checkpoints.
+void fcfs_pause_cores();
+void fcfs_resume_cores();
 
 #endif // FCFS_H
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Process.h"
+
+// Binary min-heap of process table indices ordered by key, ties broken by insertion order. A position
+// map from process index to heap slot lets a queued process be found and re-keyed (decrease-key or
+// increase-key) in O(log n) without a search. Not thread safe.
+class IndexedHeap {
+public:
+    // Queues index with key; a process that is already queued is re-keyed instead.
+    void push(ProcessIndex index, uint64_t key) {
+        if (contains(index)) {
+            update(index, key);
+            return;
+        }
+        if (static_cast<size_t>(index) >= position_.size()) position_.resize(static_cast<size_t>(index) + 1, NOT_QUEUED);
+        heap_.push_back({key, next_sequence_++, index});
+        position_[index] = static_cast<int32_t>(heap_.size() - 1);
+        sift_up(heap_.size() - 1);
+    }
+
+    // Removes and returns the index with the smallest key. The heap must not be empty.
+    ProcessIndex pop() {
+        ProcessIndex index = heap_.front().index;
+        position_[index] = NOT_QUEUED;
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            place(0, last);
+            sift_down(0);
+        }
+        return index;
+    }
+
+    ProcessIndex top() const { return heap_.front().index; }
+    uint64_t top_key() const { return heap_.front().key; }
+
+    bool contains(ProcessIndex index) const {
+        return static_cast<size_t>(index) < position_.size() && position_[index] != NOT_QUEUED;
+    }
+
+    // Changes the key of a queued process and restores heap order in O(log n).
+    void update(ProcessIndex index, uint64_t key) {
+        size_t slot = static_cast<size_t>(position_[index]);
+        uint64_t old_key = heap_[slot].key;
+        heap_[slot].key = key;
+        if (key < old_key) sift_up(slot);
+        else sift_down(slot);
+    }
+
+    // Calls fn(index, key) for every queued process in heap order, not key order.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& entry : heap_) fn(entry.index, entry.key);
+    }
+
+    size_t size() const { return heap_.size(); }
+    bool empty() const { return heap_.empty(); }
+    void clear() {
+        for (const auto& entry : heap_) position_[entry.index] = NOT_QUEUED;
+        heap_.clear();
+    }
+
+private:
+    static constexpr int32_t NOT_QUEUED = -1;
+
+    struct Entry {
+        uint64_t key;
+        uint64_t sequence; // Insertion order, so equal keys leave in FIFO order
+        ProcessIndex index;
+    };
+
+    static bool before(const Entry& a, const Entry& b) {
+        return a.key != b.key ? a.key < b.key : a.sequence < b.sequence;
+    }
+
+    void place(size_t slot, const Entry& entry) {
+        heap_[slot] = entry;
+        position_[entry.index] = static_cast<int32_t>(slot);
+    }
+
+    void sift_up(size_t slot) {
+        Entry entry = heap_[slot];
+        while (slot > 0) {
+            size_t parent = (slot - 1) / 2;
+            if (!before(entry, heap_[parent])) break;
+            place(slot, heap_[parent]);
+            slot = parent;
+        }
+        place(slot, entry);
+    }
+
+    void sift_down(size_t slot) {
+        Entry entry = heap_[slot];
+        size_t count = heap_.size();
+        for (;;) {
+            size_t child = 2 * slot + 1;
+            if (child >= count) break;
+            if (child + 1 < count && before(heap_[child + 1], heap_[child])) child++;
+            if (!before(heap_[child], entry)) break;
+            place(slot, heap_[child]);
+            slot = child;
+        }
+        place(slot, entry);
+    }
+
+    std::vector<Entry> heap_;
+    std::vector<int32_t> position_; // Process index -> slot in heap_, NOT_QUEUED when absent
+    uint64_t next_sequence_ = 0;
+};
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,76 @@
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// --- Compiled Form of Process::commands ---
+// Every opcode except FOR_BEGIN / FOR_END costs one CPU tick; loop control is free so that
+// a FOR loop costs exactly what its unrolled body would. Superinstructions are only produced by
+// optimize_program and cost one tick per instruction they stand for.
+enum class Opcode : uint8_t {
+    PRINT,
+    DECLARE,
+    ADD,
+    SUBTRACT,
+    SLEEP,
+    READ,
+    WRITE,
+    FOR_BEGIN,
+    FOR_END,
+    WRITE_READ, // WRITE followed by a READ of the same address; the READ stays at pc + 1
+    OPCODE_COUNT
+};
+
+const char* opcode_name(Opcode op);
+
+// FOR loops may nest this deep; deeper programs are rejected at load time.
+constexpr int MAX_FOR_DEPTH = 3;
+// A program may name at most this many variables; further names read as 0 and ignore writes.
+constexpr int MAX_VARIABLES = 32;
+// Variable values live in a symbol table at the start of each process's memory, one uint16 per slot.
+constexpr int SYMBOL_TABLE_BYTES = MAX_VARIABLES * sizeof(uint16_t);
+
+// Either an immediate uint16 or a variable, resolved to its symbol table slot when the program is loaded.
+struct Operand {
+    bool is_variable = false;
+    uint16_t value = 0;
+    int slot = -1;
+};
+
+// One piece of a PRINT message: literal text or the value of a variable slot.
+struct PrintPart {
+    bool is_variable = false;
+    int slot = -1;
+    std::string text;
+};
+
+struct Instruction {
+    Opcode op = Opcode::PRINT;
+    Operand dst;          // DECLARE / ADD / SUBTRACT / READ / WRITE_READ target variable
+    Operand lhs;          // DECLARE value, ADD / SUBTRACT first term, SLEEP ticks, FOR count, WRITE / WRITE_READ value
+    Operand rhs;          // ADD / SUBTRACT second term
+    int address = 0;      // READ / WRITE / WRITE_READ logical address
+    int jump = -1;        // FOR_BEGIN: pc after the loop, FOR_END: pc of the loop body
+    int message = -1;     // PRINT: index into ProgramImage::messages, -1 for the default greeting
+};
+
+// Source and compiled form of one program. Images are interned and shared by every process running
+// the same commands, so they are never modified once built; per-process state stays in Process.
+struct ProgramImage {
+    std::vector<std::string> source;         // Empty for generated images; see program_source()
+    std::vector<Instruction> code;
+    std::vector<std::string> variable_names; // slot -> name
+    std::vector<std::vector<PrintPart>> messages; // PRINT arguments, indexed by Instruction::message
+    std::string error;                       // Set if source failed to compile; code is then empty
+    bool optimized = false;                  // code was rewritten by optimize_program
+};
+
+// Runtime state of one active FOR loop.
+struct LoopFrame {
+    int body_pc = 0;
+    uint32_t remaining = 0;
+};
+
+#endif // INSTRUCTION_H
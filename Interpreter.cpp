@@ -0,0 +1,1192 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "Interpreter.h"
+#include "global.h"
+#include "config.h"
+
+// GCC and Clang support labels as values; everything else falls back to switch dispatch.
+#if defined(__GNUC__) || defined(__clang__)
+#define CSOPESY_COMPUTED_GOTO 1
+#endif
+
+// Lockstep execution uses SSE2 where the target guarantees it (every x86-64 target does) and plain loops elsewhere.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSOPESY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+const char* opcode_name(Opcode op) {
+    switch (op) {
+        case Opcode::PRINT:     return "PRINT";
+        case Opcode::DECLARE:   return "DECLARE";
+        case Opcode::ADD:       return "ADD";
+        case Opcode::SUBTRACT:  return "SUBTRACT";
+        case Opcode::SLEEP:     return "SLEEP";
+        case Opcode::READ:      return "READ";
+        case Opcode::WRITE:     return "WRITE";
+        case Opcode::FOR_BEGIN: return "FOR";
+        case Opcode::FOR_END:   return "END FOR";
+        case Opcode::WRITE_READ: return "WRITE+READ";
+        default:                return "?";
+    }
+}
+
+// --- File-local helpers ---
+namespace {
+
+std::string trim(const std::string& s) {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(start, end - start + 1);
+}
+
+// Splits on any of the separator characters outside quotes, brackets and parentheses.
+std::vector<std::string> split_top_level(const std::string& text, const char* separators) {
+    std::vector<std::string> parts;
+    std::string current;
+    int depth = 0;
+    bool in_quotes = false;
+    for (char c : text) {
+        if (c == '"') in_quotes = !in_quotes;
+        if (!in_quotes) {
+            if (c == '[' || c == '(') depth++;
+            if (c == ']' || c == ')') depth--;
+            if (depth == 0 && std::strchr(separators, c)) {
+                std::string part = trim(current);
+                if (!part.empty()) parts.push_back(part);
+                current.clear();
+                continue;
+            }
+        }
+        current += c;
+    }
+    std::string part = trim(current);
+    if (!part.empty()) parts.push_back(part);
+    return parts;
+}
+
+bool is_identifier(const std::string& s) {
+    if (s.empty() || !(std::isalpha(static_cast<unsigned char>(s[0])) || s[0] == '_')) return false;
+    return std::all_of(s.begin(), s.end(), [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+}
+
+bool parse_number(const std::string& s, long long& value) {
+    // Identifiers are parsed far more often than numbers, so reject them without throwing.
+    if (s.empty() || !(std::isdigit(static_cast<unsigned char>(s[0])) || s[0] == '-' || s[0] == '+')) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtoll(s.c_str(), &end, 0); // 0x prefix selects hex
+    return errno == 0 && end == s.c_str() + s.size();
+}
+
+// Slot of name in the symbol table, adding it if there is room. Names past MAX_VARIABLES get
+// slot -1: they read as 0 and writes to them are dropped.
+int slot_for(std::vector<std::string>& symbols, const std::string& name) {
+    auto it = std::find(symbols.begin(), symbols.end(), name);
+    if (it != symbols.end()) return static_cast<int>(it - symbols.begin());
+    if (symbols.size() >= MAX_VARIABLES) return -1;
+    symbols.push_back(name);
+    return static_cast<int>(symbols.size() - 1);
+}
+
+// Immediates saturate to the uint16 range, matching the arithmetic.
+bool parse_operand(const std::string& s, Operand& operand, std::vector<std::string>& symbols) {
+    long long value;
+    if (parse_number(s, value)) {
+        operand.is_variable = false;
+        operand.value = static_cast<uint16_t>(std::clamp(value, 0LL, 65535LL));
+        return true;
+    }
+    if (!is_identifier(s)) return false;
+    operand.is_variable = true;
+    operand.slot = slot_for(symbols, s);
+    return true;
+}
+
+bool parse_variable(const std::string& s, Operand& operand, std::vector<std::string>& symbols) {
+    return is_identifier(s) && parse_operand(s, operand, symbols);
+}
+
+bool parse_address(const std::string& s, int& address) {
+    long long value;
+    if (!parse_number(s, value) || value < 0 || value > INT_MAX) return false;
+    address = static_cast<int>(value);
+    return true;
+}
+
+// PRINT("text" + var + "more"); an empty argument list prints the default greeting.
+bool parse_print(const std::string& args, std::vector<PrintPart>& message, std::vector<std::string>& symbols) {
+    for (const auto& term : split_top_level(args, "+")) {
+        PrintPart part;
+        if (term.size() >= 2 && term.front() == '"' && term.back() == '"') {
+            part.text = term.substr(1, term.size() - 2);
+        } else if (is_identifier(term)) {
+            part.is_variable = true;
+            part.slot = slot_for(symbols, term);
+        } else {
+            return false;
+        }
+        message.push_back(part);
+    }
+    return true;
+}
+
+bool compile_statements(const std::vector<std::string>& statements, int depth, ProgramImage& image);
+
+bool compile_statement(const std::string& statement, int depth, ProgramImage& image) {
+    std::vector<Instruction>& program = image.code;
+    std::vector<std::string>& symbols = image.variable_names;
+    std::string& error = image.error;
+    // Opcode is the leading word; the arguments may be wrapped in parentheses.
+    size_t word_end = 0;
+    while (word_end < statement.size() && std::isalpha(static_cast<unsigned char>(statement[word_end]))) word_end++;
+    std::string word = statement.substr(0, word_end);
+    std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) { return std::toupper(c); });
+    std::string rest = trim(statement.substr(word_end));
+    if (rest.size() >= 2 && rest.front() == '(' && rest.back() == ')') {
+        rest = trim(rest.substr(1, rest.size() - 2));
+    }
+    std::vector<std::string> args = split_top_level(rest, ", \t");
+
+    Instruction ins;
+    bool ok = false;
+    if (word == "PRINT") {
+        ins.op = Opcode::PRINT;
+        std::vector<PrintPart> message;
+        ok = parse_print(rest, message, symbols);
+        if (ok && !message.empty()) {
+            ins.message = static_cast<int>(image.messages.size());
+            image.messages.push_back(std::move(message));
+        }
+    } else if (word == "DECLARE") {
+        ins.op = Opcode::DECLARE;
+        ok = (args.size() == 1 || args.size() == 2) && parse_variable(args[0], ins.dst, symbols) &&
+             (args.size() == 1 || parse_operand(args[1], ins.lhs, symbols));
+    } else if (word == "ADD" || word == "SUBTRACT") {
+        ins.op = word == "ADD" ? Opcode::ADD : Opcode::SUBTRACT;
+        ok = args.size() == 3 && parse_variable(args[0], ins.dst, symbols) &&
+             parse_operand(args[1], ins.lhs, symbols) && parse_operand(args[2], ins.rhs, symbols);
+    } else if (word == "SLEEP") {
+        ins.op = Opcode::SLEEP;
+        ok = args.size() == 1 && parse_operand(args[0], ins.lhs, symbols);
+    } else if (word == "READ") {
+        // READ var addr, or the legacy "read addr" that discards the value.
+        ins.op = Opcode::READ;
+        if (args.size() == 1) {
+            ok = parse_address(args[0], ins.address);
+        } else {
+            ok = args.size() == 2 && parse_variable(args[0], ins.dst, symbols) && parse_address(args[1], ins.address);
+        }
+    } else if (word == "WRITE") {
+        ins.op = Opcode::WRITE;
+        ok = args.size() == 2 && parse_address(args[0], ins.address) && parse_operand(args[1], ins.lhs, symbols);
+    } else if (word == "FOR") {
+        if (args.size() != 2 || args[0].size() < 2 || args[0].front() != '[' || args[0].back() != ']') {
+            error = "expected FOR([instructions], repeats): " + statement;
+            return false;
+        }
+        if (depth >= MAX_FOR_DEPTH) {
+            error = "FOR loops nest deeper than " + std::to_string(MAX_FOR_DEPTH) + ": " + statement;
+            return false;
+        }
+        Instruction begin;
+        begin.op = Opcode::FOR_BEGIN;
+        if (!parse_operand(args[1], begin.lhs, symbols)) {
+            error = "bad FOR repeat count: " + statement;
+            return false;
+        }
+        int begin_pc = static_cast<int>(program.size());
+        program.push_back(begin);
+        std::vector<std::string> body = split_statements(args[0].substr(1, args[0].size() - 2));
+        if (!compile_statements(body, depth + 1, image)) return false;
+        if (program.size() == static_cast<size_t>(begin_pc + 1)) {
+            program.pop_back(); // Empty body: nothing to run
+            return true;
+        }
+        Instruction end;
+        end.op = Opcode::FOR_END;
+        end.jump = begin_pc + 1;
+        program.push_back(end);
+        program[begin_pc].jump = static_cast<int>(program.size());
+        return true;
+    } else {
+        error = "unknown instruction: " + statement;
+        return false;
+    }
+
+    if (!ok) {
+        error = "bad arguments: " + statement;
+        return false;
+    }
+    program.push_back(ins);
+    return true;
+}
+
+bool compile_statements(const std::vector<std::string>& statements, int depth, ProgramImage& image) {
+    for (const auto& statement : statements) {
+        if (!compile_statement(statement, depth, image)) return false;
+    }
+    return true;
+}
+
+inline uint16_t saturating_add(uint16_t a, uint16_t b) {
+    uint32_t sum = static_cast<uint32_t>(a) + b;
+    return static_cast<uint16_t>(sum > 65535 ? 65535 : sum);
+}
+
+inline uint16_t saturating_sub(uint16_t a, uint16_t b) {
+    return static_cast<uint16_t>(a > b ? a - b : 0);
+}
+
+// Loop control costs no ticks, so it still runs once the tick budget is spent. A program whose
+// last ticked instruction ends a loop then finishes in the same call whether or not the loop was
+// unrolled, and a quantum never ends on a pc that only leads to more loop control.
+inline bool is_loop_control(Opcode op) {
+    return op == Opcode::FOR_BEGIN || op == Opcode::FOR_END;
+}
+
+// Moves the cache-miss ticks the last instruction ran up onto the tick count, so misses use up
+// the quantum like instructions do.
+inline void charge_stalls(Process& process, int& ticks) {
+    if (process.stall_ticks == 0) return;
+    ticks += process.stall_ticks;
+    process.stall_ticks = 0;
+}
+
+// --- Memory ---
+// Reads or writes the uint16 at address. Returns false on a page fault or access violation;
+// the caller tells them apart through mem_data.terminated_by_error.
+bool access_u16(Process& process, int address, bool is_write, uint16_t& value) {
+    if (address < 0 || address + 1 >= static_cast<long long>(process.mem_data.memory_size_bytes)) {
+        process.mem_data.terminated_by_error = true;
+        process.cold->termination_reason = "Memory access violation at address " + std::to_string(address);
+        return false;
+    }
+    char* low = memory_manager->access_memory(process, address, is_write);
+    if (!low) return false;
+    char* high = low + 1;
+    if ((address + 1) % MEM_PER_FRAME == 0) {
+        // The value straddles two pages.
+        high = memory_manager->access_memory(process, address + 1, is_write);
+        if (!high) return false;
+    }
+    if (g_core_caches.enabled()) {
+        int core = process_core(g_process_table, process);
+        process.stall_ticks += g_core_caches.access(core, process.id, address);
+        if (((address + 1) & (g_core_caches.config().line_bytes - 1)) == 0) {
+            process.stall_ticks += g_core_caches.access(core, process.id, address + 1);
+        }
+    }
+    if (is_write) {
+        *low = static_cast<char>(value & 0xFF);
+        *high = static_cast<char>(value >> 8);
+    } else {
+        value = static_cast<uint16_t>(static_cast<unsigned char>(*low) | (static_cast<unsigned char>(*high) << 8));
+    }
+    return true;
+}
+
+// --- Variables ---
+// Slot i lives at address 2 * i of the process's own memory, so variables page like any other data.
+// A load or store returns false on a page fault, like access_u16.
+inline bool load_operand(Process& process, const Operand& operand, uint16_t& value) {
+    if (!operand.is_variable) {
+        value = operand.value;
+        return true;
+    }
+    if (operand.slot < 0) {
+        value = 0;
+        return true;
+    }
+    return access_u16(process, operand.slot * static_cast<int>(sizeof(uint16_t)), false, value);
+}
+
+inline bool store_slot(Process& process, int slot, uint16_t value) {
+    if (slot < 0) return true;
+    return access_u16(process, slot * static_cast<int>(sizeof(uint16_t)), true, value);
+}
+
+bool format_message(Process& process, int message, std::string& text) {
+    if (message < 0) {
+        text = "Hello world from " + process.cold->processName + "!";
+        return true;
+    }
+    text.clear();
+    for (const auto& part : process.image->messages[message]) {
+        if (!part.is_variable) {
+            text += part.text;
+            continue;
+        }
+        Operand operand;
+        operand.is_variable = true;
+        operand.slot = part.slot;
+        uint16_t value;
+        if (!load_operand(process, operand, value)) return false;
+        text += std::to_string(value);
+    }
+    return true;
+}
+
+} // end anonymous namespace
+
+std::vector<std::string> split_statements(const std::string& block) {
+    return split_top_level(block, ";");
+}
+
+bool compile_program(const std::vector<std::string>& commands, ProgramImage& image) {
+    image.code.clear();
+    image.variable_names.clear();
+    image.messages.clear();
+    image.error.clear();
+    image.optimized = false;
+    std::vector<std::string> statements;
+    for (const auto& command : commands) {
+        for (auto& statement : split_statements(command)) statements.push_back(std::move(statement));
+    }
+    if (compile_statements(statements, 0, image)) return true;
+    image.code.clear();
+    return false;
+}
+
+// --- Optimizer ---
+namespace {
+
+// FOR loops with an immediate repeat count and no nested loop that unroll to at most this many
+// instructions are replaced by their unrolled body.
+const size_t FLATTEN_MAX_INSTRUCTIONS = 16;
+
+// Appends code[pc, end) to out with small loops unrolled, rebasing jump targets to out's indices.
+// Returns true if any loop was unrolled.
+bool flatten_loops(const std::vector<Instruction>& code, int pc, int end, std::vector<Instruction>& out) {
+    bool flattened = false;
+    while (pc < end) {
+        const Instruction& ins = code[pc];
+        if (ins.op != Opcode::FOR_BEGIN) {
+            out.push_back(ins);
+            pc++;
+            continue;
+        }
+        // Emit the loop as is, then unroll it in place if it qualifies.
+        const size_t begin_pc = out.size();
+        out.push_back(ins);
+        flattened |= flatten_loops(code, pc + 1, ins.jump - 1, out);
+        const size_t body_size = out.size() - begin_pc - 1;
+        bool has_loop = std::any_of(out.begin() + begin_pc + 1, out.end(), [](const Instruction& i) { return i.op == Opcode::FOR_BEGIN; });
+        if (!ins.lhs.is_variable && !has_loop && body_size * ins.lhs.value <= FLATTEN_MAX_INSTRUCTIONS) {
+            // The body has no jumps left, so it can move and repeat freely.
+            out.erase(out.begin() + begin_pc);
+            if (ins.lhs.value == 0) out.resize(begin_pc);
+            for (int repeat = 1; repeat < ins.lhs.value; ++repeat) {
+                for (size_t i = 0; i < body_size; ++i) {
+                    Instruction copy = out[begin_pc + i];
+                    out.push_back(copy);
+                }
+            }
+            flattened = true;
+        } else {
+            Instruction end_ins = code[ins.jump - 1];
+            end_ins.jump = static_cast<int>(begin_pc) + 1;
+            out.push_back(end_ins);
+            out[begin_pc].jump = static_cast<int>(out.size());
+        }
+        pc = ins.jump;
+    }
+    return flattened;
+}
+
+// Slot values known at the current instruction: set by DECLARE / ADD / SUBTRACT with known operands,
+// forgotten at loop boundaries where control flow joins.
+struct KnownSlots {
+    bool known[MAX_VARIABLES] = {};
+    uint16_t value[MAX_VARIABLES] = {};
+
+    void set(int slot, bool is_known, uint16_t slot_value) {
+        if (slot < 0) return;
+        known[slot] = is_known;
+        value[slot] = slot_value;
+    }
+    void forget_all() { std::fill(std::begin(known), std::end(known), false); }
+    // A WRITE into the symbol table changes the slots it overlaps.
+    void forget_address(int address) {
+        for (int byte = address; byte <= address + 1; ++byte) {
+            int slot = byte / static_cast<int>(sizeof(uint16_t));
+            if (byte >= 0 && slot < MAX_VARIABLES) known[slot] = false;
+        }
+    }
+};
+
+// Replaces a variable operand by its value when it is known. Returns true if the operand is now immediate.
+bool fold_operand(Operand& operand, const KnownSlots& slots) {
+    if (!operand.is_variable) return true;
+    if (operand.slot >= 0 && !slots.known[operand.slot]) return false;
+    uint16_t value = operand.slot >= 0 ? slots.value[operand.slot] : 0; // Unnamed variables read as 0
+    operand = Operand();
+    operand.value = value;
+    return true;
+}
+
+// Folds known operands in place. ADD / SUBTRACT of two known values become a DECLARE of the result,
+// and PRINT messages get known values spelled out as text. Messages are renumbered in code order.
+// Returns true if a FOR count became immediate, which may let flatten_loops unroll the loop.
+bool fold_constants(ProgramImage& image) {
+    KnownSlots slots;
+    std::vector<std::vector<PrintPart>> messages;
+    messages.reserve(image.messages.size());
+    // Unrolled loops share messages; the last use of each takes it without a copy.
+    std::vector<int> message_uses(image.messages.size(), 0);
+    for (const Instruction& ins : image.code) {
+        if (ins.op == Opcode::PRINT && ins.message >= 0) message_uses[ins.message]++;
+    }
+    bool folded_loop_count = false;
+    for (Instruction& ins : image.code) {
+        switch (ins.op) {
+            case Opcode::PRINT: {
+                if (ins.message < 0) break;
+                std::vector<PrintPart>& source = image.messages[ins.message];
+                bool foldable = std::any_of(source.begin(), source.end(), [&](const PrintPart& part) {
+                    return part.is_variable && (part.slot < 0 || slots.known[part.slot]);
+                });
+                bool last_use = --message_uses[ins.message] == 0;
+                if (!foldable) {
+                    ins.message = static_cast<int>(messages.size());
+                    messages.push_back(last_use ? std::move(source) : source);
+                    break;
+                }
+                std::vector<PrintPart> message;
+                for (PrintPart part : source) {
+                    if (part.is_variable && (part.slot < 0 || slots.known[part.slot])) {
+                        part.text = std::to_string(part.slot >= 0 ? slots.value[part.slot] : 0);
+                        part.is_variable = false;
+                        part.slot = -1;
+                    }
+                    if (!part.is_variable && !message.empty() && !message.back().is_variable) {
+                        message.back().text += part.text;
+                    } else {
+                        message.push_back(std::move(part));
+                    }
+                }
+                ins.message = static_cast<int>(messages.size());
+                messages.push_back(std::move(message));
+                break;
+            }
+            case Opcode::DECLARE:
+                slots.set(ins.dst.slot, fold_operand(ins.lhs, slots), ins.lhs.value);
+                break;
+            case Opcode::ADD:
+            case Opcode::SUBTRACT: {
+                bool lhs_known = fold_operand(ins.lhs, slots);
+                bool rhs_known = fold_operand(ins.rhs, slots);
+                if (!lhs_known || !rhs_known) {
+                    slots.set(ins.dst.slot, false, 0);
+                    break;
+                }
+                ins.lhs.value = ins.op == Opcode::ADD ? saturating_add(ins.lhs.value, ins.rhs.value)
+                                                      : saturating_sub(ins.lhs.value, ins.rhs.value);
+                ins.op = Opcode::DECLARE;
+                ins.rhs = Operand();
+                slots.set(ins.dst.slot, true, ins.lhs.value);
+                break;
+            }
+            case Opcode::SLEEP:
+                fold_operand(ins.lhs, slots);
+                break;
+            case Opcode::READ:
+                if (ins.dst.is_variable) slots.set(ins.dst.slot, false, 0);
+                break;
+            case Opcode::WRITE:
+            case Opcode::WRITE_READ:
+                fold_operand(ins.lhs, slots);
+                slots.forget_address(ins.address);
+                if (ins.op == Opcode::WRITE_READ && ins.dst.is_variable) slots.set(ins.dst.slot, false, 0);
+                break;
+            case Opcode::FOR_BEGIN:
+                // The count is read once, before the loop.
+                if (ins.lhs.is_variable && fold_operand(ins.lhs, slots)) folded_loop_count = true;
+                slots.forget_all();
+                break;
+            case Opcode::FOR_END:
+                slots.forget_all();
+                break;
+            default:
+                break;
+        }
+    }
+    image.messages = std::move(messages);
+    return folded_loop_count;
+}
+
+// WRITE then READ of the same address: the READ gets the value just written.
+void fuse_instructions(std::vector<Instruction>& code) {
+    for (size_t pc = 0; pc + 1 < code.size(); ++pc) {
+        Instruction& write = code[pc];
+        const Instruction& read = code[pc + 1];
+        if (write.op == Opcode::WRITE && read.op == Opcode::READ && read.address == write.address) {
+            write.op = Opcode::WRITE_READ;
+            write.dst = read.dst;
+        }
+    }
+}
+
+} // end anonymous namespace
+
+void optimize_program(ProgramImage& image) {
+    if (!image.error.empty()) return;
+    // Unrolling makes more values known, and folding can make a loop count immediate, so repeat
+    // until folding gives flatten_loops nothing new.
+    do {
+        if (std::none_of(image.code.begin(), image.code.end(), [](const Instruction& ins) { return ins.op == Opcode::FOR_BEGIN; })) continue;
+        std::vector<Instruction> code;
+        code.reserve(image.code.size() + FLATTEN_MAX_INSTRUCTIONS);
+        flatten_loops(image.code, 0, static_cast<int>(image.code.size()), code);
+        image.code = std::move(code);
+    } while (fold_constants(image));
+    fuse_instructions(image.code);
+    image.optimized = true;
+}
+
+bool optimizer_keeps_ticks() {
+    if (g_core_caches.enabled()) return false;
+    return !memory_manager || !memory_manager->numa_topology().enabled() || NUMA_REMOTE_PENALTY == 0;
+}
+
+// --- Program Interning ---
+namespace {
+
+std::mutex intern_mutex;
+std::map<std::vector<std::string>, std::weak_ptr<const ProgramImage>> intern_table;
+// Expired entries are swept whenever the table grows past this size.
+size_t intern_sweep_threshold = 64;
+
+} // end anonymous namespace
+
+std::shared_ptr<const ProgramImage> build_program(std::vector<std::string> commands, bool optimize) {
+    auto image = std::make_shared<ProgramImage>();
+    if (compile_program(commands, *image) && optimize) optimize_program(*image);
+    image->source = std::move(commands);
+    return image;
+}
+
+std::shared_ptr<const ProgramImage> intern_program(const std::vector<std::string>& commands, bool optimize) {
+    std::lock_guard<std::mutex> lock(intern_mutex);
+    auto& entry = intern_table[commands];
+    // An image built while stalls were off (or on) is replaced, not reused, once that changes.
+    auto image = entry.lock();
+    if (image && (image->optimized == optimize || !image->error.empty())) return image;
+
+    image = build_program(commands, optimize);
+    entry = image;
+
+    if (intern_table.size() > intern_sweep_threshold) {
+        for (auto it = intern_table.begin(); it != intern_table.end();) {
+            it = it->second.expired() ? intern_table.erase(it) : std::next(it);
+        }
+        intern_sweep_threshold = std::max<size_t>(64, intern_table.size() * 2);
+    }
+    return image;
+}
+
+size_t interned_program_count() {
+    std::lock_guard<std::mutex> lock(intern_mutex);
+    return std::count_if(intern_table.begin(), intern_table.end(), [](const auto& entry) { return !entry.second.expired(); });
+}
+
+bool load_program(Process& process, std::shared_ptr<const ProgramImage> image) {
+    process.image = std::move(image);
+    if (process.image && !process.image->error.empty()) {
+        process.mem_data.terminated_by_error = true;
+        process.cold->termination_reason = "Invalid program: " + process.image->error;
+        return false;
+    }
+    return true;
+}
+
+// --- Disassembly ---
+namespace {
+
+std::string operand_text(const Operand& operand, const ProgramImage& image) {
+    if (!operand.is_variable) return std::to_string(operand.value);
+    return operand.slot >= 0 ? image.variable_names[operand.slot] : "_";
+}
+
+std::string address_text(int address) {
+    std::ostringstream oss;
+    oss << "0x" << std::hex << std::uppercase << address;
+    return oss.str();
+}
+
+// Disassembles code[pc, end) into statements, returning FOR bodies as single nested statements.
+std::vector<std::string> disassemble(const ProgramImage& image, int pc, int end) {
+    std::vector<std::string> statements;
+    while (pc < end) {
+        const Instruction& ins = image.code[pc];
+        std::string text;
+        switch (ins.op) {
+            case Opcode::PRINT:
+                text = "PRINT";
+                if (ins.message >= 0) {
+                    const std::vector<PrintPart>& message = image.messages[ins.message];
+                    text += "(";
+                    for (size_t i = 0; i < message.size(); ++i) {
+                        const PrintPart& part = message[i];
+                        if (i) text += " + ";
+                        text += part.is_variable ? (part.slot >= 0 ? image.variable_names[part.slot] : "_") : "\"" + part.text + "\"";
+                    }
+                    text += ")";
+                }
+                break;
+            case Opcode::DECLARE:
+                text = "DECLARE " + operand_text(ins.dst, image) + " " + operand_text(ins.lhs, image);
+                break;
+            case Opcode::ADD:
+            case Opcode::SUBTRACT:
+                text = std::string(opcode_name(ins.op)) + " " + operand_text(ins.dst, image) + " " +
+                       operand_text(ins.lhs, image) + " " + operand_text(ins.rhs, image);
+                break;
+            case Opcode::SLEEP:
+                text = "SLEEP " + operand_text(ins.lhs, image);
+                break;
+            case Opcode::READ:
+                text = "READ " + (ins.dst.is_variable ? operand_text(ins.dst, image) + " " : "") + address_text(ins.address);
+                break;
+            case Opcode::WRITE:
+            case Opcode::WRITE_READ: // The READ half is disassembled at pc + 1
+                text = "WRITE " + address_text(ins.address) + " " + operand_text(ins.lhs, image);
+                break;
+            case Opcode::FOR_BEGIN: {
+                // The body ends at the FOR_END just before the jump target.
+                std::vector<std::string> body = disassemble(image, pc + 1, ins.jump - 1);
+                text = "FOR([";
+                for (size_t i = 0; i < body.size(); ++i) text += (i ? "; " : "") + body[i];
+                text += "], " + operand_text(ins.lhs, image) + ")";
+                statements.push_back(std::move(text));
+                pc = ins.jump;
+                continue;
+            }
+            default:
+                break;
+        }
+        statements.push_back(std::move(text));
+        pc++;
+    }
+    return statements;
+}
+
+} // end anonymous namespace
+
+std::vector<std::string> program_source(const ProgramImage& image) {
+    if (!image.source.empty() || image.code.empty()) return image.source;
+    return disassemble(image, 0, static_cast<int>(image.code.size()));
+}
+
+size_t program_length(const Process& process) {
+    return process.image ? process.image->code.size() : 0;
+}
+
+uint64_t program_ticks(const ProgramImage& image) {
+    uint64_t ticks = 0;
+    uint64_t repeats[MAX_FOR_DEPTH + 1] = {1};
+    int depth = 0;
+    for (const Instruction& ins : image.code) {
+        if (ins.op == Opcode::FOR_BEGIN) {
+            uint64_t count = ins.lhs.is_variable ? 1 : ins.lhs.value;
+            if (depth < MAX_FOR_DEPTH) {
+                repeats[depth + 1] = repeats[depth] * count;
+                depth++;
+            }
+        } else if (ins.op == Opcode::FOR_END) {
+            if (depth > 0) depth--;
+        } else {
+            ticks += repeats[depth];
+        }
+    }
+    return ticks;
+}
+
+ExecStatus interpreter_run(Process& process, int max_ticks, int& ticks_used) {
+    ticks_used = 0;
+    if (process.mem_data.terminated_by_error) return ExecStatus::TERMINATED;
+    if (!process.image) return ExecStatus::FINISHED;
+
+    // Sleep left over (e.g. restored from a checkpoint) sends the process straight back to sleep;
+    // the scheduler clears sleep_ticks_remaining when it wakes the process.
+    if (process.sleep_ticks_remaining > 0) return ExecStatus::SLEEPING;
+
+    // A lockstep group left these writes behind when it could not store them; the process stays
+    // blocked until they are in memory.
+    auto& pending = process.cold->pending_stores;
+    while (!pending.empty()) {
+        if (!store_slot(process, pending.back().first, pending.back().second)) {
+            return process.mem_data.terminated_by_error ? ExecStatus::TERMINATED : ExecStatus::BLOCKED;
+        }
+        pending.pop_back();
+    }
+
+    int ticks = 0;
+
+    const Instruction* const code = process.image->code.data();
+    const int code_size = static_cast<int>(process.image->code.size());
+    int pc = process.program_counter;
+    const Instruction* ins = nullptr;
+    // PRINT's text. A handler leaves its block through a computed goto, which runs no destructors, so
+    // nothing that owns memory may be declared inside one.
+    std::string message_text;
+
+#ifdef CSOPESY_COMPUTED_GOTO
+    // Indexed by Opcode; keep in declaration order.
+    static void* const dispatch_table[] = {
+        &&op_print, &&op_declare, &&op_add, &&op_subtract, &&op_sleep,
+        &&op_read, &&op_write, &&op_for_begin, &&op_for_end, &&op_write_read
+    };
+    static_assert(sizeof(dispatch_table) / sizeof(dispatch_table[0]) == static_cast<size_t>(Opcode::OPCODE_COUNT));
+#define DISPATCH() do { charge_stalls(process, ticks); if (pc >= code_size) goto finished; ins = &code[pc]; \
+                        if (ticks >= max_ticks && !is_loop_control(ins->op)) goto out_of_ticks; \
+                        goto *dispatch_table[static_cast<int>(ins->op)]; } while (0)
+#define HANDLER(label, opcode) label
+#else
+#define DISPATCH() do { charge_stalls(process, ticks); if (pc >= code_size) goto finished; ins = &code[pc]; \
+                        if (ticks >= max_ticks && !is_loop_control(ins->op)) goto out_of_ticks; \
+                        goto dispatch_switch; } while (0)
+#define HANDLER(label, opcode) case Opcode::opcode
+#endif
+
+    DISPATCH();
+
+#ifndef CSOPESY_COMPUTED_GOTO
+dispatch_switch:
+    switch (ins->op) {
+#endif
+
+    HANDLER(op_print, PRINT): {
+        if (!format_message(process, ins->message, message_text)) goto memory_stall;
+        process_print_log(process).append(message_text, process_core(g_process_table, process), std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+    HANDLER(op_declare, DECLARE): {
+        uint16_t value;
+        if (!load_operand(process, ins->lhs, value) || !store_slot(process, ins->dst.slot, value)) goto memory_stall;
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+    HANDLER(op_add, ADD): {
+        // Operands are loaded before the store, so a fault anywhere leaves the instruction safe to retry.
+        uint16_t a, b;
+        if (!load_operand(process, ins->lhs, a) || !load_operand(process, ins->rhs, b) ||
+            !store_slot(process, ins->dst.slot, saturating_add(a, b))) goto memory_stall;
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+    HANDLER(op_subtract, SUBTRACT): {
+        uint16_t a, b;
+        if (!load_operand(process, ins->lhs, a) || !load_operand(process, ins->rhs, b) ||
+            !store_slot(process, ins->dst.slot, saturating_sub(a, b))) goto memory_stall;
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+    HANDLER(op_sleep, SLEEP): {
+        // SLEEP itself costs a tick; the sleep is spent off the core, so the quantum ends here.
+        uint16_t duration;
+        if (!load_operand(process, ins->lhs, duration)) goto memory_stall;
+        ++pc; ++ticks;
+        process.sleep_ticks_remaining = duration;
+        if (duration > 0) goto asleep;
+        DISPATCH();
+    }
+
+    HANDLER(op_read, READ): {
+        uint16_t value = 0;
+        if (!access_u16(process, ins->address, false, value)) goto memory_stall;
+        if (ins->dst.is_variable && !store_slot(process, ins->dst.slot, value)) goto memory_stall;
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+    HANDLER(op_write, WRITE): {
+        uint16_t value;
+        if (!load_operand(process, ins->lhs, value) || !access_u16(process, ins->address, true, value)) goto memory_stall;
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+    HANDLER(op_for_begin, FOR_BEGIN): {
+        uint16_t repeats;
+        if (!load_operand(process, ins->lhs, repeats)) goto memory_stall;
+        if (repeats == 0) {
+            pc = ins->jump;
+        } else {
+            process.loop_stack[process.loop_depth++] = {pc + 1, repeats};
+            ++pc;
+        }
+        DISPATCH();
+    }
+
+    HANDLER(op_for_end, FOR_END): {
+        LoopFrame& frame = process.loop_stack[process.loop_depth - 1];
+        if (--frame.remaining > 0) {
+            pc = frame.body_pc;
+        } else {
+            process.loop_depth--;
+            ++pc;
+        }
+        DISPATCH();
+    }
+
+    HANDLER(op_write_read, WRITE_READ): {
+        // The READ half reuses the written value instead of translating the same address again.
+        // If the budget ends or the store faults after the WRITE half, the READ at pc + 1 runs on its own.
+        uint16_t value;
+        if (!load_operand(process, ins->lhs, value) || !access_u16(process, ins->address, true, value)) goto memory_stall;
+        ++pc; ++ticks;
+        if (ticks >= max_ticks) goto out_of_ticks;
+        if (ins->dst.is_variable && !store_slot(process, ins->dst.slot, value)) goto memory_stall;
+        ++pc; ++ticks;
+        DISPATCH();
+    }
+
+#ifndef CSOPESY_COMPUTED_GOTO
+    default:
+        goto finished;
+    }
+#endif
+
+#undef DISPATCH
+#undef HANDLER
+
+out_of_ticks:
+    charge_stalls(process, ticks);
+    process.program_counter = pc;
+    ticks_used = ticks;
+    return ExecStatus::RUNNING;
+
+asleep:
+    charge_stalls(process, ticks);
+    process.program_counter = pc;
+    ticks_used = ticks;
+    return ExecStatus::SLEEPING;
+
+finished:
+    process.program_counter = pc;
+    ticks_used = ticks;
+    return ExecStatus::FINISHED;
+
+memory_stall:
+    charge_stalls(process, ticks);
+    process.program_counter = pc;
+    ticks_used = ticks;
+    return process.mem_data.terminated_by_error ? ExecStatus::TERMINATED : ExecStatus::BLOCKED;
+}
+
+// --- Lockstep Execution ---
+namespace {
+
+// Uint16 lanes per SSE2 register; SoA rows are padded to a multiple of this.
+constexpr size_t VECTOR_LANES = 8;
+
+// Processes can share one instruction stream if they agree on image, pc and loop state.
+bool same_position(const Process& a, const Process& b) {
+    if (a.image.get() != b.image.get() || a.program_counter != b.program_counter || a.loop_depth != b.loop_depth) return false;
+    for (int i = 0; i < a.loop_depth; ++i) {
+        if (a.loop_stack[i].body_pc != b.loop_stack[i].body_pc || a.loop_stack[i].remaining != b.loop_stack[i].remaining) return false;
+    }
+    return true;
+}
+
+bool position_less(const Process& a, const Process& b) {
+    if (a.image.get() != b.image.get()) return std::less<const ProgramImage*>()(a.image.get(), b.image.get());
+    if (a.program_counter != b.program_counter) return a.program_counter < b.program_counter;
+    if (a.loop_depth != b.loop_depth) return a.loop_depth < b.loop_depth;
+    for (int i = 0; i < a.loop_depth; ++i) {
+        if (a.loop_stack[i].body_pc != b.loop_stack[i].body_pc) return a.loop_stack[i].body_pc < b.loop_stack[i].body_pc;
+        if (a.loop_stack[i].remaining != b.loop_stack[i].remaining) return a.loop_stack[i].remaining < b.loop_stack[i].remaining;
+    }
+    return false;
+}
+
+// Variable slot rows of a group in structure-of-arrays form: rows[slot * stride + lane].
+// An operand is either a row or a constant broadcast to every lane (immediates, and slot -1 which reads 0).
+struct LaneOperand {
+    const uint16_t* row;
+    uint16_t constant;
+};
+
+LaneOperand lane_operand(const Operand& operand, const uint16_t* rows, size_t stride) {
+    if (operand.is_variable && operand.slot >= 0) return {rows + operand.slot * stride, 0};
+    return {nullptr, operand.is_variable ? uint16_t(0) : operand.value};
+}
+
+enum class LaneOp { COPY, ADD, SUBTRACT };
+
+// Where a group's shared instruction stream stands.
+struct ExecPoint {
+    int pc = 0;
+    int loop_depth = 0;
+    LoopFrame loop_stack[MAX_FOR_DEPTH];
+};
+
+#ifdef CSOPESY_SSE2
+inline __m128i load_lanes(const LaneOperand& operand, __m128i constant, size_t lane) {
+    return operand.row ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(operand.row + lane)) : constant;
+}
+#endif
+
+// dst = a (COPY), a + b or a - b for every lane, saturating like the scalar handlers.
+template <LaneOp op>
+void apply_lanes(uint16_t* dst, LaneOperand a, LaneOperand b, size_t stride) {
+#ifdef CSOPESY_SSE2
+    const __m128i a_constant = _mm_set1_epi16(static_cast<short>(a.constant));
+    const __m128i b_constant = _mm_set1_epi16(static_cast<short>(b.constant));
+    for (size_t lane = 0; lane < stride; lane += VECTOR_LANES) {
+        __m128i x = load_lanes(a, a_constant, lane);
+        if constexpr (op == LaneOp::ADD) x = _mm_adds_epu16(x, load_lanes(b, b_constant, lane));
+        if constexpr (op == LaneOp::SUBTRACT) x = _mm_subs_epu16(x, load_lanes(b, b_constant, lane));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + lane), x);
+    }
+#else
+    for (size_t lane = 0; lane < stride; ++lane) {
+        uint16_t x = a.row ? a.row[lane] : a.constant;
+        uint16_t y = b.row ? b.row[lane] : b.constant;
+        if constexpr (op == LaneOp::COPY) dst[lane] = x;
+        if constexpr (op == LaneOp::ADD) dst[lane] = saturating_add(x, y);
+        if constexpr (op == LaneOp::SUBTRACT) dst[lane] = saturating_sub(x, y);
+    }
+#endif
+}
+
+// Slot rows of one group. A row is copied in from every member's memory the first time the group
+// touches the slot, so a short run only pays for the variables it uses. A member that page faults
+// while a row is copied in leaves the group right there, exactly where interpreter_run would have
+// blocked; its column keeps being computed but is never stored. Written rows are stored back when a
+// member leaves or the group stops; a member whose store faults leaves too, as BLOCKED.
+class LaneRows {
+public:
+    explicit LaneRows(const std::vector<Process*>& lanes, size_t slot_count)
+        : lanes_(lanes), stride_((lanes.size() + VECTOR_LANES - 1) / VECTOR_LANES * VECTOR_LANES),
+          rows_(slot_count * stride_, 0), left_at_(lanes.size(), -1), remaining_(lanes.size()) {}
+
+    size_t stride() const { return stride_; }
+    const uint16_t* base() const { return rows_.data(); }
+    uint16_t* row(int slot) { return rows_.data() + slot * stride_; }
+    bool in_group(size_t lane) const { return left_at_[lane] < 0; }
+    size_t remaining() const { return remaining_; }
+    // Ticks the lane had spent when it left the group, -1 if it never left.
+    int left_at(size_t lane) const { return left_at_[lane]; }
+
+    // Copies the operand's row in. Returns false if any member faulted on it; those members have
+    // left the group and the instruction must be retried before it runs.
+    bool load(const Operand& operand, int ticks, const ExecPoint& point) {
+        if (!operand.is_variable || operand.slot < 0 || (loaded_ & (uint32_t(1) << operand.slot))) return true;
+        uint16_t* values = row(operand.slot);
+        bool all = true;
+        for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+            if (in_group(lane) && !load_operand(*lanes_[lane], operand, values[lane])) {
+                leave(lane, ticks, point);
+                all = false;
+            }
+        }
+        if (all) loaded_ |= uint32_t(1) << operand.slot;
+        return all;
+    }
+
+    // The operand's value if every member agrees on it; FOR counts must, or the members would branch apart.
+    bool uniform(const Operand& operand, uint16_t& value) const {
+        LaneOperand source = lane_operand(operand, base(), stride_);
+        if (!source.row) {
+            value = source.constant;
+            return true;
+        }
+        bool first = true;
+        for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+            if (!in_group(lane)) continue;
+            if (!first && source.row[lane] != value) return false;
+            value = source.row[lane];
+            first = false;
+        }
+        return true;
+    }
+
+    void mark_written(int slot) { loaded_ |= uint32_t(1) << slot; written_ |= uint32_t(1) << slot; }
+
+    // Stores the written rows of every member still in the group and moves them to point, after
+    // ticks. Members whose store faulted leave the group there.
+    void finish(int ticks, const ExecPoint& point) {
+        for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+            if (in_group(lane) && !store(lane, point)) {
+                left_at_[lane] = ticks;
+                remaining_--;
+            }
+        }
+    }
+
+private:
+    void leave(size_t lane, int ticks, const ExecPoint& point) {
+        store(lane, point);
+        left_at_[lane] = ticks;
+        remaining_--;
+    }
+
+    // Moves the member to point with its written rows stored. Written slots were loaded or stored
+    // before, so their page was resident, but another core may have evicted it since; such a value
+    // waits in pending_stores for interpreter_run and false is returned.
+    bool store(size_t lane, const ExecPoint& point) {
+        Process& process = *lanes_[lane];
+        bool all = true;
+        for (int slot = 0; slot < MAX_VARIABLES; ++slot) {
+            if (!(written_ & (uint32_t(1) << slot))) continue;
+            if (!store_slot(process, slot, row(slot)[lane])) {
+                process.cold->pending_stores.emplace_back(slot, row(slot)[lane]);
+                all = false;
+            }
+        }
+        process.program_counter = point.pc;
+        process.loop_depth = point.loop_depth;
+        std::copy(point.loop_stack, point.loop_stack + point.loop_depth, process.loop_stack);
+        return all;
+    }
+
+    const std::vector<Process*>& lanes_;
+    size_t stride_;
+    std::vector<uint16_t> rows_;
+    std::vector<int> left_at_;
+    size_t remaining_;
+    uint32_t loaded_ = 0;
+    uint32_t written_ = 0;
+};
+
+// Runs the group's shared instruction stream until an instruction that is not vectorized, divergent
+// loop control, the end of the program or the tick budget, and leaves every member there. Returns
+// the ticks spent by the members that stayed in the group.
+int run_group(LaneRows& rows, const Process& leader, int max_ticks) {
+    const ProgramImage& image = *leader.image;
+    const Instruction* const code = image.code.data();
+    const int code_size = static_cast<int>(image.code.size());
+    const size_t stride = rows.stride();
+
+    ExecPoint point;
+    point.pc = leader.program_counter;
+    point.loop_depth = leader.loop_depth;
+    std::copy(leader.loop_stack, leader.loop_stack + leader.loop_depth, point.loop_stack);
+    int ticks = 0;
+
+    bool vectorizable = true;
+    while (vectorizable && point.pc < code_size && rows.remaining() > 0) {
+        const Instruction& ins = code[point.pc];
+        if (ticks >= max_ticks && !is_loop_control(ins.op)) break;
+        switch (ins.op) {
+            case Opcode::DECLARE:
+            case Opcode::ADD:
+            case Opcode::SUBTRACT: {
+                if (!rows.load(ins.lhs, ticks, point) || !rows.load(ins.rhs, ticks, point)) break; // Retry without the faulted members
+                if (ins.dst.slot >= 0) {
+                    LaneOperand a = lane_operand(ins.lhs, rows.base(), stride);
+                    LaneOperand b = lane_operand(ins.rhs, rows.base(), stride);
+                    uint16_t* dst = rows.row(ins.dst.slot);
+                    if (ins.op == Opcode::DECLARE) apply_lanes<LaneOp::COPY>(dst, a, b, stride);
+                    if (ins.op == Opcode::ADD) apply_lanes<LaneOp::ADD>(dst, a, b, stride);
+                    if (ins.op == Opcode::SUBTRACT) apply_lanes<LaneOp::SUBTRACT>(dst, a, b, stride);
+                    rows.mark_written(ins.dst.slot);
+                }
+                ++point.pc; ++ticks;
+                break;
+            }
+            case Opcode::FOR_BEGIN: {
+                uint16_t repeats = 0;
+                if (!rows.load(ins.lhs, ticks, point)) break;
+                if (!rows.uniform(ins.lhs, repeats)) {
+                    vectorizable = false;
+                } else if (repeats == 0) {
+                    point.pc = ins.jump;
+                } else {
+                    point.loop_stack[point.loop_depth++] = {point.pc + 1, repeats};
+                    ++point.pc;
+                }
+                break;
+            }
+            case Opcode::FOR_END: {
+                LoopFrame& frame = point.loop_stack[point.loop_depth - 1];
+                if (--frame.remaining > 0) {
+                    point.pc = frame.body_pc;
+                } else {
+                    point.loop_depth--;
+                    ++point.pc;
+                }
+                break;
+            }
+            default:
+                vectorizable = false; // Memory, PRINT and SLEEP run on the scalar path
+                break;
+        }
+    }
+
+    rows.finish(ticks, point);
+    return ticks;
+}
+
+} // end anonymous namespace
+
+void interpreter_run_lockstep(const std::vector<Process*>& processes, int max_ticks,
+                              std::vector<ExecStatus>& statuses, std::vector<int>& ticks_used) {
+    statuses.assign(processes.size(), ExecStatus::RUNNING);
+    ticks_used.assign(processes.size(), 0);
+    std::vector<char> stopped(processes.size(), 0);
+
+    // Only processes that interpreter_run would start executing, with nothing left to store, can join a group.
+    std::vector<size_t> order;
+    order.reserve(processes.size());
+    for (size_t i = 0; i < processes.size(); ++i) {
+        const Process& process = *processes[i];
+        if (process.image && !process.mem_data.terminated_by_error && process.sleep_ticks_remaining == 0 &&
+            process.cold->pending_stores.empty() && process.program_counter < static_cast<int>(process.image->code.size())) {
+            order.push_back(i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return position_less(*processes[a], *processes[b]); });
+
+    std::vector<Process*> lanes;
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin + 1;
+        while (end < order.size() && same_position(*processes[order[begin]], *processes[order[end]])) ++end;
+        if (end - begin >= LOCKSTEP_MIN_GROUP) {
+            lanes.clear();
+            for (size_t k = begin; k < end; ++k) lanes.push_back(processes[order[k]]);
+            LaneRows rows(lanes, lanes.front()->image->variable_names.size());
+            int ticks = run_group(rows, *lanes.front(), max_ticks);
+            for (size_t lane = 0; lane < lanes.size(); ++lane) {
+                size_t i = order[begin + lane];
+                if (rows.in_group(lane)) {
+                    ticks_used[i] = ticks;
+                    continue;
+                }
+                // Faulted on a load, where interpreter_run would have stopped too, or on a store back.
+                ticks_used[i] = rows.left_at(lane);
+                statuses[i] = processes[i]->mem_data.terminated_by_error ? ExecStatus::TERMINATED : ExecStatus::BLOCKED;
+                stopped[i] = 1;
+            }
+        }
+        begin = end;
+    }
+
+    // Everybody else finishes its budget on the scalar path, which is where grouped processes pick
+    // up the instruction that stopped their group.
+    for (size_t i = 0; i < processes.size(); ++i) {
+        if (stopped[i]) continue;
+        int more = 0;
+        statuses[i] = interpreter_run(*processes[i], max_ticks - ticks_used[i], more);
+        ticks_used[i] += more;
+    }
+}
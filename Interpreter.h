@@ -0,0 +1,79 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Process.h"
+
+// Why interpreter_run handed control back to the core.
+enum class ExecStatus {
+    RUNNING,    // Tick budget used up, more instructions left
+    BLOCKED,    // Page fault; the faulting instruction runs again on the next dispatch
+    SLEEPING,   // SLEEP ran; keep the process off the cores for sleep_ticks_remaining ticks
+    FINISHED,   // Ran past the last instruction
+    TERMINATED  // Load error or memory access violation, see cold->termination_reason
+};
+
+// Splits "a; FOR([b; c], 2); d" on top-level semicolons, keeping brackets, parentheses and quotes intact.
+std::vector<std::string> split_statements(const std::string& block);
+
+// Compiles source statements into image.code, assigning each variable name a symbol table slot in
+// order of first use. Returns false and sets image.error on the first bad statement; source is not touched.
+bool compile_program(const std::vector<std::string>& commands, ProgramImage& image);
+
+// Rewrites image.code for faster interpretation: flattens small constant FOR loops, folds operands
+// whose values are known at load time, and fuses WRITE + READ pairs into WRITE_READ. Every process
+// still spends the same ticks per instruction, so tick counts and preemption points do not change
+// while optimizer_keeps_ticks() holds. Idempotent, so optimized code disassembles and recompiles to itself.
+void optimize_program(ProgramImage& image);
+
+// False while core caches or NUMA remote stalls are on. Both charge ticks per memory access, and
+// optimize_program drops accesses (folded variable loads, the READ of a fused WRITE + READ), so an
+// optimized program would spend fewer ticks than its source. Programs are then built unoptimized.
+bool optimizer_keeps_ticks();
+
+// Compiles commands into a new image without interning it, for programs unlikely to repeat.
+// Program counters into an optimized image only make sense against code optimized the same way.
+std::shared_ptr<const ProgramImage> build_program(std::vector<std::string> commands, bool optimize = optimizer_keeps_ticks());
+
+// Returns the shared image for commands, compiling it only the first time these exact commands are seen
+// optimized (or not) this way. Images are dropped once the last process using them is gone.
+std::shared_ptr<const ProgramImage> intern_program(const std::vector<std::string>& commands, bool optimize = optimizer_keeps_ticks());
+size_t interned_program_count();
+
+// Points process at image. If the image failed to compile, the process is marked terminated_by_error.
+bool load_program(Process& process, std::shared_ptr<const ProgramImage> image);
+
+// The image's source text, disassembled from its code when the image was built without source.
+// compile_program turns the result back into identical code.
+std::vector<std::string> program_source(const ProgramImage& image);
+
+// Number of instructions in the process's compiled program.
+size_t program_length(const Process& process);
+
+// CPU ticks the image takes to run to the end, FOR bodies counted once per repeat. A loop whose
+// count is a variable is counted once, so the estimate can fall short for such programs.
+uint64_t program_ticks(const ProgramImage& image);
+
+// Executes instructions until max_ticks ticks were spent or the process stops; ticks_used reports the spend,
+// cache-miss ticks included when core-cache is on.
+ExecStatus interpreter_run(Process& process, int max_ticks, int& ticks_used);
+
+// Groups smaller than this are not worth copying into lanes and run on the scalar path.
+constexpr size_t LOCKSTEP_MIN_GROUP = 8;
+
+// Gives every process a budget of max_ticks ticks, with the same results as interpreter_run on each
+// in turn. Processes running the same image at the same pc with the same loop state form a group
+// whose variables are copied into one array per slot; DECLARE, ADD, SUBTRACT and loop control then
+// run for the whole group at once, eight processes per SIMD instruction. The first instruction
+// that touches memory, PRINT or SLEEP sends each member on to interpreter_run for the rest of its
+// budget; a member that page faults on its variables stops there as BLOCKED, and so does one whose
+// written variables were evicted before they could be stored back (interpreter_run stores them
+// first when it next runs). The processes must be kept off the cores while this runs, the way a
+// core keeps its own process. No scheduler uses it: it is an experiment run by benchmark lockstep
+// only, and slower than interpreter_run at small quanta.
+void interpreter_run_lockstep(const std::vector<Process*>& processes, int max_ticks,
+                              std::vector<ExecStatus>& statuses, std::vector<int>& ticks_used);
+
+#endif // INTERPRETER_H
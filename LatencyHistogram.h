@@ -0,0 +1,63 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+
+// Power-of-two bucketed latency histogram. Bucket i counts samples in [2^i, 2^(i+1)) nanoseconds.
+// Recording is one bit scan plus two relaxed atomic adds, so it is safe to call from every core; the
+// sample count is summed from the buckets when read.
+struct LatencyHistogram {
+    static constexpr int BUCKETS = 40;
+
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+    std::atomic<uint64_t> total_ns{0};
+
+    static int bucket_for(uint64_t ns) {
+        int index = 63 - __builtin_clzll(ns | 1);
+        return index < BUCKETS ? index : BUCKETS - 1;
+    }
+
+    void record(uint64_t ns) {
+        buckets[bucket_for(ns)].fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    uint64_t samples() const {
+        uint64_t total = 0;
+        for (const auto& bucket : buckets) total += bucket.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Upper bound of the bucket holding the given quantile (0.0 - 1.0).
+    uint64_t percentile_ns(double quantile) const {
+        uint64_t count = samples();
+        if (count == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(quantile * (count - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) return (uint64_t(1) << (i + 1)) - 1;
+        }
+        return (uint64_t(1) << BUCKETS) - 1;
+    }
+
+    void print(std::ostream& os, const char* label) const {
+        uint64_t count = samples();
+        os << label << ": " << count << " samples";
+        if (count == 0) { os << "\n"; return; }
+        os << ", mean " << total_ns.load(std::memory_order_relaxed) / count << " ns"
+           << ", p50 <= " << percentile_ns(0.50) << " ns"
+           << ", p99 <= " << percentile_ns(0.99) << " ns\n";
+        for (int i = 0; i < BUCKETS; ++i) {
+            uint64_t n = buckets[i].load(std::memory_order_relaxed);
+            if (n == 0) continue;
+            os << "  [" << std::setw(12) << (uint64_t(1) << i) << " ns, " << std::setw(12) << (uint64_t(1) << (i + 1)) << " ns) "
+               << std::setw(8) << n << "\n";
+        }
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
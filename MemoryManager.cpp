@@ -1,91 +1,299 @@
 #include "MemoryManager.h"
 #include "global.h" 
+#include "MemorySnapshot.h"
+#include "Checkpoint.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <mutex>
 #include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
 
 // --- Structs and Constants ---
 const std::string BACKING_STORE_FILE = "csopesy-backing-store.txt";
 
+// Consecutive page-to-next-page accesses before a fault is served with a huge mapping.
+const int HUGE_PAGE_SEQ_THRESHOLD = 2;
+
+// Working-set sampler period and the number of samples a page stays in the working set.
+const int WORKING_SET_SAMPLE_MS = 100;
+const int WORKING_SET_WINDOW = 4;
+const unsigned char WORKING_SET_MASK = (1 << WORKING_SET_WINDOW) - 1;
+
+// Most pages one NUMA migration pass moves, so a pass never holds the scheduler locks for long.
+const int NUMA_MIGRATE_BATCH = 64;
+
+// Host transparent huge page size; buffers at least this big are aligned to it.
+const size_t HOST_HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
 struct Frame {
     bool is_free = true;
     int owner_pid = -1;
     int page_number_in_process = -1;
+    bool is_huge = false;
+    long access_heat = 0; // Samples in which the resident page was referenced
 };
 
+// --- Host Memory Helpers ---
+// Allocates the emulated physical memory zeroed and aligned so the host can back it with huge pages.
+char* allocate_host_memory(size_t bytes) {
+    size_t alignment = bytes >= HOST_HUGE_PAGE_BYTES ? HOST_HUGE_PAGE_BYTES : 64;
+    size_t rounded = ((bytes + alignment - 1) / alignment) * alignment;
+    if (rounded == 0) rounded = alignment;
+#ifdef _WIN32
+    char* buffer = static_cast<char*>(_aligned_malloc(rounded, alignment));
+#else
+    void* raw = nullptr;
+    char* buffer = posix_memalign(&raw, alignment, rounded) == 0 ? static_cast<char*>(raw) : nullptr;
+#ifdef MADV_HUGEPAGE
+    if (buffer && rounded >= HOST_HUGE_PAGE_BYTES) {
+        madvise(buffer, rounded, MADV_HUGEPAGE);
+    }
+#endif
+#endif
+    if (buffer) { std::memset(buffer, 0, rounded); }
+    return buffer;
+}
+
+void free_host_memory(char* buffer) {
+#ifdef _WIN32
+    _aligned_free(buffer);
+#else
+    std::free(buffer);
+#endif
+}
+
 // --- PIMPL (Pointer to Implementation) Class ---
 class MemoryManager::MemoryManagerImpl {
 public:
+    MemoryManager& owner; // For the page size statistics
+    int memory_bytes;
     char* main_memory_buffer;
     std::vector<Frame> frame_table;
     std::fstream backing_store_stream;
     long next_backing_store_offset = 0;
     std::mutex backing_store_mutex;
 
+    // Working-set sampler
+    std::thread sampler_thread;
+    std::atomic<bool> sampler_running{false};
+    std::mutex sampler_mutex;
+    std::condition_variable sampler_cv;
+
+    // NUMA nodes, fault placement and the hot-page migration pass run by the sampler
+    NumaTopology numa;
+    NumaPlacement placement = NumaPlacement::FIRST_FREE;
+    bool migrate_hot_pages_enabled = false;
+
     // References to scheduler queues for the eviction algorithm
-    std::deque<std::shared_ptr<Process>>& rr_ready_queue_ref;
-    std::vector<std::shared_ptr<Process>>& rr_running_processes_ref;
-    std::deque<std::shared_ptr<Process>>& fcfs_ready_queue_ref;
-    std::vector<std::shared_ptr<Process>>& fcfs_running_processes_ref;
+    ReadyQueue& rr_ready_queue_ref;
+    std::vector<ProcessIndex>& rr_running_processes_ref;
+    std::deque<ProcessIndex>& fcfs_ready_queue_ref;
+    std::vector<ProcessIndex>& fcfs_running_processes_ref;
 
     MemoryManagerImpl(
-        std::deque<std::shared_ptr<Process>>& rr_ready,
-        std::vector<std::shared_ptr<Process>>& rr_running,
-        std::deque<std::shared_ptr<Process>>& fcfs_ready,
-        std::vector<std::shared_ptr<Process>>& fcfs_running)
-        : rr_ready_queue_ref(rr_ready), rr_running_processes_ref(rr_running),
+        MemoryManager& owner,
+        ReadyQueue& rr_ready,
+        std::vector<ProcessIndex>& rr_running,
+        std::deque<ProcessIndex>& fcfs_ready,
+        std::vector<ProcessIndex>& fcfs_running,
+        int memory_bytes,
+        const std::string& backing_store_file)
+        : owner(owner), memory_bytes(memory_bytes), rr_ready_queue_ref(rr_ready), rr_running_processes_ref(rr_running),
           fcfs_ready_queue_ref(fcfs_ready), fcfs_running_processes_ref(fcfs_running) {
         
-        main_memory_buffer = new char[MAX_OVERALL_MEM]();
-        int num_frames = MAX_OVERALL_MEM / MEM_PER_FRAME;
+        main_memory_buffer = allocate_host_memory(memory_bytes);
+        int num_frames = memory_bytes / MEM_PER_FRAME;
         frame_table.resize(num_frames);
-        backing_store_stream.open(BACKING_STORE_FILE, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        numa = numa_topology_from_globals(CPU_COUNT, num_frames);
+        parse_numa_placement(NUMA_PLACEMENT, placement);
+        migrate_hot_pages_enabled = NUMA_MIGRATE != 0;
+        backing_store_stream.open(backing_store_file, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+
+        sampler_running = true;
+        sampler_thread = std::thread(&MemoryManagerImpl::sampler_loop, this);
     }
 
     ~MemoryManagerImpl() {
-        delete[] main_memory_buffer;
+        {
+            std::lock_guard<std::mutex> lock(sampler_mutex);
+            sampler_running = false;
+        }
+        sampler_cv.notify_all();
+        if (sampler_thread.joinable()) { sampler_thread.join(); }
+        free_host_memory(main_memory_buffer);
         if (backing_store_stream.is_open()) { backing_store_stream.close(); }
     }
 
-    int find_free_frame() {
-        for (int i = 0; i < frame_table.size(); ++i) {
+    int find_free_frame_in(int first, int end) {
+        for (int i = first; i < end; ++i) {
             if (frame_table[i].is_free) { return i; }
         }
         return -1;
     }
 
+    // With NUMA nodes, tries the node the placement policy picks for the page first, then the
+    // nodes after it; otherwise takes the lowest free frame.
+    int find_free_frame(const Process& process, int page_number) {
+        if (!numa.enabled() || placement == NumaPlacement::FIRST_FREE) { return find_free_frame_in(0, static_cast<int>(frame_table.size())); }
+        int home = placement == NumaPlacement::LOCAL ? numa.node_of_core(process_core(g_process_table, process))
+                                                     : page_number % numa.nodes();
+        for (int k = 0; k < numa.nodes(); ++k) {
+            int node = (home + k) % numa.nodes();
+            int frame = find_free_frame_in(numa.first_frame(node), numa.end_frame(node));
+            if (frame != -1) { return frame; }
+        }
+        return -1;
+    }
+
+    // Finds a naturally aligned run of HUGE_PAGE_FRAMES free frames.
+    int find_free_huge_run() {
+        const int frames = static_cast<int>(frame_table.size());
+        for (int start = 0; start + HUGE_PAGE_FRAMES <= frames; start += HUGE_PAGE_FRAMES) {
+            bool run_is_free = true;
+            for (int k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+                if (!frame_table[start + k].is_free) { run_is_free = false; break; }
+            }
+            if (run_is_free) { return start; }
+        }
+        return -1;
+    }
+
+    // Demotes the huge mapping containing page_number into independent base pages.
+    void split_huge_page(Process& process, int page_number) {
+        int region_start = (page_number / HUGE_PAGE_FRAMES) * HUGE_PAGE_FRAMES;
+        const int pages = static_cast<int>(process.cold->page_table.size());
+        for (int k = 0; k < HUGE_PAGE_FRAMES && region_start + k < pages; ++k) {
+            auto& pte = process.cold->page_table[region_start + k];
+            if (pte.is_huge && pte.frame_index != -1) { frame_table[pte.frame_index].is_huge = false; }
+            pte.is_huge = false;
+        }
+        owner.huge_pages_split++;
+    }
+
+    // Reads page page_number of process from the backing store into frame_ptr. Caller holds
+    // backing_store_mutex. The file only grows as pages are written out, so a read that runs past
+    // its end comes up short; the rest of the page is zeroes.
+    void read_page(Process& process, int page_number, char* frame_ptr) {
+        backing_store_stream.seekg(process.mem_data.backing_store_offset + (page_number * MEM_PER_FRAME));
+        backing_store_stream.read(frame_ptr, MEM_PER_FRAME);
+        std::streamsize read_bytes = std::max<std::streamsize>(0, backing_store_stream.gcount());
+        backing_store_stream.clear();
+        std::memset(frame_ptr + read_bytes, 0, MEM_PER_FRAME - static_cast<size_t>(read_bytes));
+    }
+
+    // Maps the whole aligned region around page_number with one huge page, if possible.
+    bool try_map_huge_page(Process& process, int page_number) {
+        int region_start = (page_number / HUGE_PAGE_FRAMES) * HUGE_PAGE_FRAMES;
+        if (region_start + HUGE_PAGE_FRAMES > static_cast<int>(process.cold->page_table.size())) { return false; }
+        for (int k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+            if (process.cold->page_table[region_start + k].is_present) { return false; }
+        }
+
+        int frame_start = find_free_huge_run();
+        if (frame_start == -1) { return false; }
+
+        bool needs_read = false;
+        for (int k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+            if (process.cold->page_table[region_start + k].in_backing_store) { needs_read = true; break; }
+        }
+        char* frame_ptr = main_memory_buffer + (frame_start * MEM_PER_FRAME);
+        if (needs_read) {
+            // Only the pages that were written out are in the store; the others start as zeroes, not as
+            // whatever the store holds past them.
+            std::lock_guard<std::mutex> backing_lock(backing_store_mutex);
+            for (int k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+                char* page_ptr = frame_ptr + k * MEM_PER_FRAME;
+                if (process.cold->page_table[region_start + k].in_backing_store) read_page(process, region_start + k, page_ptr);
+                else std::memset(page_ptr, 0, MEM_PER_FRAME);
+            }
+        } else {
+            std::memset(frame_ptr, 0, HUGE_PAGE_FRAMES * MEM_PER_FRAME);
+        }
+        count_fault(process, needs_read, HUGE_PAGE_FRAMES * MEM_PER_FRAME);
+
+        for (int k = 0; k < HUGE_PAGE_FRAMES; ++k) {
+            frame_table[frame_start + k].is_free = false;
+            frame_table[frame_start + k].owner_pid = process.id;
+            frame_table[frame_start + k].page_number_in_process = region_start + k;
+            frame_table[frame_start + k].is_huge = true;
+            frame_table[frame_start + k].access_heat = 0;
+
+            auto& pte = process.cold->page_table[region_start + k];
+            pte.is_present = true;
+            pte.is_dirty = false;
+            pte.is_huge = true;
+            pte.frame_index = frame_start + k;
+        }
+        owner.pages_paged_in += HUGE_PAGE_FRAMES;
+        owner.huge_page_faults++;
+        return true;
+    }
+
+    // Charges a resolved fault to the process and the global totals. The caller holds the process's
+    // page_fault_mutex, so its fault counters have one writer and need no atomic add.
+    void count_fault(Process& process, bool is_major, int bytes_read) {
+        auto bump = [](std::atomic<uint64_t>& counter, uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        };
+        if (is_major) {
+            bump(process.mem_data.major_faults, 1);
+            bump(process.mem_data.bytes_read_from_store, bytes_read);
+            owner.major_page_faults++;
+        } else {
+            bump(process.mem_data.minor_faults, 1);
+            owner.minor_page_faults++;
+        }
+    }
+
     int evict_page_oldest_process(std::atomic<int>& pages_paged_out_ref) {
+        auto eviction_start = std::chrono::steady_clock::now();
         Process* oldest_process_to_evict = nullptr;
         long long min_timestamp = -1;
 
-        auto find_oldest_in_list = [&](auto& process_list) {
-            for (const auto& proc_ptr : process_list) {
-                if (!proc_ptr || proc_ptr->state == ProcessState::BLOCKED) continue;
-                bool has_pages_in_memory = false;
-                for (const auto& pte : proc_ptr->mem_data.page_table) {
-                    if (pte.is_present) { has_pages_in_memory = true; break; }
-                }
-                if (has_pages_in_memory && (min_timestamp == -1 || proc_ptr->mem_data.creation_timestamp < min_timestamp)) {
-                    min_timestamp = proc_ptr->mem_data.creation_timestamp;
-                    oldest_process_to_evict = proc_ptr.get();
-                }
+        auto consider = [&](ProcessIndex index) {
+            // The state comes from the table's dense array; only candidates touch their PCB.
+            if (index == NO_PROCESS || g_process_table.state(index) == ProcessState::BLOCKED) return;
+            Process* proc_ptr = &g_process_table[index];
+            bool has_pages_in_memory = false;
+            for (const auto& pte : proc_ptr->cold->page_table) {
+                if (pte.is_present) { has_pages_in_memory = true; break; }
+            }
+            if (has_pages_in_memory && (min_timestamp == -1 || proc_ptr->mem_data.creation_timestamp < min_timestamp)) {
+                min_timestamp = proc_ptr->mem_data.creation_timestamp;
+                oldest_process_to_evict = proc_ptr;
             }
         };
-        
+        auto find_oldest_in_list = [&](auto& process_list) {
+            for (ProcessIndex index : process_list) consider(index);
+        };
+        auto consider_sleeper = [&](ProcessIndex index, uint64_t) { consider(index); };
+
+        // Sleeping processes keep their frames while parked, so they are candidates as well.
         { std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-          find_oldest_in_list(rr_ready_queue_ref);
-          find_oldest_in_list(rr_running_processes_ref); }
+          rr_ready_queue_ref.for_each(consider);
+          find_oldest_in_list(rr_running_processes_ref);
+          rr_g_sleep_wheel.for_each(consider_sleeper); }
         { std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
           find_oldest_in_list(fcfs_ready_queue_ref);
-          find_oldest_in_list(fcfs_running_processes_ref); }
+          find_oldest_in_list(fcfs_running_processes_ref);
+          fcfs_g_sleep_wheel.for_each(consider_sleeper); }
 
         if (!oldest_process_to_evict) { return -1; }
 
-        for (int i = 0; i < oldest_process_to_evict->mem_data.page_table.size(); ++i) {
-            auto& pte = oldest_process_to_evict->mem_data.page_table[i];
+        for (int i = 0; i < oldest_process_to_evict->cold->page_table.size(); ++i) {
+            auto& pte = oldest_process_to_evict->cold->page_table[i];
             if (pte.is_present) {
+                // Memory pressure breaks huge mappings up so only one base page leaves.
+                if (pte.is_huge) { split_huge_page(*oldest_process_to_evict, i); }
                 int victim_frame_index = pte.frame_index;
                 if (pte.is_dirty) {
                     std::lock_guard<std::mutex> lock(backing_store_mutex);
@@ -94,10 +302,14 @@ public:
                     backing_store_stream.write(page_data_ptr, MEM_PER_FRAME);
                     backing_store_stream.flush();
                     pages_paged_out_ref++;
+                    pte.in_backing_store = true;
+                    oldest_process_to_evict->mem_data.bytes_written_to_store.fetch_add(MEM_PER_FRAME, std::memory_order_relaxed);
                 }
                 pte.is_present = false;
                 pte.is_dirty = false;
                 pte.frame_index = -1;
+                oldest_process_to_evict->mem_data.pages_evicted.fetch_add(1, std::memory_order_relaxed);
+                owner.eviction_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - eviction_start).count());
                 return victim_frame_index;
             }
         }
@@ -107,38 +319,143 @@ public:
     // --- MODIFIED: handle_page_fault ---
     void handle_page_fault(Process& faulting_process, int page_number, std::atomic<int>& paged_in_ref, std::atomic<int>& paged_out_ref) {
         // Lock the mutex for this specific process to prevent it from running
-        std::unique_lock<std::mutex> lock(faulting_process.mem_data.page_fault_mutex);
+        std::unique_lock<std::mutex> lock(faulting_process.cold->page_fault_mutex);
         
         // Check again to see if another thread already handled the fault
-        auto& pte = faulting_process.mem_data.page_table[page_number];
+        auto& pte = faulting_process.cold->page_table[page_number];
         if (pte.is_present) {
             return;
         }
 
-        int frame_idx = find_free_frame();
+        // Sequential streams get the whole aligned region in one fault.
+        if (HUGE_PAGE_FRAMES > 1 && faulting_process.mem_data.sequential_streak >= HUGE_PAGE_SEQ_THRESHOLD &&
+            try_map_huge_page(faulting_process, page_number)) {
+            return;
+        }
+
+        int frame_idx = find_free_frame(faulting_process, page_number);
         if (frame_idx == -1) {
             frame_idx = evict_page_oldest_process(paged_out_ref);
         }
 
         if (frame_idx != -1) {
-            std::lock_guard<std::mutex> backing_lock(backing_store_mutex);
+            // Pages that were never written back are still all zeroes in the backing store.
             char* frame_ptr = main_memory_buffer + (frame_idx * MEM_PER_FRAME);
-            backing_store_stream.seekg(faulting_process.mem_data.backing_store_offset + (page_number * MEM_PER_FRAME));
-            backing_store_stream.read(frame_ptr, MEM_PER_FRAME);
+            if (pte.in_backing_store) {
+                std::lock_guard<std::mutex> backing_lock(backing_store_mutex);
+                read_page(faulting_process, page_number, frame_ptr);
+            } else {
+                std::memset(frame_ptr, 0, MEM_PER_FRAME);
+            }
+            count_fault(faulting_process, pte.in_backing_store, MEM_PER_FRAME);
             
             paged_in_ref++;
+            owner.base_page_faults++;
             
             // Update the frame table and PTE
             frame_table[frame_idx].is_free = false;
             frame_table[frame_idx].owner_pid = faulting_process.id;
             frame_table[frame_idx].page_number_in_process = page_number;
+            frame_table[frame_idx].is_huge = false;
+            frame_table[frame_idx].access_heat = 0;
             
             pte.is_present = true;
             pte.frame_index = frame_idx;
             pte.is_dirty = false;
-            
-            // Notify the blocked process that its page is ready
-            faulting_process.mem_data.page_fault_cv.notify_one();
+            pte.is_huge = false;
+        }
+    }
+
+    // Looks the page up in the process' simulated TLB, filling it on a miss.
+    void record_translation(Process& process, int page_number, bool is_huge) {
+        long long tag = is_huge ? ((long long)(page_number / HUGE_PAGE_FRAMES) << 1) | 1 : (long long)page_number << 1;
+        long long& slot = process.mem_data.tlb_tags[tag % TLB_ENTRIES];
+        bool hit = (slot == tag + 1);
+        slot = tag + 1;
+        if (is_huge) { hit ? owner.tlb_huge_hits++ : owner.tlb_huge_misses++; }
+        else { hit ? owner.tlb_base_hits++ : owner.tlb_base_misses++; }
+    }
+
+    // --- Working-Set Sampler ---
+    // Clears each page's referenced bit, shifts it into the page's history and credits the frame's heat.
+    void harvest_referenced_bits(Process& process) {
+        int working_set = 0;
+        for (auto& pte : process.cold->page_table) {
+            bool referenced = pte.is_referenced.load() && pte.is_referenced.exchange(false);
+            pte.reference_history = static_cast<unsigned char>((pte.reference_history << 1) | (referenced ? 1 : 0));
+            if (referenced && pte.is_present && pte.frame_index != -1) {
+                frame_table[pte.frame_index].access_heat++;
+            }
+            if (pte.reference_history & WORKING_SET_MASK) { working_set++; }
+        }
+        process.mem_data.working_set_pages = working_set;
+        process.mem_data.peak_working_set_pages = std::max(process.mem_data.peak_working_set_pages, working_set);
+    }
+
+    void sample_working_sets() {
+        auto harvest_list = [&](auto& process_list) {
+            for (ProcessIndex index : process_list) {
+                if (index != NO_PROCESS) { harvest_referenced_bits(g_process_table[index]); }
+            }
+        };
+        auto harvest_sleeper = [&](ProcessIndex index, uint64_t) { harvest_referenced_bits(g_process_table[index]); };
+        { std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+          rr_ready_queue_ref.for_each([&](ProcessIndex index) { harvest_referenced_bits(g_process_table[index]); });
+          harvest_list(rr_running_processes_ref);
+          rr_g_sleep_wheel.for_each(harvest_sleeper); }
+        { std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+          harvest_list(fcfs_ready_queue_ref);
+          harvest_list(fcfs_running_processes_ref);
+          fcfs_g_sleep_wheel.for_each(harvest_sleeper); }
+        owner.working_set_samples++;
+    }
+
+    // --- NUMA Page Migration ---
+    // Moves hot pages (referenced within the working-set window) of processes waiting for a core to
+    // a free frame on the node of the core they last ran on, at most NUMA_MIGRATE_BATCH per pass.
+    // Running processes are left alone, since their core may hold a pointer into the frame, and so
+    // are huge mappings. Holding the scheduler lock keeps the others from being dispatched meanwhile.
+    void migrate_hot_pages() {
+        int budget = NUMA_MIGRATE_BATCH;
+        auto migrate = [&](ProcessIndex index) {
+            int core = g_process_table.core(index);
+            if (budget == 0 || core < 0) return;
+            Process& process = g_process_table[index];
+            std::unique_lock<std::mutex> fault_lock(process.cold->page_fault_mutex, std::try_to_lock);
+            if (!fault_lock) return;
+            int home = numa.node_of_core(core);
+            for (auto& pte : process.cold->page_table) {
+                if (budget == 0) return;
+                if (!pte.is_present || pte.is_huge || !(pte.reference_history & WORKING_SET_MASK)) continue;
+                if (numa.node_of_frame(pte.frame_index) == home) continue;
+                int target = find_free_frame_in(numa.first_frame(home), numa.end_frame(home));
+                if (target == -1) return; // The home node is full
+                std::memcpy(main_memory_buffer + target * MEM_PER_FRAME, main_memory_buffer + pte.frame_index * MEM_PER_FRAME, MEM_PER_FRAME);
+                frame_table[target] = frame_table[pte.frame_index];
+                frame_table[pte.frame_index] = Frame();
+                pte.frame_index = target;
+                owner.numa_pages_migrated++;
+                budget--;
+            }
+        };
+        auto migrate_sleeper = [&](ProcessIndex index, uint64_t) { migrate(index); };
+        { std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+          rr_ready_queue_ref.for_each(migrate);
+          rr_g_sleep_wheel.for_each(migrate_sleeper); }
+        { std::lock_guard<std::mutex> lock(fcfs_g_process_mutex);
+          for (ProcessIndex index : fcfs_ready_queue_ref) migrate(index);
+          fcfs_g_sleep_wheel.for_each(migrate_sleeper); }
+    }
+
+    void sampler_loop() {
+        std::unique_lock<std::mutex> lock(sampler_mutex);
+        while (sampler_running) {
+            sampler_cv.wait_for(lock, std::chrono::milliseconds(WORKING_SET_SAMPLE_MS), [&]() { return !sampler_running; });
+            if (!sampler_running) break;
+            lock.unlock();
+            sample_working_sets();
+            if (migrate_hot_pages_enabled && numa.enabled()) { migrate_hot_pages(); }
+            lock.lock();
         }
     }
 };
@@ -146,13 +463,37 @@ public:
 // --- Public Method Implementations ---
 
 MemoryManager::MemoryManager(
-    std::deque<std::shared_ptr<Process>>& rr_ready_queue,
-    std::vector<std::shared_ptr<Process>>& rr_running_processes,
-    std::deque<std::shared_ptr<Process>>& fcfs_ready_queue,
-    std::vector<std::shared_ptr<Process>>& fcfs_running_processes) {
-    p_impl = new MemoryManagerImpl(rr_ready_queue, rr_running_processes, fcfs_ready_queue, fcfs_running_processes);
+    ReadyQueue& rr_ready_queue,
+    std::vector<ProcessIndex>& rr_running_processes,
+    std::deque<ProcessIndex>& fcfs_ready_queue,
+    std::vector<ProcessIndex>& fcfs_running_processes)
+    : MemoryManager(rr_ready_queue, rr_running_processes, fcfs_ready_queue, fcfs_running_processes,
+                    MAX_OVERALL_MEM, BACKING_STORE_FILE) {}
+
+MemoryManager::MemoryManager(
+    ReadyQueue& rr_ready_queue,
+    std::vector<ProcessIndex>& rr_running_processes,
+    std::deque<ProcessIndex>& fcfs_ready_queue,
+    std::vector<ProcessIndex>& fcfs_running_processes,
+    int memory_bytes,
+    const std::string& backing_store_file) {
+    p_impl = new MemoryManagerImpl(*this, rr_ready_queue, rr_running_processes, fcfs_ready_queue, fcfs_running_processes,
+                                   memory_bytes, backing_store_file);
     pages_paged_in = 0;
     pages_paged_out = 0;
+    base_page_faults = 0;
+    huge_page_faults = 0;
+    huge_pages_split = 0;
+    tlb_base_hits = 0;
+    tlb_base_misses = 0;
+    tlb_huge_hits = 0;
+    tlb_huge_misses = 0;
+    working_set_samples = 0;
+    minor_page_faults = 0;
+    major_page_faults = 0;
+    numa_local_accesses = 0;
+    numa_remote_accesses = 0;
+    numa_pages_migrated = 0;
 }
 
 MemoryManager::~MemoryManager() {
@@ -170,27 +511,24 @@ int MemoryManager::get_used_memory_bytes() {
 }
 
 int MemoryManager::get_free_memory_bytes() {
-    return MAX_OVERALL_MEM - get_used_memory_bytes();
+    return p_impl->memory_bytes - get_used_memory_bytes();
 }
 
 void MemoryManager::allocate_for_process(Process& process, size_t requested_size) {
     {
         std::lock_guard<std::mutex> lock(g_cout_mutex);
-        std::cout << "\nDEBUG: [MemoryManager] Allocating " << requested_size << " bytes for process '" << process.processName << "'." << std::endl;
+        std::cout << "\nDEBUG: [MemoryManager] Allocating " << requested_size << " bytes for process '" << process.cold->processName << "'.\n";
     }
+    snapshot_register_process(process.id, process.cold->processName);
     process.mem_data.memory_size_bytes = requested_size;
     process.mem_data.creation_timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
     int num_pages = (requested_size + MEM_PER_FRAME - 1) / MEM_PER_FRAME;
-    process.mem_data.page_table.resize(num_pages);
+    process.cold->page_table.resize(num_pages);
+    // Only the range is reserved: the file grows when a page is first written out, and a page that
+    // never was is paged in as zeroes without reading the file.
     {
         std::lock_guard<std::mutex> lock(p_impl->backing_store_mutex);
         process.mem_data.backing_store_offset = p_impl->next_backing_store_offset;
-        long new_file_end_position = p_impl->next_backing_store_offset + requested_size - 1;
-        if (new_file_end_position >= p_impl->next_backing_store_offset) {
-            p_impl->backing_store_stream.seekp(new_file_end_position);
-            p_impl->backing_store_stream.write("\0", 1); 
-        }
-        p_impl->backing_store_stream.flush();
         p_impl->next_backing_store_offset += requested_size;
     }
 }
@@ -201,48 +539,191 @@ void MemoryManager::deallocate_for_process(Process& process) {
             p_impl->frame_table[i].is_free = true;
             p_impl->frame_table[i].owner_pid = -1;
             p_impl->frame_table[i].page_number_in_process = -1;
+            p_impl->frame_table[i].is_huge = false;
+            p_impl->frame_table[i].access_heat = 0;
         }
     }
+    // The frames may go to another process at once; nothing may reach them through this page table.
+    for (auto& pte : process.cold->page_table) {
+        pte.is_present = false;
+        pte.frame_index = -1;
+    }
 }
 
 // --- MODIFIED: access_memory ---
 char* MemoryManager::access_memory(Process& process, int logical_address, bool is_write) {
     if (logical_address < 0 || logical_address >= process.mem_data.memory_size_bytes) {
         process.mem_data.terminated_by_error = true;
-        process.mem_data.termination_reason = "Memory access violation at address " + std::to_string(logical_address);
+        process.cold->termination_reason = "Memory access violation at address " + std::to_string(logical_address);
         return nullptr;
     }
     int page_number = logical_address / MEM_PER_FRAME;
     int offset = logical_address % MEM_PER_FRAME;
-    auto& pte = process.mem_data.page_table[page_number];
+    auto& pte = process.cold->page_table[page_number];
+
+    // Track page-to-next-page streaks; repeated hits on one page keep the streak.
+    if (page_number == process.mem_data.last_page_accessed + 1) {
+        process.mem_data.sequential_streak++;
+    } else if (page_number != process.mem_data.last_page_accessed) {
+        process.mem_data.sequential_streak = 0;
+    }
+    process.mem_data.last_page_accessed = page_number;
 
     if (!pte.is_present) {
-        process.state = ProcessState::BLOCKED;
+        if (process.mem_data.defer_page_faults) {
+            // The owner resolves the fault with resolve_page_fault(), without holding up this core.
+            process.mem_data.pending_fault_page = page_number;
+            return nullptr;
+        }
+        if (process.table_index != NO_PROCESS) g_process_table.state(process.table_index) = ProcessState::BLOCKED;
         
         // This is a blocking call. The thread will wait here until the page is loaded.
+        auto fault_start = std::chrono::steady_clock::now();
         p_impl->handle_page_fault(process, page_number, this->pages_paged_in, this->pages_paged_out);
+        fault_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - fault_start).count());
 
-        // Wait for the page to be loaded.
-        std::unique_lock<std::mutex> lock(process.mem_data.page_fault_mutex);
-        while (!pte.is_present) {
-             process.mem_data.page_fault_cv.wait(lock);
-        }
-
-        // The page is now present. The instruction needs to be re-attempted.
+        // The fault is handled synchronously, so there is nothing to wait for: the page is present now
+        // unless no frame could be freed (every holder is itself blocked) or it was already evicted again.
+        // Either way the process blocks and the instruction is re-attempted when it is dispatched again.
         // Return nullptr to signal the scheduler to put the process back in the ready queue.
         return nullptr;
     }
 
+    p_impl->record_translation(process, page_number, pte.is_huge);
+    // Only the first access since the last sample writes the shared line.
+    if (!pte.is_referenced.load()) pte.is_referenced.store(true);
     if (is_write) { pte.is_dirty = true; }
     int frame_idx = pte.frame_index;
+    const NumaTopology& numa = p_impl->numa;
+    int core = numa.enabled() ? process_core(g_process_table, process) : -1;
+    if (core >= 0) {
+        if (numa.node_of_frame(frame_idx) == numa.node_of_core(core)) {
+            numa_local_accesses++;
+        } else {
+            numa_remote_accesses++;
+            process.stall_ticks += NUMA_REMOTE_PENALTY;
+        }
+    }
     return p_impl->main_memory_buffer + (frame_idx * MEM_PER_FRAME) + offset;
 }
 
+void MemoryManager::resolve_page_fault(Process& process) {
+    int page_number = process.mem_data.pending_fault_page;
+    if (page_number < 0) return;
+    process.mem_data.pending_fault_page = -1;
+    auto fault_start = std::chrono::steady_clock::now();
+    p_impl->handle_page_fault(process, page_number, this->pages_paged_in, this->pages_paged_out);
+    fault_latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - fault_start).count());
+}
+
+void MemoryManager::configure_numa(const NumaTopology& topology, NumaPlacement placement, bool migrate) {
+    p_impl->numa = topology;
+    p_impl->placement = placement;
+    p_impl->migrate_hot_pages_enabled = migrate;
+}
+
+void MemoryManager::set_numa_cores(int cores) {
+    p_impl->numa.set_cores(cores);
+}
+
+const NumaTopology& MemoryManager::numa_topology() const {
+    return p_impl->numa;
+}
+
+NumaPlacement MemoryManager::numa_placement() const {
+    return p_impl->placement;
+}
+
+bool MemoryManager::numa_migrates() const {
+    return p_impl->migrate_hot_pages_enabled;
+}
+
 std::vector<MemoryManager::FrameInfo> MemoryManager::get_frame_snapshot() {
     std::vector<MemoryManager::FrameInfo> snapshot;
     snapshot.reserve(p_impl->frame_table.size());
     for (const auto& frame : p_impl->frame_table) {
-        snapshot.push_back({frame.is_free, frame.owner_pid});
+        snapshot.push_back({frame.is_free, frame.owner_pid, frame.is_huge, frame.page_number_in_process, frame.access_heat});
     }
     return snapshot;
-}
\ No newline at end of file
+}
+
+void MemoryManager::copy_frame_owners(std::vector<int32_t>& out) {
+    out.resize(p_impl->frame_table.size());
+    for (size_t i = 0; i < p_impl->frame_table.size(); ++i) {
+        const auto& frame = p_impl->frame_table[i];
+        out[i] = frame.is_free ? -1 : frame.owner_pid;
+    }
+}
+
+void MemoryManager::save_checkpoint(CheckpointWriter& out) {
+    out.put(static_cast<uint32_t>(p_impl->frame_table.size()));
+    for (const auto& frame : p_impl->frame_table) {
+        out.put(static_cast<uint8_t>((frame.is_free ? 1 : 0) | (frame.is_huge ? 2 : 0)));
+        out.put(static_cast<int32_t>(frame.owner_pid));
+        out.put(static_cast<int32_t>(frame.page_number_in_process));
+        out.put(static_cast<int64_t>(frame.access_heat));
+    }
+    out.put_bytes(p_impl->main_memory_buffer, p_impl->memory_bytes);
+    out.put(static_cast<int32_t>(pages_paged_in));
+    out.put(static_cast<int32_t>(pages_paged_out));
+
+    std::lock_guard<std::mutex> lock(p_impl->backing_store_mutex);
+    int64_t store_bytes = p_impl->next_backing_store_offset;
+    out.put(store_bytes);
+    size_t start = out.buffer.size();
+    out.buffer.resize(start + store_bytes);
+    p_impl->backing_store_stream.seekg(0);
+    p_impl->backing_store_stream.read(out.buffer.data() + start, store_bytes);
+    p_impl->backing_store_stream.clear();
+}
+
+bool MemoryManager::restore_checkpoint(CheckpointReader& in, const std::vector<const Process*>& processes) {
+    uint32_t frame_count;
+    if (!in.get(frame_count) || frame_count != p_impl->frame_table.size()) return false;
+    std::vector<Frame> frames(frame_count);
+    for (auto& frame : frames) {
+        uint8_t flags; int32_t owner_pid, page_number; int64_t heat;
+        if (!in.get(flags) || !in.get(owner_pid) || !in.get(page_number) || !in.get(heat)) return false;
+        frame.is_free = flags & 1;
+        frame.is_huge = flags & 2;
+        frame.owner_pid = owner_pid;
+        frame.page_number_in_process = page_number;
+        frame.access_heat = heat;
+    }
+    const char* memory_data = in.view(p_impl->memory_bytes);
+    if (!memory_data) return false;
+    int32_t paged_in, paged_out;
+    if (!in.get(paged_in) || !in.get(paged_out)) return false;
+
+    int64_t store_bytes;
+    if (!in.get(store_bytes) || store_bytes < 0) return false;
+    const char* store_data = in.view(store_bytes);
+    if (!store_data) return false;
+
+    // A resident page must sit in a frame that names it back, and every process's reserved range must
+    // lie inside the saved store, or the first access would read or write another process's memory.
+    for (const Process* process : processes) {
+        const MemoryData& mem = process->mem_data;
+        if (mem.backing_store_offset < 0 || static_cast<uint64_t>(mem.backing_store_offset) + mem.memory_size_bytes > static_cast<uint64_t>(store_bytes)) return false;
+        const auto& page_table = process->cold->page_table;
+        for (size_t page = 0; page < page_table.size(); ++page) {
+            const auto& pte = page_table[page];
+            if (!pte.is_present) continue;
+            if (pte.frame_index < 0 || static_cast<uint32_t>(pte.frame_index) >= frame_count) return false;
+            const Frame& frame = frames[pte.frame_index];
+            if (frame.is_free || frame.owner_pid != process->id || frame.page_number_in_process != static_cast<int>(page)) return false;
+        }
+    }
+
+    std::copy(frames.begin(), frames.end(), p_impl->frame_table.begin());
+    std::memcpy(p_impl->main_memory_buffer, memory_data, p_impl->memory_bytes);
+    pages_paged_in = paged_in;
+    pages_paged_out = paged_out;
+
+    std::lock_guard<std::mutex> lock(p_impl->backing_store_mutex);
+    p_impl->backing_store_stream.seekp(0);
+    p_impl->backing_store_stream.write(store_data, store_bytes);
+    p_impl->backing_store_stream.flush();
+    p_impl->next_backing_store_offset = store_bytes;
+    return true;
+}
@@ -5,7 +5,14 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <thread>
 #include "Process.h" // Use our new unified Process class
+#include "LatencyHistogram.h"
+#include "NumaTopology.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+class ReadyQueue;
 
 class MemoryManager {
 private:
@@ -16,16 +23,47 @@ public:
     // --- STATISTICS FOR VMSTAT ---
     std::atomic<int> pages_paged_in;
     std::atomic<int> pages_paged_out;
+
+    // --- PAGE SIZE MIX STATISTICS ---
+    std::atomic<long> base_page_faults;
+    std::atomic<long> huge_page_faults;
+    std::atomic<long> huge_pages_split;
+    std::atomic<long> tlb_base_hits;
+    std::atomic<long> tlb_base_misses;
+    std::atomic<long> tlb_huge_hits;
+    std::atomic<long> tlb_huge_misses;
+    std::atomic<long> working_set_samples;
+
+    // --- FAULT STATISTICS ---
+    std::atomic<long> minor_page_faults;
+    std::atomic<long> major_page_faults;
+    LatencyHistogram fault_latency;
+    LatencyHistogram eviction_latency;
+
+    // --- NUMA STATISTICS ---
+    std::atomic<long> numa_local_accesses;
+    std::atomic<long> numa_remote_accesses;
+    std::atomic<long> numa_pages_migrated;
     int get_free_memory_bytes();
     int get_used_memory_bytes();
 
     // --- CONSTRUCTOR & DESTRUCTOR ---
     MemoryManager(
         // Give the manager access to all lists where processes can be
-        std::deque<std::shared_ptr<Process>>& rr_ready_queue,
-        std::vector<std::shared_ptr<Process>>& rr_running_processes,
-        std::deque<std::shared_ptr<Process>>& fcfs_ready_queue,
-        std::vector<std::shared_ptr<Process>>& fcfs_running_processes
+        ReadyQueue& rr_ready_queue,
+        std::vector<ProcessIndex>& rr_running_processes,
+        std::deque<ProcessIndex>& fcfs_ready_queue,
+        std::vector<ProcessIndex>& fcfs_running_processes
+    );
+    // A manager with memory_bytes of memory and its own backing store file, for benchmarks that
+    // must leave the system's memory alone. Frame size and NUMA layout still come from config.txt.
+    MemoryManager(
+        ReadyQueue& rr_ready_queue,
+        std::vector<ProcessIndex>& rr_running_processes,
+        std::deque<ProcessIndex>& fcfs_ready_queue,
+        std::vector<ProcessIndex>& fcfs_running_processes,
+        int memory_bytes,
+        const std::string& backing_store_file
     );
     ~MemoryManager();
 
@@ -34,14 +72,40 @@ public:
     void deallocate_for_process(Process& process);
 
     // --- CORE FUNCTIONALITY ---
-    // The CPU/Scheduler calls this for every READ or WRITE instruction.
+    // The CPU/Scheduler calls this for every READ or WRITE instruction. With NUMA nodes, an access
+    // from a core to another node's frame adds numa-remote-penalty ticks to process.stall_ticks.
     char* access_memory(Process& process, int logical_address, bool is_write);
+    // Brings in the page a deferred fault recorded (mem_data.defer_page_faults) and clears it. The
+    // caller retries the access; it faults again if no frame could be freed.
+    void resolve_page_fault(Process& process);
+
+    // --- NUMA ---
+    // Replaces the topology, placement and hot-page migration read from config.txt at construction.
+    // Frames already in use stay where they are. Not safe while processes run.
+    void configure_numa(const NumaTopology& topology, NumaPlacement placement, bool migrate);
+    // cpu-set: re-splits the cores over the nodes. Safe while processes run.
+    void set_numa_cores(int cores);
+    const NumaTopology& numa_topology() const;
+    NumaPlacement numa_placement() const;
+    bool numa_migrates() const;
     
     struct FrameInfo {
         bool is_free;
         int owner_pid;
+        bool is_huge;
+        int page_number;
+        long access_heat;
     };
     std::vector<FrameInfo> get_frame_snapshot();
+    // Fills out with the owner PID of every frame (-1 when free), reusing its storage.
+    void copy_frame_owners(std::vector<int32_t>& out);
+
+    // --- CHECKPOINT / RESTORE ---
+    // Frame table, physical memory and the used part of the backing store.
+    void save_checkpoint(CheckpointWriter& out);
+    // Checks the image and the restored processes' page tables against each other, and changes
+    // nothing unless all of it is consistent.
+    bool restore_checkpoint(CheckpointReader& in, const std::vector<const Process*>& processes);
 };
 
 #endif // MEMORY_MANAGER_H
\ No newline at end of file
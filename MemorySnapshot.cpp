@@ -0,0 +1,173 @@
+#include <fstream>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+#include "MemorySnapshot.h"
+#include "global.h"
+#include "config.h"
+
+// --- File-local state ---
+namespace {
+
+// Captures waiting for the writer; beyond this the capture is dropped instead of blocking a core.
+const size_t MAX_PENDING_RECORDS = 4096;
+// The writer pauses this long after each batch so that a burst of records, such as one name per
+// process created, costs it one wake-up and one flush rather than one per record.
+const auto WRITE_INTERVAL = std::chrono::milliseconds(1);
+
+struct PendingRecord {
+    uint8_t type;
+    int64_t timestamp_ms = 0;
+    int pid = -1;
+    std::string name;
+    std::vector<int32_t> owners;
+};
+
+std::mutex snapshot_mutex;
+std::condition_variable snapshot_cv;
+std::deque<PendingRecord> pending_records;
+std::vector<std::vector<int32_t>> spare_buffers; // Recycled owner arrays, avoids per-capture allocation
+std::thread writer_thread;
+std::atomic<bool> stream_running(false);
+std::atomic<long> captured_count(0);
+std::atomic<long> dropped_count(0);
+
+template <typename T>
+void write_raw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writer_loop(std::string path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::vector<int32_t> last_owners;
+    uint64_t sequence = 0;
+
+    out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    write_raw(out, SNAPSHOT_VERSION);
+    write_raw(out, static_cast<uint32_t>(FRAME_COUNT));
+    write_raw(out, static_cast<uint32_t>(MEM_PER_FRAME));
+
+    std::deque<PendingRecord> batch;
+    std::vector<uint32_t> changed;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(snapshot_mutex);
+            snapshot_cv.wait(lock, [] { return !pending_records.empty() || !stream_running; });
+            if (pending_records.empty() && !stream_running) break;
+            batch.swap(pending_records);
+        }
+
+        for (auto& record : batch) {
+            if (record.type == SNAPSHOT_RECORD_NAME) {
+                uint16_t length = static_cast<uint16_t>(std::min<size_t>(record.name.size(), UINT16_MAX));
+                write_raw(out, SNAPSHOT_RECORD_NAME);
+                write_raw(out, static_cast<int32_t>(record.pid));
+                write_raw(out, length);
+                out.write(record.name.data(), length);
+                continue;
+            }
+
+            // Frames start out free, so the first record only lists occupied frames.
+            if (last_owners.size() != record.owners.size()) {
+                last_owners.assign(record.owners.size(), -1);
+            }
+            changed.clear();
+            for (uint32_t i = 0; i < record.owners.size(); ++i) {
+                if (record.owners[i] != last_owners[i]) { changed.push_back(i); }
+            }
+            write_raw(out, SNAPSHOT_RECORD_FRAMES);
+            write_raw(out, sequence++);
+            write_raw(out, record.timestamp_ms);
+            write_raw(out, static_cast<uint32_t>(changed.size()));
+            for (uint32_t index : changed) {
+                write_raw(out, index);
+                write_raw(out, record.owners[index]);
+            }
+            last_owners.swap(record.owners);
+        }
+        out.flush();
+
+        std::unique_lock<std::mutex> lock(snapshot_mutex);
+        for (auto& record : batch) {
+            if (record.owners.capacity() > 0) { spare_buffers.push_back(std::move(record.owners)); }
+        }
+        batch.clear();
+        lock.unlock();
+        std::this_thread::sleep_for(WRITE_INTERVAL);
+    }
+}
+
+// The writer only waits when nothing is pending, so only the first record of a batch wakes it.
+void enqueue(PendingRecord&& record) {
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        if (pending_records.size() >= MAX_PENDING_RECORDS) {
+            dropped_count++;
+            return;
+        }
+        first = pending_records.empty();
+        pending_records.push_back(std::move(record));
+    }
+    if (first) snapshot_cv.notify_one();
+}
+
+} // end anonymous namespace
+
+void snapshot_stream_start(const std::string& path) {
+    if (stream_running.exchange(true)) return;
+    writer_thread = std::thread(writer_loop, path);
+    // 'exit' ends the program from inside processCommand; drain the stream first.
+    static bool stop_registered = false;
+    if (!stop_registered) {
+        std::atexit(snapshot_stream_stop);
+        stop_registered = true;
+    }
+}
+
+void snapshot_stream_stop() {
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        if (!stream_running) return;
+        stream_running = false;
+    }
+    snapshot_cv.notify_all();
+    if (writer_thread.joinable()) { writer_thread.join(); }
+}
+
+void snapshot_capture() {
+    if (!stream_running || memory_manager == nullptr) return;
+
+    PendingRecord record;
+    record.type = SNAPSHOT_RECORD_FRAMES;
+    record.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        if (!spare_buffers.empty()) {
+            record.owners = std::move(spare_buffers.back());
+            spare_buffers.pop_back();
+        }
+    }
+    memory_manager->copy_frame_owners(record.owners);
+    captured_count++;
+    enqueue(std::move(record));
+}
+
+void snapshot_register_process(int pid, const std::string& name) {
+    if (!stream_running) return;
+    PendingRecord record;
+    record.type = SNAPSHOT_RECORD_NAME;
+    record.pid = pid;
+    record.name = name;
+    enqueue(std::move(record));
+}
+
+long snapshot_captured_count() { return captured_count; }
+long snapshot_dropped_count()  { return dropped_count; }
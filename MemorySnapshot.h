@@ -0,0 +1,32 @@
+#ifndef MEMORY_SNAPSHOT_H
+#define MEMORY_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+
+// --- Snapshot Stream File Format ---
+// Header:  magic "CSMS", u32 version, u32 frame_count, u32 mem_per_frame
+// Records: u8 type followed by the record body
+//   SNAPSHOT_RECORD_FRAMES: u64 sequence, i64 timestamp_ms, u32 changed_count,
+//                           changed_count x (u32 frame_index, i32 owner_pid), owner -1 = free
+//   SNAPSHOT_RECORD_NAME:   i32 pid, u16 name_length, name bytes
+// Frame records only hold the frames that changed since the previous frame record.
+const char SNAPSHOT_MAGIC[4] = {'C', 'S', 'M', 'S'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint8_t SNAPSHOT_RECORD_FRAMES = 1;
+const uint8_t SNAPSHOT_RECORD_NAME = 2;
+const std::string SNAPSHOT_STREAM_FILE = "csopesy-memory-snapshots.bin";
+
+// --- Recording (background writer thread) ---
+void snapshot_stream_start(const std::string& path = SNAPSHOT_STREAM_FILE);
+void snapshot_stream_stop();
+
+// Copies the frame table and hands it to the writer; safe to call every quantum.
+void snapshot_capture();
+// Records the name the offline tool should show for a PID.
+void snapshot_register_process(int pid, const std::string& name);
+
+long snapshot_captured_count();
+long snapshot_dropped_count();
+
+#endif // MEMORY_SNAPSHOT_H
@@ -0,0 +1,83 @@
+#include "NumaTopology.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "config.h"
+
+bool parse_numa_placement(const std::string& name, NumaPlacement& placement) {
+    if (name == "first-free") placement = NumaPlacement::FIRST_FREE;
+    else if (name == "local") placement = NumaPlacement::LOCAL;
+    else if (name == "interleave") placement = NumaPlacement::INTERLEAVE;
+    else return false;
+    return true;
+}
+
+const char* numa_placement_name(NumaPlacement placement) {
+    switch (placement) {
+        case NumaPlacement::LOCAL: return "local";
+        case NumaPlacement::INTERLEAVE: return "interleave";
+        default: return "first-free";
+    }
+}
+
+namespace {
+
+// Per-node shares of total: the listed counts (clamped to what is left), then an even split of the
+// rest over the unlisted nodes, the last taking the remainder.
+std::vector<int> split_counts(int nodes, const std::string& listed, int total) {
+    std::vector<int> counts;
+    std::istringstream in(listed);
+    int count, left = total;
+    while (static_cast<int>(counts.size()) < nodes && in >> count) {
+        count = std::clamp(count, 0, left);
+        counts.push_back(count);
+        left -= count;
+    }
+    int unlisted = nodes - static_cast<int>(counts.size());
+    for (int i = 0; i < unlisted; ++i) {
+        int share = i + 1 == unlisted ? left : left / (unlisted - i);
+        counts.push_back(share);
+        left -= share;
+    }
+    if (left > 0) counts.back() += left;
+    return counts;
+}
+
+} // end anonymous namespace
+
+void NumaTopology::build(int nodes, const std::string& core_counts, const std::string& frame_counts, int cores, int frames) {
+    nodes = std::max(1, nodes);
+    frame_start_.assign(1, 0);
+    for (int count : split_counts(nodes, frame_counts, frames)) frame_start_.push_back(frame_start_.back() + count);
+
+    core_counts_ = core_counts;
+    set_cores(cores);
+}
+
+void NumaTopology::set_cores(int cores) {
+    cores = std::clamp(cores, 0, MAX_CORES);
+    std::vector<int> per_node = split_counts(nodes(), core_counts_, cores);
+    int core = 0;
+    for (int node = 0; node < nodes(); ++node) {
+        for (int i = 0; i < per_node[node]; ++i) core_node_[core++] = node;
+    }
+    cores_ = cores;
+}
+
+int NumaTopology::node_of_frame(int frame) const {
+    // Few nodes: a linear scan of the boundaries is as quick as a binary search.
+    int node = 0;
+    while (node + 1 < nodes() && frame >= frame_start_[node + 1]) node++;
+    return node;
+}
+
+int NumaTopology::cores_of(int node) const {
+    return static_cast<int>(std::count(core_node_.begin(), core_node_.begin() + cores_, node));
+}
+
+NumaTopology numa_topology_from_globals(int cores, int frames) {
+    NumaTopology topology;
+    topology.build(NUMA_NODES, NUMA_NODE_CORES, NUMA_NODE_FRAMES, cores, frames);
+    return topology;
+}
@@ -0,0 +1,58 @@
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where a page fault takes its frame from when numa-nodes splits memory into nodes.
+enum class NumaPlacement : uint8_t {
+    FIRST_FREE, // Lowest free frame anywhere, as without NUMA
+    LOCAL,      // The node of the faulting process's core first, then the others
+    INTERLEAVE  // Pages spread round robin over the nodes by page number
+};
+
+// Maps a config.txt numa-placement name ("first-free", "local", "interleave") to its placement.
+bool parse_numa_placement(const std::string& name, NumaPlacement& placement);
+const char* numa_placement_name(NumaPlacement placement);
+
+// --- NUMA Topology ---
+// Simulated nodes, each owning a contiguous range of cores and a contiguous range of frames. An
+// access from a core to a frame of another node is remote and costs extra ticks (see
+// MemoryManager::access_memory). One node, the default, makes every access local.
+class NumaTopology {
+public:
+    static constexpr int MAX_CORES = 128;
+
+    // Splits cores and frames over nodes nodes. core_counts and frame_counts list how many each node
+    // owns, e.g. "2 6"; nodes they leave out share what is left evenly.
+    void build(int nodes, const std::string& core_counts, const std::string& frame_counts, int cores, int frames);
+    // cpu-set: splits a new core count over the same nodes by the same core_counts. The core table is
+    // rewritten in place, so a core reading it meanwhile sees its old node or its new one.
+    void set_cores(int cores);
+
+    int nodes() const { return static_cast<int>(frame_start_.size()) - 1; }
+    bool enabled() const { return nodes() > 1; }
+
+    // Node of a core, 0 for -1 (a process that has not run yet) and cores past the table.
+    int node_of_core(int core) const {
+        return core >= 0 && core < cores_ ? core_node_[core] : 0;
+    }
+    int node_of_frame(int frame) const;
+    // Frames [first_frame(node), end_frame(node)) belong to node.
+    int first_frame(int node) const { return frame_start_[node]; }
+    int end_frame(int node) const { return frame_start_[node + 1]; }
+    int cores_of(int node) const;
+
+private:
+    std::array<int, MAX_CORES> core_node_{}; // Core -> node
+    int cores_ = 0;
+    std::string core_counts_;
+    std::vector<int> frame_start_ = {0, 0}; // nodes() + 1 boundaries
+};
+
+// The topology config.txt describes: numa-nodes, numa-node-cores and numa-node-frames.
+NumaTopology numa_topology_from_globals(int cores, int frames);
+
+#endif // NUMA_TOPOLOGY_H
@@ -0,0 +1,94 @@
+#include "PrintLog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+PrintLog::~PrintLog() {
+    for (auto& chunk : chunks_) delete[] chunk.load(std::memory_order_relaxed);
+}
+
+void PrintLog::append(const std::string& text, int core, int64_t timestamp_ms) {
+    uint64_t sequence = written_.load(std::memory_order_relaxed);
+    std::atomic<Slot*>& chunk = chunks_[sequence % CAPACITY / CHUNK_LINES];
+    Slot* slots = chunk.load(std::memory_order_relaxed);
+    if (slots == nullptr) {
+        slots = new Slot[CHUNK_LINES];
+        chunk.store(slots, std::memory_order_release);
+    }
+    Slot& slot = slots[sequence % CHUNK_LINES];
+
+    // Mark the slot as being rewritten before touching its contents.
+    slot.version.store(2 * sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t packed[LINE_WORDS] = {};
+    size_t length = std::min(text.size(), static_cast<size_t>(LINE_BYTES));
+    std::memcpy(packed, text.data(), length);
+    slot.timestamp_ms.store(timestamp_ms, std::memory_order_relaxed);
+    slot.core.store(core, std::memory_order_relaxed);
+    slot.length.store(static_cast<uint32_t>(length), std::memory_order_relaxed);
+    for (int i = 0; i < LINE_WORDS; ++i) slot.words[i].store(packed[i], std::memory_order_relaxed);
+
+    slot.version.store(2 * (sequence + 1), std::memory_order_release);
+    written_.store(sequence + 1, std::memory_order_release);
+}
+
+bool PrintLog::read_slot(uint64_t sequence, Line& line) const {
+    const Slot* slots = chunks_[sequence % CAPACITY / CHUNK_LINES].load(std::memory_order_acquire);
+    if (slots == nullptr) return false;
+    const Slot& slot = slots[sequence % CHUNK_LINES];
+    const uint64_t complete = 2 * (sequence + 1);
+    if (slot.version.load(std::memory_order_acquire) != complete) return false;
+
+    uint64_t packed[LINE_WORDS];
+    int64_t timestamp_ms = slot.timestamp_ms.load(std::memory_order_relaxed);
+    int32_t core = slot.core.load(std::memory_order_relaxed);
+    uint32_t length = slot.length.load(std::memory_order_relaxed);
+    for (int i = 0; i < LINE_WORDS; ++i) packed[i] = slot.words[i].load(std::memory_order_relaxed);
+
+    // The writer lapped us while copying: drop the line rather than make the writer wait.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != complete) return false;
+
+    line.sequence = sequence;
+    line.timestamp_ms = timestamp_ms;
+    line.core = core;
+    line.text.assign(reinterpret_cast<const char*>(packed), std::min<uint32_t>(length, LINE_BYTES));
+    return true;
+}
+
+std::vector<PrintLog::Line> PrintLog::read_since(uint64_t from) const {
+    uint64_t end = written();
+    uint64_t begin = std::max(from, end > CAPACITY ? end - CAPACITY : 0);
+    std::vector<Line> lines;
+    lines.reserve(end > begin ? end - begin : 0);
+    Line line;
+    for (uint64_t sequence = begin; sequence < end; ++sequence) {
+        if (read_slot(sequence, line)) lines.push_back(line);
+    }
+    return lines;
+}
+
+std::vector<PrintLog::Line> PrintLog::tail(size_t count) const {
+    uint64_t end = written();
+    return read_since(end - std::min<uint64_t>(count, end));
+}
+
+// --- Name Lookup ---
+namespace {
+std::mutex registry_mutex;
+std::unordered_map<std::string, std::weak_ptr<PrintLog>> registry;
+} // end anonymous namespace
+
+void print_log_register(const std::string& process_name, const std::shared_ptr<PrintLog>& log) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry[process_name] = log;
+}
+
+std::shared_ptr<PrintLog> print_log_find(const std::string& process_name) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry.find(process_name);
+    return it != registry.end() ? it->second.lock() : nullptr;
+}
@@ -0,0 +1,73 @@
+#ifndef PRINT_LOG_H
+#define PRINT_LOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// PRINT output lines kept per process.
+constexpr int PRINT_LOG_LINES = 100;
+
+// Fixed-size ring of one process's PRINT output. The only writer is the core running the process;
+// any number of readers (screen -r) copy lines out concurrently. Neither side takes a lock: every
+// slot is a seqlock, and a reader that the writer laps mid-copy sees the slot's version change and
+// drops that line, so the writer never waits for a reader. Slots are allocated a chunk at a time as
+// the ring first fills, so a process that prints a few lines holds one chunk rather than the ring.
+class PrintLog {
+public:
+    static constexpr int CAPACITY = PRINT_LOG_LINES;
+    static constexpr int LINE_BYTES = 128; // Longer lines are truncated
+
+    struct Line {
+        uint64_t sequence;    // 0 for the process's first line
+        int64_t timestamp_ms; // System clock, milliseconds since the epoch
+        int core;             // Core that ran the PRINT, -1 if none
+        std::string text;
+    };
+
+    PrintLog() = default;
+    PrintLog(const PrintLog&) = delete;
+    PrintLog& operator=(const PrintLog&) = delete;
+    ~PrintLog();
+
+    // Writer side; only one thread at a time.
+    void append(const std::string& text, int core, int64_t timestamp_ms);
+
+    // Lines with sequence >= from that are still in the ring, oldest first.
+    std::vector<Line> read_since(uint64_t from) const;
+    // The newest count lines, oldest first.
+    std::vector<Line> tail(size_t count) const;
+    // Lines written so far; the next line gets this sequence number.
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr int LINE_WORDS = LINE_BYTES / 8;
+    static constexpr int CHUNK_LINES = 10;
+    static constexpr int CHUNKS = CAPACITY / CHUNK_LINES;
+    static_assert(CAPACITY % CHUNK_LINES == 0, "the ring must be a whole number of chunks");
+
+    struct Slot {
+        // 2 * (sequence + 1) once the line is complete, odd while the writer is filling it.
+        std::atomic<uint64_t> version{0};
+        std::atomic<int64_t> timestamp_ms{0};
+        std::atomic<int32_t> core{-1};
+        std::atomic<uint32_t> length{0};
+        std::atomic<uint64_t> words[LINE_WORDS] = {};
+    };
+
+    bool read_slot(uint64_t sequence, Line& line) const;
+
+    std::atomic<Slot*> chunks_[CHUNKS] = {};
+    std::atomic<uint64_t> written_{0};
+};
+
+// --- Name Lookup ---
+// screen -r finds a process's log by name without touching the scheduler lists. The registry holds
+// weak references and has its own lock; the newest process with a name wins. A process registers
+// when it is created, with no log until its first PRINT, so an older namesake's output goes away.
+void print_log_register(const std::string& process_name, const std::shared_ptr<PrintLog>& log);
+std::shared_ptr<PrintLog> print_log_find(const std::string& process_name);
+
+#endif // PRINT_LOG_H
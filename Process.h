@@ -8,77 +8,156 @@
 #include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include "Instruction.h"
+#include "PrintLog.h"
 
-enum class ProcessState {
+enum class ProcessState : uint8_t {
     NEW,
     READY,
     RUNNING,
     BLOCKED,
+    SLEEPING, // Parked on the scheduler's timer wheel until its wake tick
     FINISHED
 };
 
+// A flag one thread sets and another reads and clears, with relaxed atomics. Copyable, so the page
+// table it sits in can still be resized.
+struct RelaxedFlag {
+    std::atomic<bool> value{false};
+
+    RelaxedFlag() = default;
+    RelaxedFlag(const RelaxedFlag& other) : value(other.load()) {}
+    RelaxedFlag& operator=(const RelaxedFlag& other) { store(other.load()); return *this; }
+
+    bool load() const { return value.load(std::memory_order_relaxed); }
+    void store(bool flag) { value.store(flag, std::memory_order_relaxed); }
+    bool exchange(bool flag) { return value.exchange(flag, std::memory_order_relaxed); }
+};
+
 struct PageTableEntry {
     bool is_present = false;
     bool is_dirty = false;
+    bool is_huge = false; // Part of a naturally aligned run of HUGE_PAGE_FRAMES pages
+    bool in_backing_store = false; // Page has been written back at least once
+    RelaxedFlag is_referenced; // Set by the core on every access, harvested by the working-set sampler thread
+    unsigned char reference_history = 0; // One bit per sample, newest in bit 0
     int frame_index = -1;
 };
 
+// Size of the simulated per-process translation cache (statistics only).
+constexpr int TLB_ENTRIES = 16;
+
 struct MemoryData {
-    size_t memory_size_bytes;
-    long long creation_timestamp;
-    long backing_store_offset;
-    std::vector<PageTableEntry> page_table;
+    size_t memory_size_bytes = 0;
+    long long creation_timestamp = 0;
+    long backing_store_offset = 0;
     bool terminated_by_error = false;
-    std::string termination_reason = "";
-    
+
+    // --- Sequential access detection for huge page mappings ---
+    int last_page_accessed = -1;
+    int sequential_streak = 0;
+
+    // --- Paging counters. Relaxed atomics: evictions are charged from other cores. ---
+    std::atomic<uint64_t> minor_faults{0}; // Resolved without reading the backing store
+    std::atomic<uint64_t> major_faults{0};
+    std::atomic<uint64_t> pages_evicted{0};
+    std::atomic<uint64_t> bytes_read_from_store{0};
+    std::atomic<uint64_t> bytes_written_to_store{0};
+
+    // --- Working set, refreshed by the sampler ---
+    int working_set_pages = 0;
+    int peak_working_set_pages = 0;
+
+    // --- Deferred page faults (see ProcessCoroutine.h) ---
+    // With defer_page_faults set, a fault only records its page here and fails the access; the
+    // owner resolves it later, off the core, with MemoryManager::resolve_page_fault().
+    bool defer_page_faults = false;
+    int pending_fault_page = -1;
+
+    // Direct-mapped translation cache. Stores (tag + 1) so that 0 means empty.
+    long long tlb_tags[TLB_ENTRIES] = {};
+};
+
+// The parts of a process the schedulers never read while deciding what runs: its name, PRINT output,
+// termination reason, page table and the lock its page faults take. They are allocated once per
+// process next to the PCB rather than inside it, so the process table's slabs stay dense. The PRINT
+// log is only allocated by the first PRINT (see process_print_log()), since most processes never print.
+struct ProcessColdData {
+    std::string processName;
+    std::shared_ptr<PrintLog> output; // PRINT output, null before the first PRINT; screen -r reads it lock-free
+    std::string termination_reason;
+    std::vector<PageTableEntry> page_table;
     std::mutex page_fault_mutex;
-    std::condition_variable page_fault_cv;
+    // Variable writes a lockstep group could not store back, as (slot, value); interpreter_run
+    // stores them before running anything else. See interpreter_run_lockstep.
+    std::vector<std::pair<int, uint16_t>> pending_stores;
 };
 
+// Tick fields of a process that has not reached that point yet.
+constexpr uint64_t NOT_YET_TICK = UINT64_MAX;
+
+// Slot of a PCB in the process table (see ProcessTable.h).
+using ProcessIndex = int32_t;
+constexpr ProcessIndex NO_PROCESS = -1;
+
+// Cold, per-process state. Scheduling state (state, core, quantum ticks, priority) is kept in the
+// process table's dense arrays instead; see ProcessTable.h.
 class Process {
 public:
     int id;
-    std::string processName;
-    ProcessState state;
-    
-    // --- ADDED: For scheduler logic and statistics ---
-    int arrival_time;
-    int cpu_burst_time;
-    int io_burst_time;
-    
-    int remaining_burst_time;
-    int io_remaining_time;
-    int instructions_per_run;
-    int assigned_core = -1;
+    std::unique_ptr<ProcessColdData> cold = std::make_unique<ProcessColdData>();
+    ProcessIndex table_index = NO_PROCESS; // NO_PROCESS for PCBs outside the table, e.g. benchmarks
     int program_counter = 0;
-    int commands_executed_this_quantum = 0;
-    std::vector<std::string> commands;
     size_t memory_size = 0;
-    std::vector<std::tuple<std::string, uint16_t>> variables;
+
+    // --- Interpreter state (see Interpreter.h) ---
+    // program_counter indexes image->code. The image is shared with every process running the
+    // same commands; variable values are kept in the symbol table at the start of process memory.
+    std::shared_ptr<const ProgramImage> image;
+    LoopFrame loop_stack[MAX_FOR_DEPTH];
+    int loop_depth = 0;
+    int sleep_ticks_remaining = 0;
+    int stall_ticks = 0; // Cache-miss ticks run up by the current instruction, see CoreCache.h
+    uint64_t wake_tick = 0; // CPU tick a SLEEPING process wakes at
 
     // --- ADDED: For timing ---
     std::chrono::time_point<std::chrono::system_clock> start_time;
     std::chrono::time_point<std::chrono::system_clock> finish_time;
+    // The same moments on the CPU clock (get_cpu_clock_ticks()), for response and turnaround times.
+    uint64_t arrival_tick = 0;
+    uint64_t first_run_tick = NOT_YET_TICK; // Start of the first quantum that executed an instruction
+    uint64_t finish_tick = NOT_YET_TICK;
+    // Ticks executed so far. Written by the core running the process, read by reports while it runs.
+    std::atomic<uint64_t> ticks_executed{0};
+    uint64_t left_core_tick = 0; // Last time it left a core, for cache-affinity dispatch
+
+    // --- Proportional share (stride and lottery policies, see ReadyQueue.h) ---
+    uint32_t weight = 1;      // Tickets: the share of the cores asked for, relative to other processes
+    uint64_t stride_pass = 0; // Stride: virtual time used so far, advanced by ticks / weight
+
+    // --- Deadline (EDF policy, see ReadyQueue.h) ---
+    uint64_t deadline_tick = NOT_YET_TICK; // CPU tick the process must finish by, NOT_YET_TICK for none
+    uint64_t work_ticks = 0;               // Estimated ticks to run to the end, see program_ticks()
+    bool deadline_rejected = false;        // Failed the EDF admission test and runs as best effort
 
     MemoryData mem_data;
-    
-    // --- ADDED: A new constructor that takes a single integer ID ---
-    // This constructor matches the call std::make_shared<Process>(cpuClocks++)
-    Process(int id) 
-        : id(id), processName("P" + std::to_string(id)), state(ProcessState::NEW), 
-          arrival_time(0), cpu_burst_time(0), io_burst_time(0), 
-          remaining_burst_time(0), io_remaining_time(0), instructions_per_run(0) {}
-
-    // Default constructor
-    Process() : id(-1), processName(""), state(ProcessState::NEW), 
-                arrival_time(0), cpu_burst_time(0), remaining_burst_time(0),
-                io_burst_time(0), io_remaining_time(0), instructions_per_run(0) {}
-
-    // Existing constructor
-    Process(int id, const std::string& name, int arrival, int cpu_burst, int io_burst)
-        : id(id), processName(name), state(ProcessState::NEW), 
-          arrival_time(arrival), cpu_burst_time(cpu_burst), remaining_burst_time(cpu_burst),
-          io_burst_time(io_burst), io_remaining_time(io_burst), instructions_per_run(0) {}
+
+    explicit Process(int id = -1) : id(id) {
+        if (id >= 0) cold->processName = "P" + std::to_string(id);
+    }
 };
 
+// The process's PRINT log, allocated and registered for screen -r on first use. Only the thread
+// running the process, or one that holds it stopped, may call this.
+inline PrintLog& process_print_log(Process& process) {
+    if (!process.cold->output) {
+        process.cold->output = std::make_shared<PrintLog>();
+        print_log_register(process.cold->processName, process.cold->output);
+    }
+    return *process.cold->output;
+}
+
 #endif // PROCESS_H
\ No newline at end of file
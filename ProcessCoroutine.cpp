@@ -0,0 +1,198 @@
+#include "ProcessCoroutine.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "global.h"
+
+namespace {
+
+std::atomic<size_t> g_live_frame_bytes{0};
+
+} // end anonymous namespace
+
+// --- Process Coroutines ---
+void* ProcessTask::promise_type::operator new(size_t bytes) {
+    g_live_frame_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    return ::operator new(bytes);
+}
+
+void ProcessTask::promise_type::operator delete(void* frame, size_t bytes) {
+    g_live_frame_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    ::operator delete(frame);
+}
+
+size_t ProcessTask::live_frame_bytes() {
+    return g_live_frame_bytes.load(std::memory_order_relaxed);
+}
+
+void ProcessTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+    CoroutineHost& host = *handle.promise().host;
+    ProcessIndex index = handle.promise().index;
+    ExecStatus status = handle.promise().status;
+    handle.destroy();
+    host.retire(index, status);
+}
+
+ProcessTask run_process(CoroutineHost& host, Process& process, ProcessIndex index) {
+    for (;;) {
+        ExecStatus status = host.run_quantum(process, index);
+        switch (status) {
+            case ExecStatus::RUNNING:
+                co_await QuantumExpired{host, index};
+                break;
+            case ExecStatus::BLOCKED:
+                // The faulting instruction runs again once the page is in.
+                co_await PageFault{host, process, index};
+                break;
+            case ExecStatus::SLEEPING:
+                co_await SleepTicks{host, index, static_cast<uint64_t>(process.sleep_ticks_remaining)};
+                process.sleep_ticks_remaining = 0;
+                break;
+            default:
+                co_return status;
+        }
+    }
+}
+
+// --- Awaitables ---
+void QuantumExpired::await_suspend(std::coroutine_handle<> handle) {
+    host.quantum_expired(index, handle);
+}
+
+void PageFault::await_suspend(std::coroutine_handle<> handle) {
+    host.page_fault(process, index, handle);
+}
+
+void SleepTicks::await_suspend(std::coroutine_handle<> handle) {
+    host.sleep(index, ticks, handle);
+}
+
+// --- Coroutine Executor ---
+CoroutineExecutor::CoroutineExecutor(ProcessTable& table, int host_threads, int quantum)
+    : table_(table), host_threads_(std::max(1, host_threads)), quantum_(std::max(1, quantum)) {}
+
+CoroutineExecutor::~CoroutineExecutor() {
+    for (std::coroutine_handle<> handle : handles_) {
+        if (handle) handle.destroy();
+    }
+}
+
+void CoroutineExecutor::spawn(ProcessIndex index) {
+    Process& process = table_[index];
+    process.mem_data.defer_page_faults = true;
+    ProcessTask task = run_process(*this, process, index);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (handles_.size() <= static_cast<size_t>(index)) handles_.resize(static_cast<size_t>(index) + 1);
+    handles_[index] = task.handle();
+    ready_.push_back(task.handle());
+    live_++;
+    peak_live_ = std::max(peak_live_, live_);
+}
+
+void CoroutineExecutor::run() {
+    std::thread pager(&CoroutineExecutor::pager_loop, this);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < host_threads_; ++i) {
+        threads.emplace_back(&CoroutineExecutor::host_thread_loop, this);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    pager.join();
+}
+
+ExecStatus CoroutineExecutor::run_quantum(Process& process, ProcessIndex) {
+    int ticks = 0;
+    ExecStatus status = interpreter_run(process, quantum_, ticks);
+    executed_ticks_.fetch_add(static_cast<uint64_t>(ticks), std::memory_order_relaxed);
+    process.ticks_executed.fetch_add(static_cast<uint64_t>(ticks), std::memory_order_relaxed);
+    return status;
+}
+
+void CoroutineExecutor::quantum_expired(ProcessIndex, std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    preemptions_++;
+    ready_.push_back(handle);
+    ready_cv_.notify_one();
+}
+
+void CoroutineExecutor::page_fault(Process& process, ProcessIndex, std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    page_faults_++;
+    faults_.emplace_back(&process, handle);
+    pager_cv_.notify_one();
+}
+
+void CoroutineExecutor::sleep(ProcessIndex index, uint64_t ticks, std::coroutine_handle<>) {
+    // The wheel holds the index; handles_ maps it back to this coroutine when it wakes.
+    std::lock_guard<std::mutex> lock(mutex_);
+    sleeps_++;
+    sleepers_.schedule(index, now_locked() + ticks);
+}
+
+void CoroutineExecutor::retire(ProcessIndex index, ExecStatus status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handles_[index] = nullptr;
+    if (status == ExecStatus::TERMINATED) terminated_++;
+    else finished_++;
+    if (--live_ == 0) {
+        ready_cv_.notify_all();
+        pager_cv_.notify_all();
+    }
+}
+
+void CoroutineExecutor::wake_sleepers_locked() {
+    if (sleepers_.empty() || now_locked() < sleepers_.next_event_tick()) return;
+    sleepers_.advance(now_locked(), woken_);
+    for (ProcessIndex index : woken_) ready_.push_back(handles_[index]);
+    if (woken_.size() > 1) ready_cv_.notify_all();
+    woken_.clear();
+}
+
+void CoroutineExecutor::host_thread_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_sleepers_locked();
+        if (ready_.empty()) {
+            if (live_ == 0) break;
+            if (running_ == 0 && paging_ == 0 && faults_.empty() && !sleepers_.empty()) {
+                // Every process left is asleep: skip the clock to the next wake-up, as the schedulers do.
+                uint64_t now = now_locked();
+                uint64_t next = sleepers_.next_event_tick();
+                idle_ticks_ += (next > now ? next - now : 1) * static_cast<uint64_t>(host_threads_);
+                continue;
+            }
+            ready_cv_.wait(lock);
+            continue;
+        }
+        std::coroutine_handle<> handle = ready_.front();
+        ready_.pop_front();
+        running_++;
+        resumes_++;
+        lock.unlock();
+        // Runs until the process's next co_await, which has queued or parked it again by the time
+        // resume() returns; the handle may already be running on another host thread.
+        handle.resume();
+        lock.lock();
+        running_--;
+    }
+    ready_cv_.notify_all();
+}
+
+void CoroutineExecutor::pager_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        pager_cv_.wait(lock, [this] { return !faults_.empty() || live_ == 0; });
+        if (faults_.empty()) break;
+        auto [process, handle] = faults_.front();
+        faults_.pop_front();
+        paging_++;
+        lock.unlock();
+        memory_manager->resolve_page_fault(*process);
+        lock.lock();
+        paging_--;
+        ready_.push_back(handle);
+        ready_cv_.notify_one();
+    }
+}
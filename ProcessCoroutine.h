@@ -0,0 +1,190 @@
+#ifndef PROCESS_COROUTINE_H
+#define PROCESS_COROUTINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Interpreter.h"
+#include "ProcessTable.h"
+#include "TimerWheel.h"
+
+// --- Coroutine Hosts ---
+// What runs process coroutines: how a quantum is executed and where a suspended coroutine waits.
+// CoroutineExecutor is a self-contained host with its own run queue, timer wheel and pager; the RR
+// scheduler's core-threads "coroutine" mode is another that keeps its ready-queue policy. The hooks
+// run on the host thread that resumed the coroutine. Once one has handed the coroutine on, another
+// thread may resume it, so the hook is the last thing to touch it.
+class CoroutineHost {
+public:
+    virtual ~CoroutineHost() = default;
+
+    // One quantum of process; adds the ticks to process.ticks_executed.
+    virtual ExecStatus run_quantum(Process& process, ProcessIndex index) = 0;
+    // The quantum is spent: queue the process to run again.
+    virtual void quantum_expired(ProcessIndex index, std::coroutine_handle<> handle) = 0;
+    // The interpreter stopped on a deferred page fault (mem_data.pending_fault_page): bring the page
+    // in off the core, then queue the process to retry the instruction.
+    virtual void page_fault(Process& process, ProcessIndex index, std::coroutine_handle<> handle) = 0;
+    // SLEEP: queue the process again once ticks have passed.
+    virtual void sleep(ProcessIndex index, uint64_t ticks, std::coroutine_handle<> handle) = 0;
+    // The process finished or was terminated; its frame is already destroyed.
+    virtual void retire(ProcessIndex index, ExecStatus status) = 0;
+};
+
+// --- Process Coroutines ---
+// A process executed as a C++20 coroutine. Its body runs the interpreter a quantum at a time and,
+// wherever the process would otherwise hold up a host thread, co_awaits one of the awaitables
+// below. Each parks the suspended coroutine with its host where it waits: the run queue when the
+// quantum is spent, the pager on a page fault, a timer wheel on SLEEP. Whatever ends the wait
+// queues the process again, and any host thread resumes it from there, so a dispatch is one
+// resume(). A finished coroutine destroys its own frame.
+class ProcessTask {
+public:
+    struct promise_type {
+        CoroutineHost* host;
+        ProcessIndex index;
+        ExecStatus status = ExecStatus::FINISHED;
+
+        promise_type(CoroutineHost& host, Process&, ProcessIndex index) : host(&host), index(index) {}
+
+        ProcessTask get_return_object() { return ProcessTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        // Created suspended; CoroutineExecutor::spawn() queues it.
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(ExecStatus result) { status = result; }
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        // Frames are counted so benchmarks can report their size.
+        static void* operator new(size_t bytes);
+        static void operator delete(void* frame, size_t bytes);
+    };
+
+    std::coroutine_handle<promise_type> handle() const { return handle_; }
+
+    // Bytes of coroutine frames currently allocated, across every executor.
+    static size_t live_frame_bytes();
+
+private:
+    explicit ProcessTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// The body of every process coroutine: index is the process's slot in the host's process table.
+ProcessTask run_process(CoroutineHost& host, Process& process, ProcessIndex index);
+
+// --- Awaitables ---
+// await_suspend() hands the handle over last: once it is queued, another host thread may resume the
+// coroutine and the awaitable, which lives in the frame, must not be touched again.
+struct QuantumExpired {
+    CoroutineHost& host;
+    ProcessIndex index;
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() noexcept {}
+};
+
+// The interpreter stopped on a deferred page fault; the host's pager brings the page in and queues
+// the process to retry the instruction.
+struct PageFault {
+    CoroutineHost& host;
+    Process& process;
+    ProcessIndex index;
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() noexcept {}
+};
+
+// SLEEP: parked on the host's timer wheel until its clock reaches the wake tick.
+struct SleepTicks {
+    CoroutineHost& host;
+    ProcessIndex index;
+    uint64_t ticks;
+    bool await_ready() noexcept { return ticks == 0; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() noexcept {}
+};
+
+// --- Coroutine Executor ---
+// Runs the processes of a process table as coroutines on host_threads host threads plus one pager
+// thread. The processes' page faults are deferred (see MemoryData::defer_page_faults), so a host
+// thread never waits on the backing store; it resumes the next ready process instead. The clock
+// that SLEEP counts in is the ticks executed per host thread, skipped ahead like the schedulers'
+// CPU clock when every process is asleep.
+class CoroutineExecutor : public CoroutineHost {
+public:
+    CoroutineExecutor(ProcessTable& table, int host_threads, int quantum);
+    CoroutineExecutor(const CoroutineExecutor&) = delete;
+    CoroutineExecutor& operator=(const CoroutineExecutor&) = delete;
+    // Destroys the frames of processes that never finished.
+    ~CoroutineExecutor() override;
+
+    // Creates the suspended coroutine of a loaded process in table and queues it. Not during run().
+    void spawn(ProcessIndex index);
+    // Resumes processes until every spawned one has finished or terminated.
+    void run();
+
+    int quantum() const { return quantum_; }
+    int host_threads() const { return host_threads_; }
+
+    // Counters, for benchmarks; read them after run().
+    uint64_t resumes() const { return resumes_; }
+    uint64_t preemptions() const { return preemptions_; }
+    uint64_t page_faults() const { return page_faults_; }
+    uint64_t sleeps() const { return sleeps_; }
+    uint64_t executed_ticks() const { return executed_ticks_.load(std::memory_order_relaxed); }
+    size_t finished() const { return finished_; }
+    size_t terminated() const { return terminated_; }
+    size_t peak_live() const { return peak_live_; }
+
+private:
+    ExecStatus run_quantum(Process& process, ProcessIndex index) override;
+    void quantum_expired(ProcessIndex index, std::coroutine_handle<> handle) override;
+    void page_fault(Process& process, ProcessIndex index, std::coroutine_handle<> handle) override;
+    void sleep(ProcessIndex index, uint64_t ticks, std::coroutine_handle<> handle) override;
+    void retire(ProcessIndex index, ExecStatus status) override;
+
+    void host_thread_loop();
+    void pager_loop();
+    // Caller holds mutex_.
+    uint64_t now_locked() const { return (executed_ticks_.load(std::memory_order_relaxed) + idle_ticks_) / host_threads_; }
+    void wake_sleepers_locked();
+
+    ProcessTable& table_;
+    const int host_threads_;
+    const int quantum_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable pager_cv_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::deque<std::pair<Process*, std::coroutine_handle<>>> faults_;
+    TimerWheel sleepers_;
+    std::vector<ProcessIndex> woken_;
+    std::vector<std::coroutine_handle<>> handles_; // By process index; null once finished
+    size_t live_ = 0;    // Spawned and not finished
+    size_t running_ = 0; // Being resumed by a host thread
+    size_t paging_ = 0;  // Taken by the pager, not yet queued again
+    uint64_t idle_ticks_ = 0;
+
+    std::atomic<uint64_t> executed_ticks_{0};
+    uint64_t resumes_ = 0;
+    uint64_t preemptions_ = 0;
+    uint64_t page_faults_ = 0;
+    uint64_t sleeps_ = 0;
+    size_t finished_ = 0;
+    size_t terminated_ = 0;
+    size_t peak_live_ = 0;
+};
+
+#endif // PROCESS_COROUTINE_H
@@ -4,6 +4,8 @@
 #include <mutex> 
 #include <vector> 
 #include <memory> 
+#include <map> 
+#include <algorithm> 
 
 #include "ProcessSMI.h" 
 // --- MODIFIED: Include the new core headers ---
@@ -36,20 +38,20 @@ void process_smi::printSnapshot() {
     /* ── Gather data under lock ─────────────────────────────── */
     int busyCores           = 0;
     std::size_t usedBytes; // Will get this from the MemoryManager
-    std::vector<std::shared_ptr<Process>> running_copy;
+    std::vector<ProcessIndex> running_copy;
 
     {
         std::lock_guard<std::mutex> lk(rr_g_process_mutex);
 
         // Count busy cores from the running processes list (same as your original)
-        for (const auto& p : rr_g_running_processes) {
-            if (p) ++busyCores;
+        for (ProcessIndex p : rr_g_running_processes) {
+            if (p != NO_PROCESS) ++busyCores;
         }
         
         // --- NEW: Get total used memory from the MemoryManager ---
         // This replaces the loop over the deleted 'rr_g_memory_processes'
         usedBytes = memory_manager->get_used_memory_bytes();
-        // Make a shallow copy of the running processes to print outside the lock
+        // Copy the running indices to print outside the lock; table PCBs are never freed
         running_copy = rr_g_running_processes;
     }
 
@@ -68,16 +70,90 @@ void process_smi::printSnapshot() {
         << "Running Processes and Memory Usage:\n"
         << HR;
 
-    // --- MODIFIED: Iterate over the copy of 'Process' pointers ---
-    for (const auto& p : running_copy) {
-        if (!p) continue;
+    // --- MODIFIED: Iterate over the copy of running process indices ---
+    for (ProcessIndex index : running_copy) {
+        if (index == NO_PROCESS) continue;
+        const Process* p = &g_process_table[index];
         // The member variable is now p->mem_data.memory_size_bytes
-        oss << std::left << std::setw(12) << p->processName
-            << formatMemory(p->mem_data.memory_size_bytes) << '\n';
+        oss << std::left << std::setw(12) << p->cold->processName
+            << std::setw(10) << formatMemory(p->mem_data.memory_size_bytes)
+            << "WS: " << std::setw(8) << formatMemory(static_cast<std::size_t>(p->mem_data.working_set_pages) * MEM_PER_FRAME)
+            << "peak " << formatMemory(static_cast<std::size_t>(p->mem_data.peak_working_set_pages) * MEM_PER_FRAME) << '\n';
     }
+    oss << HR;
+
+    oss << "Paging per process:\n"
+        << std::left << std::setw(12) << "Name" << std::right
+        << std::setw(8) << "Minor" << std::setw(8) << "Major" << std::setw(9) << "Evicted"
+        << std::setw(10) << "Read" << std::setw(10) << "Written" << '\n';
+    for (ProcessIndex index : running_copy) {
+        if (index == NO_PROCESS) continue;
+        const Process* p = &g_process_table[index];
+        const auto& mem = p->mem_data;
+        oss << std::left << std::setw(12) << p->cold->processName << std::right
+            << std::setw(8) << mem.minor_faults.load(std::memory_order_relaxed)
+            << std::setw(8) << mem.major_faults.load(std::memory_order_relaxed)
+            << std::setw(9) << mem.pages_evicted.load(std::memory_order_relaxed)
+            << std::setw(10) << formatMemory(mem.bytes_read_from_store.load(std::memory_order_relaxed))
+            << std::setw(10) << formatMemory(mem.bytes_written_to_store.load(std::memory_order_relaxed)) << '\n';
+    }
+    oss << "Fault latency p50/p99: " << memory_manager->fault_latency.percentile_ns(0.50)
+        << " / " << memory_manager->fault_latency.percentile_ns(0.99) << " ns\n"
+        << "Eviction latency p50/p99: " << memory_manager->eviction_latency.percentile_ns(0.50)
+        << " / " << memory_manager->eviction_latency.percentile_ns(0.99) << " ns\n";
     oss << HR << std::flush;
 
     /* ── Atomically write to console ─────────────────────────── */
     std::lock_guard<std::mutex> cout_lk(g_cout_mutex);
     std::cout << oss.str() << std::endl;
-}
\ No newline at end of file
+}
+
+// Prints one cell per frame, shaded by how often its page was referenced across samples.
+void process_smi::printHeatmap() {
+    constexpr const char* HR = "-------------------------------------------------------------\n";
+    constexpr const char* SHADES = " .:-=+*#%@";
+    constexpr int SHADE_LEVELS = 10;
+    constexpr int CELLS_PER_ROW = 32;
+    std::ostringstream oss;
+
+    auto frames = memory_manager->get_frame_snapshot();
+    long max_heat = 0;
+    std::map<int, long> heat_per_pid;
+    for (const auto& frame : frames) {
+        if (frame.is_free) continue;
+        max_heat = std::max(max_heat, frame.access_heat);
+        heat_per_pid[frame.owner_pid] += frame.access_heat;
+    }
+
+    oss << '\n'
+        << HR
+        << "| MEMORY HEATMAP  Samples: " << memory_manager->working_set_samples
+        << "  Frame size: " << formatMemory(MEM_PER_FRAME) << " |\n\n"
+        << "Legend: '" << SHADES << "' cold to hot, '_' free frame\n"
+        << HR;
+
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        if (i % CELLS_PER_ROW == 0) {
+            oss << std::right << std::setw(6) << i << " |";
+        }
+        const auto& frame = frames[i];
+        if (frame.is_free) {
+            oss << '_';
+        } else {
+            int level = max_heat > 0 ? static_cast<int>((frame.access_heat * (SHADE_LEVELS - 1) + max_heat - 1) / max_heat) : 0;
+            oss << SHADES[level];
+        }
+        if (i % CELLS_PER_ROW == CELLS_PER_ROW - 1 || i + 1 == frames.size()) {
+            oss << "|\n";
+        }
+    }
+
+    oss << HR << "Heat per process (referenced frame-samples):\n";
+    for (const auto& [pid, heat] : heat_per_pid) {
+        oss << "  PID " << std::left << std::setw(8) << pid << heat << '\n';
+    }
+    oss << HR << std::flush;
+
+    std::lock_guard<std::mutex> cout_lk(g_cout_mutex);
+    std::cout << oss.str() << std::endl;
+}
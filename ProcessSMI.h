@@ -3,4 +3,5 @@
 
 namespace process_smi {
     void printSnapshot(); 
+    void printHeatmap();
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "ProcessScreen.h" 
+#include "PrintLog.h"
+#include "global.h"
 #include <iostream> 
 #include <iomanip> 
 #include <ctime> 
@@ -6,15 +8,29 @@
 #include <Windows.h>
 #include <mutex> 
 
+// How often a tailing screen checks the process's output for new lines.
+const auto SCREEN_TAIL_INTERVAL = std::chrono::milliseconds(100);
+
+// (MM/DD/YYYY hh:mm:ssAM) Core:N "text"
+static std::string formatLine(const PrintLog::Line& line) {
+    std::time_t seconds = static_cast<std::time_t>(line.timestamp_ms / 1000);
+    std::tm timeinfo = {};
+    std::tm* tmp = std::localtime(&seconds);
+    if (tmp) timeinfo = *tmp;
+
+    char timeBuf[32];
+    strftime(timeBuf, sizeof(timeBuf), "%m/%d/%Y %I:%M:%S%p", &timeinfo);
+    return "(" + std::string(timeBuf) + ") Core:" + std::to_string(line.core) + " \"" + line.text + "\"";
+}
+
 ProcessScreen::ProcessScreen(const std::string& name) 
-    : name(name), currentLine(0), totalLines(1000), 
-    creationTime(std::chrono::system_clock::now()) {} 
+    : name(name), creationTime(std::chrono::system_clock::now()), running(false) {} 
 
-// ProcessScreen::~ProcessScreen() {
-//     stop();
-// } 
+ProcessScreen::~ProcessScreen() {
+    stop();
+} 
 
-void ProcessScreen::display() const {
+void ProcessScreen::display(size_t lines) {
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE); 
     CONSOLE_SCREEN_BUFFER_INFO csbi; 
     GetConsoleScreenBufferInfo(hConsole, &csbi); 
@@ -35,52 +51,46 @@ void ProcessScreen::display() const {
     std::cout << "Created: " << timeBuf << "\n"; 
     std::cout << std::string(width, '=') << "\n\n";
 
-    // Static progress display
-    // std::cout << "Progress: 0/1000 (0%)\n" << std::endl;
+    // Newest PRINT output, read straight from the process's ring without any scheduler lock.
+    nextLine = 0;
+    if (std::shared_ptr<PrintLog> log = print_log_find(name)) {
+        for (const auto& line : log->tail(lines)) std::cout << formatLine(line) << "\n";
+        nextLine = log->written();
+    }
+    std::cout << std::endl;
 }
 
-// void ProcessScreen::run() {
-//     if (running) return; 
-
-//     running = true; 
-//     progressThread.reset(new std::thread(&ProcessScreen::updateProgress, this));
-// }
-
-// void ProcessScreen::stop() {
-//     if (running) {
-//         running = false; 
+void ProcessScreen::run() {
+    if (running) return; 
 
-//         if (progressThread && progressThread->joinable()) {
-//             progressThread->join();
-//         }
-//      }
-// }
-
-// void ProcessScreen::updateProgress() {
-//     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE); 
-//     CONSOLE_SCREEN_BUFFER_INFO csbi; 
-//     GetConsoleScreenBufferInfo(hConsole, &csbi); 
-
-//     const SHORT progressLine = csbi.srWindow.Bottom - 2; 
-    
-//     while (running) {
-//         // Simulate progress
-//         if (currentLine < totalLines) {
-//             currentLine++; 
-//         } 
+    running = true; 
+    tailThread.reset(new std::thread(&ProcessScreen::tailOutput, this));
+}
 
-//         {
-//             std::lock_guard<std::mutex> lock(displayMutex); 
-//             HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE); 
-//             CONSOLE_SCREEN_BUFFER_INFO csbi; 
-//             GetConsoleScreenBufferInfo(hConsole, &csbi); 
+void ProcessScreen::stop() {
+    if (running) {
+        running = false; 
 
-//             COORD pos = {0, 5};
-//             SetConsoleCursorPosition(hConsole, pos);
+        if (tailThread && tailThread->joinable()) {
+            tailThread->join();
+        }
+    }
+}
 
-//             int percentatge = (currentLine*100) / totalLines; 
-//             std::cout << "Progress: " << currentLine << "/" << totalLines << " (" << percentatge << "%)      ";
-//         }
-//         std::this_thread::sleep_for(std::chrono::milliseconds(100));
-//     }
-// }
\ No newline at end of file
+void ProcessScreen::tailOutput() {
+    std::shared_ptr<PrintLog> log;
+    while (running) {
+        // The process may not have been created yet when its screen is attached.
+        if (!log) log = print_log_find(name);
+        if (log) {
+            std::vector<PrintLog::Line> lines = log->read_since(nextLine);
+            if (!lines.empty()) {
+                std::lock_guard<std::mutex> lock(g_cout_mutex);
+                for (const auto& line : lines) std::cout << "\n" << formatLine(line);
+                std::cout << std::endl;
+                nextLine = lines.back().sequence + 1;
+            }
+        }
+        std::this_thread::sleep_for(SCREEN_TAIL_INTERVAL);
+    }
+}
@@ -3,32 +3,35 @@
 
 #include <string> 
 #include <chrono> 
-// #include <memory> 
-// #include <atomic> 
-// #include <thread> 
-// #include <mutex> 
+#include <memory> 
+#include <atomic> 
+#include <thread> 
+#include <cstdint>
+
+// Lines of PRINT output screen -r shows when no count is given.
+constexpr size_t SCREEN_DEFAULT_LINES = 20;
 
 class ProcessScreen {
 private: 
-    void updateProgress(); 
+    void tailOutput(); 
 
     std::string name; 
-    int currentLine;
-    // std::atomic<int> currentLine; 
-    int totalLines; 
     std::chrono::system_clock::time_point creationTime; 
 
-    // std::atomic<bool> running; 
-    // std::unique_ptr<std::thread> progressThread; 
-    // mutable std::mutex displayMutex;
+    // Sequence of the next PRINT line to show; the tail thread picks up where display() stopped.
+    uint64_t nextLine = 0;
+    std::atomic<bool> running; 
+    std::unique_ptr<std::thread> tailThread; 
 
 public: 
     explicit ProcessScreen(const std::string& name); 
-    // ~ProcessScreen(); 
+    ~ProcessScreen(); 
 
-    void display() const; 
-    // void run(); 
-    // void stop(); 
+    // Header plus the newest lines of the process's PRINT output.
+    void display(size_t lines = SCREEN_DEFAULT_LINES); 
+    // Prints new PRINT output as it arrives until stop().
+    void run(); 
+    void stop(); 
 };
 
 #endif
\ No newline at end of file
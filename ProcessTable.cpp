@@ -0,0 +1,54 @@
+#include "ProcessTable.h"
+
+#include <algorithm>
+#include <new>
+
+ProcessTable::~ProcessTable() {
+    size_t count = size();
+    for (size_t i = 0; i < count; ++i) (*this)[static_cast<ProcessIndex>(i)].~Process();
+    for (auto& slab : slabs_) delete slab.load(std::memory_order_relaxed);
+}
+
+ProcessIndex ProcessTable::create(int id) {
+    std::lock_guard<std::mutex> lock(create_mutex_);
+    size_t index;
+    bool reused = !released_.empty();
+    if (reused) {
+        // The finished PCB stayed for the reports until now.
+        index = static_cast<size_t>(released_.back());
+        released_.pop_back();
+        (*this)[static_cast<ProcessIndex>(index)].~Process();
+    } else {
+        index = size_.load(std::memory_order_relaxed);
+        size_t slab_index = index >> SLAB_BITS;
+        if (slab_index >= MAX_SLABS) return NO_PROCESS;
+        if (slabs_[slab_index].load(std::memory_order_relaxed) == nullptr) {
+            // Hot arrays are filled in per entry below; the PCB storage is left for placement new.
+            slabs_[slab_index].store(new Slab, std::memory_order_release);
+        }
+    }
+
+    Slab& entry_slab = slab(static_cast<ProcessIndex>(index));
+    size_t i = offset(static_cast<ProcessIndex>(index));
+    Process* pcb = new (entry_slab.pcbs() + i) Process(id);
+    pcb->table_index = static_cast<ProcessIndex>(index);
+    entry_slab.state[i] = ProcessState::NEW;
+    entry_slab.core[i] = -1;
+    entry_slab.quantum_ticks[i] = 0;
+    entry_slab.priority[i] = 0;
+    if (!reused) size_.store(index + 1, std::memory_order_release);
+    return static_cast<ProcessIndex>(index);
+}
+
+void ProcessTable::release(ProcessIndex index) {
+    std::lock_guard<std::mutex> lock(create_mutex_);
+    released_.push_back(index);
+}
+
+size_t recycle_finished(ProcessTable& table, std::vector<ProcessIndex>& finished) {
+    // A quarter at a time keeps the erase below amortized O(1) per process created.
+    size_t count = std::min(finished.size(), std::max(ProcessTable::SLAB_SIZE, finished.size() / 4));
+    for (size_t i = 0; i < count; ++i) table.release(finished[i]);
+    finished.erase(finished.begin(), finished.begin() + static_cast<std::ptrdiff_t>(count));
+    return count;
+}
@@ -0,0 +1,83 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "Process.h"
+
+// --- Process Table ---
+// Owns every PCB the schedulers create. PCBs are constructed in place in fixed-size slabs, so creating
+// one costs no heap allocation of its own and neighbouring PIDs share pages. The fields a scheduler
+// scan reads (state, core, quantum ticks, priority) live outside the PCB in dense per-slab arrays,
+// so a scan over a million processes walks a few bytes each instead of a cold PCB each.
+// Scheduler queues hold ProcessIndex values into this table. Finished processes stay for the reports
+// until the schedulers release them (see recycle_finished()); a released entry keeps its finished PCB
+// until create() reuses it. A slab never moves once allocated, so a PCB reference stays valid until
+// its entry is reused.
+class ProcessTable {
+public:
+    static constexpr int SLAB_BITS = 10;
+    static constexpr size_t SLAB_SIZE = size_t(1) << SLAB_BITS; // PCBs per slab
+    static constexpr size_t MAX_SLABS = 4096;                   // 4M processes
+
+    ProcessTable() = default;
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+    ~ProcessTable();
+
+    // Constructs Process(id) in a released entry, or else the next unused one. State starts NEW, core
+    // -1, quantum and priority 0. Returns NO_PROCESS once MAX_SLABS are full and nothing is released.
+    // Safe to call from either scheduler.
+    ProcessIndex create(int id);
+    // Hands a finished process's entry back for create() to reuse. Nothing may refer to it afterwards.
+    void release(ProcessIndex index);
+
+    Process& operator[](ProcessIndex index) const { return slab(index).pcbs()[offset(index)]; }
+    ProcessState& state(ProcessIndex index) const { return slab(index).state[offset(index)]; }
+    int16_t& core(ProcessIndex index) const { return slab(index).core[offset(index)]; }
+    uint32_t& quantum_ticks(ProcessIndex index) const { return slab(index).quantum_ticks[offset(index)]; }
+    uint8_t& priority(ProcessIndex index) const { return slab(index).priority[offset(index)]; }
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    // Bytes of slab storage per process: the PCB plus its hot fields.
+    static constexpr size_t bytes_per_process() {
+        return sizeof(Process) + sizeof(ProcessState) + sizeof(int16_t) + sizeof(uint32_t) + sizeof(uint8_t);
+    }
+
+private:
+    struct Slab {
+        ProcessState state[SLAB_SIZE];
+        int16_t core[SLAB_SIZE];
+        uint32_t quantum_ticks[SLAB_SIZE];
+        uint8_t priority[SLAB_SIZE];
+        alignas(Process) unsigned char storage[SLAB_SIZE * sizeof(Process)]; // PCBs, constructed by create()
+
+        Process* pcbs() { return reinterpret_cast<Process*>(storage); }
+    };
+
+    static size_t offset(ProcessIndex index) { return static_cast<size_t>(index) & (SLAB_SIZE - 1); }
+    Slab& slab(ProcessIndex index) const {
+        return *slabs_[static_cast<size_t>(index) >> SLAB_BITS].load(std::memory_order_acquire);
+    }
+
+    std::atomic<Slab*> slabs_[MAX_SLABS] = {};
+    std::atomic<size_t> size_{0};
+    std::vector<ProcessIndex> released_; // Entries for create() to reuse, guarded by create_mutex_
+    std::mutex create_mutex_;
+};
+
+// For a scheduler whose create() failed: releases the oldest quarter of its finished processes, at
+// least a slab's worth, and drops them from finished, so the reports cover the rest. Returns how many
+// were released. Caller holds the scheduler's process mutex.
+size_t recycle_finished(ProcessTable& table, std::vector<ProcessIndex>& finished);
+
+// Core a table process is assigned to, -1 if none or if the PCB lives outside the table.
+inline int process_core(const ProcessTable& table, const Process& process) {
+    return process.table_index != NO_PROCESS ? table.core(process.table_index) : -1;
+}
+
+#endif // PROCESS_TABLE_H
@@ -0,0 +1,68 @@
+#include "QuantumTuner.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "global.h"
+
+QuantumTunerConfig quantum_tuner_config_from_globals() {
+    QuantumTunerConfig config;
+    config.enabled = ADAPTIVE_QUANTUM != 0;
+    config.min_quantum = std::max(1, QUANTUM_MIN);
+    config.max_quantum = std::max(config.min_quantum, QUANTUM_MAX);
+    config.target_response_ticks = TARGET_RESPONSE_TICKS > 0 ? static_cast<uint64_t>(TARGET_RESPONSE_TICKS) : 1;
+    config.target_overhead = std::clamp(TARGET_SWITCH_OVERHEAD, 1, 99) / 100.0;
+    return config;
+}
+
+void QuantumTuner::configure(const QuantumTunerConfig& config, int initial_quantum) {
+    config_ = config;
+    quantum_.store(std::clamp(initial_quantum, config_.min_quantum, config_.max_quantum), std::memory_order_relaxed);
+    run_ns_ = 0;
+    run_ticks_ = 0;
+    switch_ns_ = 0;
+    switches_ = 0;
+    last_update_ = std::chrono::steady_clock::now();
+    log_.clear();
+    log_next_ = 0;
+}
+
+void QuantumTuner::update(size_t ready, int cores, uint64_t now_tick) {
+    if (!config_.enabled) return;
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_update_ < UPDATE_PERIOD) return;
+    last_update_ = now;
+
+    double run_ns = static_cast<double>(run_ns_.exchange(0, std::memory_order_relaxed));
+    double run_ticks = static_cast<double>(run_ticks_.exchange(0, std::memory_order_relaxed));
+    double switch_ns = static_cast<double>(switch_ns_.exchange(0, std::memory_order_relaxed));
+    double switches = static_cast<double>(switches_.exchange(0, std::memory_order_relaxed));
+    double switch_cost = switches > 0 ? switch_ns / switches : 0;
+    double tick_cost = run_ticks > 0 ? run_ns / run_ticks : 0;
+    double overhead = switch_ns + run_ns > 0 ? switch_ns / (switch_ns + run_ns) : 0;
+
+    double current = quantum();
+    double ceiling = ready > 0 ? static_cast<double>(config_.target_response_ticks) * std::max(1, cores) / ready : config_.max_quantum;
+    double target = (current + ceiling) / 2;
+    if (switches > 0 && tick_cost > 0) {
+        double f = config_.target_overhead;
+        target = std::max(target, switch_cost * (1 - f) / (f * tick_cost));
+    }
+    target = std::clamp(target, static_cast<double>(config_.min_quantum), static_cast<double>(config_.max_quantum));
+    int chosen = static_cast<int>(std::lround(target));
+    quantum_.store(chosen, std::memory_order_relaxed);
+
+    Sample sample{now_tick, chosen, ready, switch_cost, tick_cost, overhead};
+    if (log_.size() < LOG_CAPACITY) {
+        log_.push_back(sample);
+    } else {
+        log_[log_next_] = sample;
+        log_next_ = (log_next_ + 1) % LOG_CAPACITY;
+    }
+}
+
+std::vector<QuantumTuner::Sample> QuantumTuner::log() const {
+    std::vector<Sample> ordered(log_.begin() + log_next_, log_.end());
+    ordered.insert(ordered.end(), log_.begin(), log_.begin() + log_next_);
+    return ordered;
+}
@@ -0,0 +1,85 @@
+#ifndef QUANTUM_TUNER_H
+#define QUANTUM_TUNER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bounds and targets of the adaptive quantum, read from config.txt by quantum_tuner_config_from_globals().
+struct QuantumTunerConfig {
+    bool enabled = false;
+    int min_quantum = 1;
+    int max_quantum = 1000;
+    uint64_t target_response_ticks = 200; // CPU clock ticks a ready process should wait for a core
+    double target_overhead = 0.10;        // Largest share of core time to spend switching processes
+};
+
+QuantumTunerConfig quantum_tuner_config_from_globals();
+
+// --- Adaptive Quantum ---
+// Picks the RR scheduler's quantum-cycles from what the cores observe. Cores report, once per
+// quantum, how long the quantum ran and how long the core then went without a process although
+// processes were ready: the context switch, i.e. the requeue, the scheduler's wake-up and the
+// dispatch. Every UPDATE_PERIOD the scheduler calls update(), which turns the averages into two
+// bounds:
+//   - overhead floor: a switch costing s ns against t ns per tick takes a share s / (s + q t) of the
+//     core, so q >= s (1 - f) / (f t) keeps it under the target share f;
+//   - response ceiling: with n processes ready on c cores a newly ready one waits about n q / c
+//     ticks, so q <= R c / n meets the target response R.
+// The quantum moves halfway towards the response ceiling, but never below the overhead floor, and
+// stays within [min_quantum, max_quantum]. The recording calls are lock-free; update() and the
+// log are guarded by the RR scheduler's process mutex.
+class QuantumTuner {
+public:
+    static constexpr auto UPDATE_PERIOD = std::chrono::milliseconds(5);
+    static constexpr size_t LOG_CAPACITY = 4096;
+
+    // One update: the quantum chosen and what it was chosen from.
+    struct Sample {
+        uint64_t tick;      // CPU clock tick of the update
+        int quantum;
+        size_t ready;       // Ready processes
+        double switch_ns;   // Mean switch cost since the last update
+        double tick_ns;     // Mean time per executed tick since the last update
+        double overhead;    // Share of core time spent switching since the last update
+    };
+
+    // Starts over from initial_quantum (clamped to the bounds) with an empty log.
+    void configure(const QuantumTunerConfig& config, int initial_quantum);
+    bool enabled() const { return config_.enabled; }
+    const QuantumTunerConfig& config() const { return config_; }
+
+    // Quantum for the next dispatch.
+    int quantum() const { return quantum_.load(std::memory_order_relaxed); }
+
+    // From the cores.
+    void record_run(uint64_t ns, int ticks) {
+        run_ns_.fetch_add(ns, std::memory_order_relaxed);
+        run_ticks_.fetch_add(static_cast<uint64_t>(ticks), std::memory_order_relaxed);
+    }
+    void record_switch(uint64_t ns) {
+        switch_ns_.fetch_add(ns, std::memory_order_relaxed);
+        switches_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Re-tunes once UPDATE_PERIOD has passed since the last update; otherwise does nothing.
+    void update(size_t ready, int cores, uint64_t now_tick);
+
+    // Oldest first; at most LOG_CAPACITY samples, the oldest are dropped.
+    std::vector<Sample> log() const;
+
+private:
+    QuantumTunerConfig config_;
+    std::atomic<int> quantum_{1};
+    std::atomic<uint64_t> run_ns_{0};
+    std::atomic<uint64_t> run_ticks_{0};
+    std::atomic<uint64_t> switch_ns_{0};
+    std::atomic<uint64_t> switches_{0};
+    std::chrono::steady_clock::time_point last_update_;
+    std::vector<Sample> log_; // Ring of LOG_CAPACITY samples
+    size_t log_next_ = 0;
+};
+
+#endif // QUANTUM_TUNER_H
@@ -13,15 +13,66 @@
 #include "RR.h"      
 #include "config.h"  
 #include "vmstat.h"  
+#include "MemorySnapshot.h"
+#include "Interpreter.h"
+#include "Workload.h"
+#include "ProcessCoroutine.h"
 
 // --- File-local variables ---
-int memoryCycle = 0;
 std::random_device rr_rd;
 std::mt19937 rr_gen(rr_rd());
+// Wakes idle cores once the scheduler has assigned them a process.
+static std::condition_variable rr_core_cv;
+// CPU tick of the last MLFQ priority boost.
+static uint64_t rr_last_boost_tick = 0;
+
+// --- Virtual Cores ---
+// What the host threads need to step a virtual core, one entry per possible core so cpu-set never
+// moves it. Guarded by rr_g_process_mutex, except that only the host thread stepping a core reads
+// switching and left_core.
+struct RrCoreState {
+    int quantum = 1;       // Quantum the ready-queue policy gave the core's current process, set at dispatch
+    bool stepping = false; // A host thread has claimed the current process and is running its quantum
+    // Adaptive quantum: the gap between two quanta on this core is a context switch when processes
+    // were ready as the first one left; a gap the core spent idle is not.
+    bool switching = false;
+    std::chrono::steady_clock::time_point left_core;
+};
+static RrCoreState rr_core_state[CoreCaches::MAX_CORES];
+
+// The host threads behind the virtual cores: one per core under core-threads "per-core" (indexed by
+// core id), or a pool that steps whichever cores have a process, in turns. cpu-set and
+// rr_set_core_threads() add and join them while RR() runs, so the list has its own mutex;
+// rr_g_process_mutex is not held while a host thread is joined. Never destroyed: exit can end the
+// program while RR() runs, and destroying a running thread's std::thread would abort it.
+static std::vector<std::thread>& rr_host_threads = *new std::vector<std::thread>();
+static std::mutex rr_host_threads_mutex;
+static bool rr_pooled = false;
+static int rr_pool_size = 0;
+// Bumped under rr_g_process_mutex to stop every host thread of the current set.
+static int rr_host_generation = 0;
+// Pool: the core after the last one claimed, where the next search for a core to step starts.
+static size_t rr_pool_cursor = 0;
+// Set by rr_pause_cores(): no host thread claims a process until rr_resume_cores().
+static bool rr_cores_paused = false;
+// core-threads "coroutine": the pool resumes each process's coroutine (see ProcessCoroutine.h) rather
+// than calling the interpreter itself, and page faults are deferred to the pager thread.
+static bool rr_coroutine_mode = false;
+// The coroutine of each process that was dispatched in coroutine mode, by table index; null for the
+// rest. Guarded by rr_g_process_mutex. Never destroyed, like rr_host_threads.
+static std::vector<std::coroutine_handle<>>& rr_coroutines = *new std::vector<std::coroutine_handle<>>();
+// Wakes the pager when a fault is queued or the cores resume.
+static std::condition_variable rr_pager_cv;
+// The pager is bringing in the page of the process at the front of rr_g_fault_queue.
+static bool rr_pager_busy = false;
 
 // --- Forward Declarations for functions defined in this file ---
 void rr_scheduler_thread_func();
-void rr_core_worker_func(int core_id);
+void rr_core_worker_func(int core_id, int generation);
+void rr_host_worker_func(int host_index, int generation);
+static void rr_pager_func();
+static int rr_resolve_pool_size(int host_threads);
+static void rr_start_host_threads();
 
 // --- Helper Function to Format Time ---
 std::string rr_format_time(const std::chrono::system_clock::time_point& tp, const std::string& fmt) {
@@ -36,73 +87,29 @@ std::string rr_format_time(const std::chrono::system_clock::time_point& tp, cons
 std::vector<std::string> rr_getRunningProcessNames() {
     std::lock_guard<std::mutex> lock(rr_g_process_mutex); 
     std::vector<std::string> out; 
-    for (const auto& p : rr_g_running_processes) {
-        if (p) out.emplace_back(p->processName);
+    for (ProcessIndex p : rr_g_running_processes) {
+        if (p != NO_PROCESS) out.emplace_back(g_process_table[p].cold->processName);
     } 
     return out;
 }
 
-// --- Helper for Memory Logging ---
-void display_memory() {
-    std::ostringstream filename;
-    filename << "memory_stamp_" << memoryCycle++ << ".txt";
-    std::ofstream memory_file(filename.str());
-    auto frame_snapshot = memory_manager->get_frame_snapshot();
-    int occupied_frames = 0;
-    for(const auto& frame : frame_snapshot) {
-        if (!frame.is_free) { occupied_frames++; }
-    }
-    memory_file << "Timestamp: (" << rr_format_time(std::chrono::system_clock::now(), "%m/%d/%Y %I:%M:%S%p") << ")" << std::endl;
-    memory_file << "Total Frames: " << frame_snapshot.size() << std::endl;
-    memory_file << "Occupied Frames: " << occupied_frames << std::endl;
-    memory_file << "Unused Frames: " << frame_snapshot.size() - occupied_frames << std::endl << std::endl;
-    memory_file << "---- Memory Layout (Top to Bottom) ----" << std::endl;
-    memory_file << "----end---- = " << MAX_OVERALL_MEM << std::endl;
-    std::map<int, std::string> pid_to_name_map;
-    {
-        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-        auto populate_map = [&](const auto& process_list){
-            for(const auto& p : process_list) { if(p) pid_to_name_map[p->id] = p->processName; }
-        };
-        populate_map(rr_g_ready_queue);
-        populate_map(rr_g_running_processes);
-        populate_map(rr_g_blocked_queue);
-        populate_map(rr_g_finished_processes);
-    }
-    for (int i = frame_snapshot.size() - 1; i >= 0; --i) {
-        const auto& frame = frame_snapshot[i];
-        long long upper_bound = (long long)(i + 1) * MEM_PER_FRAME;
-        long long lower_bound = (long long)i * MEM_PER_FRAME;
-        memory_file << upper_bound << std::endl;
-        if (frame.is_free) { memory_file << "[  FREE  ]" << std::endl; } 
-        else {
-            std::string name = "PID " + std::to_string(frame.owner_pid);
-            if(pid_to_name_map.count(frame.owner_pid)) { name = pid_to_name_map[frame.owner_pid]; }
-            memory_file << name << std::endl;
-        }
-        memory_file << lower_bound << std::endl << std::endl;
-    }
-    memory_file << "----start---- = 0" << std::endl;
-    memory_file.close();
-}
-
 void rr_search_process(std::string process_search) {
     std::lock_guard<std::mutex> lock(rr_g_process_mutex);
     std::stringstream tempString;
-    std::vector<std::shared_ptr<Process>> search_vector;
-    std::shared_ptr<Process> process = nullptr;
+    std::vector<ProcessIndex> search_vector;
+    Process* process = nullptr;
 
     std::cout << "\n-------------------------------------------------------------\n";
 
-    if (!rr_g_ready_queue.empty() || rr_g_running_processes.front() != nullptr) {
-        search_vector.insert(search_vector.end(), rr_g_ready_queue.begin(), rr_g_ready_queue.end());
+    if (!rr_g_ready_queue.empty() || rr_g_running_processes.front() != NO_PROCESS) {
+        rr_g_ready_queue.for_each([&](ProcessIndex p) { search_vector.push_back(p); });
         search_vector.insert(search_vector.end(), rr_g_running_processes.begin(), rr_g_running_processes.end());
 
         std::cout << "process search start" << std::endl;
-        for (const auto& p : search_vector) {
+        for (ProcessIndex p : search_vector) {
             int i = 0;
-            if (process_search.compare(p->processName) == 0) {
-                process = p;
+            if (p != NO_PROCESS && process_search.compare(g_process_table[p].cold->processName) == 0) {
+                process = &g_process_table[p];
                 std::cout << "process found" << std::endl;
                 break;
             }
@@ -114,8 +121,10 @@ void rr_search_process(std::string process_search) {
         std::cout << "process search end" << std::endl;
 
         if (process != nullptr) {
-            for(const std::string& line : process->commands) {
-                std::cout << line << std::endl;
+            if (process->image) {
+                for(const std::string& line : program_source(*process->image)) {
+                    std::cout << line << std::endl;
+                }
             }
         } else {
             std::cout << "Process not found" << std::endl;
@@ -129,6 +138,99 @@ void rr_search_process(std::string process_search) {
 }  
 
 
+// --- Program for Generated Processes ---
+void rr_load_generated_program(Process& pcb, size_t memory_size) {
+    // Every generated process shares one image instead of carrying its own copy.
+    static const std::shared_ptr<const ProgramImage> workload = [] {
+        std::vector<std::string> commands;
+        // Give processes a heavy workload to force preemption
+        for (int i = 0; i < 50; ++i) { 
+            commands.push_back("write 0x0 123"); 
+            commands.push_back("read 0x0");
+        }
+        return intern_program(commands);
+    }();
+    static const std::shared_ptr<const ProgramImage> empty = intern_program({});
+    load_program(pcb, memory_size > 2 ? workload : empty);
+}
+
+// --- Process Table Entries ---
+// A table entry for a new process named name. When the table is full, the oldest finished processes
+// leave the report history and their entries are reused; if every entry holds a live process the
+// request is rejected with a message. Caller holds rr_g_process_mutex.
+static ProcessIndex rr_new_process(const std::string& name) {
+    int id = cpuClocks++;
+    ProcessIndex index = g_process_table.create(id);
+    if (index == NO_PROCESS && recycle_finished(g_process_table, rr_g_finished_processes) > 0) {
+        index = g_process_table.create(id);
+    }
+    if (index == NO_PROCESS) {
+        std::lock_guard<std::mutex> lock(g_cout_mutex);
+        std::cout << "\nProcess table full: " << name << " was not created" << std::endl;
+    }
+    return index;
+}
+
+// --- Process Creation ---
+// Turns a creation request into a ready process: a table entry, its memory and its program.
+// Caller holds rr_g_process_mutex.
+static ProcessIndex rr_create_from_request(ProcessCreationRequest request, uint64_t now) {
+    ProcessIndex index = rr_new_process(request.name);
+    if (index == NO_PROCESS) return NO_PROCESS;
+    Process* pcb = &g_process_table[index];
+    pcb->start_time = std::chrono::system_clock::now();
+    pcb->arrival_tick = now;
+    pcb->cold->processName = std::move(request.name);
+    pcb->weight = request.weight > 0 ? request.weight : static_cast<uint32_t>(DEFAULT_WEIGHT);
+    print_log_register(pcb->cold->processName, pcb->cold->output);
+
+    memory_manager->allocate_for_process(*pcb, request.memory_size);
+
+    if (request.program) {
+        load_program(*pcb, std::move(request.program));
+    } else {
+        rr_load_generated_program(*pcb, request.memory_size);
+    }
+    if (request.deadline > 0 && pcb->image) {
+        pcb->deadline_tick = now + request.deadline;
+        pcb->work_ticks = program_ticks(*pcb->image);
+        // A rejected process shows as best effort in screen -ls and is counted by report-util.
+        rr_g_ready_queue.admit(index, now, CPU_COUNT);
+    }
+    g_process_table.state(index) = ProcessState::READY;
+    rr_g_ready_queue.push_back(index);
+    return index;
+}
+
+void rr_create_queued_processes(uint64_t now) {
+    while (!g_creation_queue.empty()) {
+        ProcessCreationRequest request = std::move(g_creation_queue.front());
+        g_creation_queue.pop_front();
+        rr_create_from_request(std::move(request), now);
+    }
+}
+
+// --- Sleeping Processes ---
+// Caller holds rr_g_process_mutex. Moves every process whose wake tick has come back to the ready
+// queue. When no core has anything to run, the idle ticks up to the next wake-up pass at once
+// instead of one per idle wait.
+void rr_wake_sleepers() {
+    static std::vector<ProcessIndex> woken;
+    uint64_t now = static_cast<uint64_t>(get_cpu_clock_ticks());
+    bool cores_idle = std::all_of(rr_g_running_processes.begin(), rr_g_running_processes.begin() + CPU_COUNT, [](ProcessIndex p){ return p == NO_PROCESS; });
+    if (cores_idle && rr_g_ready_queue.empty() && !rr_g_sleep_wheel.empty() && rr_g_sleep_wheel.next_event_tick() > now) {
+        vmstats_add_idle_ticks(static_cast<long>(rr_g_sleep_wheel.next_event_tick() - now) * CPU_COUNT);
+        now = rr_g_sleep_wheel.next_event_tick();
+    }
+    rr_g_sleep_wheel.advance(now, woken);
+    for (ProcessIndex process : woken) {
+        g_process_table.state(process) = ProcessState::READY;
+        g_process_table[process].sleep_ticks_remaining = 0;
+        rr_g_ready_queue.push_back(process);
+    }
+    woken.clear();
+}
+
 // --- The Scheduler Thread ---
 void rr_scheduler_thread_func() {
     while (rr_g_is_running) {
@@ -136,159 +238,352 @@ void rr_scheduler_thread_func() {
 
         rr_g_scheduler_cv.wait(lock, [&]() {
             if (!rr_g_is_running) return true;
-            bool core_is_free = std::any_of(rr_g_running_processes.begin(), rr_g_running_processes.end(), [](const auto& p){ return p == nullptr; });
-            return !g_creation_queue.empty() || !rr_g_blocked_queue.empty() || (core_is_free && !rr_g_ready_queue.empty());
+            bool core_is_free = std::any_of(rr_g_running_processes.begin(), rr_g_running_processes.begin() + CPU_COUNT, [](ProcessIndex p){ return p == NO_PROCESS; });
+            bool cores_idle = std::all_of(rr_g_running_processes.begin(), rr_g_running_processes.begin() + CPU_COUNT, [](ProcessIndex p){ return p == NO_PROCESS; });
+            bool sleeper_due = static_cast<uint64_t>(get_cpu_clock_ticks()) >= rr_g_sleep_wheel.next_event_tick();
+            return !g_creation_queue.empty() || !rr_g_blocked_queue.empty() || (core_is_free && !rr_g_ready_queue.empty()) ||
+                   sleeper_due || (cores_idle && rr_g_ready_queue.empty() && !rr_g_sleep_wheel.empty());
         });
 
         if (!rr_g_is_running) break;
+        uint64_t now = static_cast<uint64_t>(get_cpu_clock_ticks());
 
         // Priority 1: Handle process creation requests from the CLI
-        while (!g_creation_queue.empty()) {
-            ProcessCreationRequest request = g_creation_queue.front();
-            g_creation_queue.pop_front();
-            
-            std::shared_ptr<Process> pcb = std::make_shared<Process>(cpuClocks++);
-            pcb->start_time = std::chrono::system_clock::now();
-            pcb->processName = request.name;
-            
-            memory_manager->allocate_for_process(*pcb, request.memory_size);
-
-            if (request.memory_size > 2) {
-                // Give processes a heavy workload to force preemption
-                for (int i = 0; i < 50; ++i) { 
-                    pcb->commands.push_back("write 0x0 123"); 
-                    pcb->commands.push_back("read 0x0");
-                }
-            }
-
-            rr_g_ready_queue.push_back(pcb); 
-        }
+        rr_create_queued_processes(now);
 
         // Priority 2: Unblock processes
         while (!rr_g_blocked_queue.empty()) {
-            std::shared_ptr<Process> unblocked_process = rr_g_blocked_queue.front();
+            ProcessIndex unblocked_process = rr_g_blocked_queue.front();
             rr_g_blocked_queue.pop_front();
-            unblocked_process->state = ProcessState::READY;
+            g_process_table.state(unblocked_process) = ProcessState::READY;
             rr_g_ready_queue.push_back(unblocked_process);
         }
 
-        // Priority 3: Assign ready processes to cores
+        // Priority 3: Wake sleeping processes
+        rr_wake_sleepers();
+
+        // MLFQ: bring sunk processes back to the top once per boost period.
+        uint64_t boost_ticks = rr_g_ready_queue.boost_ticks();
+        if (boost_ticks > 0 && now - rr_last_boost_tick >= boost_ticks) {
+            rr_g_ready_queue.boost();
+            rr_last_boost_tick = now;
+        }
+
+        // Adaptive quantum: re-tuned at most once per update period, from what the cores reported.
+        rr_g_quantum_tuner.update(rr_g_ready_queue.size(), CPU_COUNT, now);
+
+        // Priority 4: Assign ready processes to cores, in the order of the ready-queue policy
         for (int i = 0; i < CPU_COUNT; ++i) {
-            if (rr_g_running_processes[i] == nullptr && !rr_g_ready_queue.empty()) {
-                std::shared_ptr<Process> process = rr_g_ready_queue.front();
-                rr_g_ready_queue.pop_front();
-                process->state = ProcessState::RUNNING;
-                process->assigned_core = i;
-                process->commands_executed_this_quantum = 0;
+            if (rr_g_running_processes[i] == NO_PROCESS && !rr_g_ready_queue.empty()) {
+                ProcessIndex process = CACHE_AFFINITY ? rr_g_ready_queue.pop_for_core(i, now, static_cast<uint64_t>(std::max(0, MIGRATION_COST)))
+                                                      : rr_g_ready_queue.pop_front();
+                g_core_caches.record_dispatch(g_process_table.core(process), i);
+                g_process_table.state(process) = ProcessState::RUNNING;
+                g_process_table.core(process) = static_cast<int16_t>(i);
+                g_process_table.quantum_ticks(process) = 0;
+                rr_core_state[i].quantum = rr_g_ready_queue.quantum(process);
                 rr_g_running_processes[i] = process;
             }
         }
+        rr_core_cv.notify_all();
     }
+    rr_core_cv.notify_all();
 }
 
-// --- The CPU Worker Thread (Correct, Deadlock-Free Version) ---
-// --- FINAL, CORRECT, DEADLOCK-FREE WORKER THREAD ---
-void rr_core_worker_func(int core_id) {
-    while (rr_g_is_running) {
-        std::shared_ptr<Process> my_process;
+// --- The CPU Worker Threads ---
+// A core claims its process once per quantum and runs the whole quantum in a single interpreter call.
+// The process mutex is only taken again when the process leaves the core (quantum spent, block, exit),
+// and the executed ticks are published to vmstat once per quantum instead of once per instruction.
+
+// Runs one quantum of the process a host thread claimed on core_id. Called without rr_g_process_mutex.
+static ExecStatus rr_execute_quantum(int core_id, ProcessIndex my_index, int my_quantum) {
+    RrCoreState& core = rr_core_state[core_id];
+    // Step 2: Run the whole quantum OUTSIDE the main lock, since a memory access may have to page
+    // in from the backing store. The tick count stays local until the quantum is over.
+    Process* my_process = &g_process_table[my_index];
+    uint64_t quantum_start = static_cast<uint64_t>(get_cpu_clock_ticks());
+    int ticks = 0;
+    const bool tuning = rr_g_quantum_tuner.enabled();
+    std::chrono::steady_clock::time_point run_start;
+    if (tuning) {
+        run_start = std::chrono::steady_clock::now();
+        if (core.switching) rr_g_quantum_tuner.record_switch(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(run_start - core.left_core).count()));
+    }
+    ExecStatus status = interpreter_run(*my_process, my_quantum, ticks);
+    my_process->left_core_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+    if (tuning) {
+        core.left_core = std::chrono::steady_clock::now();
+        rr_g_quantum_tuner.record_run(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(core.left_core - run_start).count()), ticks);
+    }
+    vmstats_add_active_ticks(ticks);
+    my_process->ticks_executed.fetch_add(static_cast<uint64_t>(ticks), std::memory_order_relaxed);
+    // A dispatch that faults before its first instruction does not count as the first run.
+    if (ticks > 0 && my_process->first_run_tick == NOT_YET_TICK) my_process->first_run_tick = quantum_start;
+    g_process_table.quantum_ticks(my_index) += ticks;
+    return status;
+}
 
-        // Step 1: Briefly lock ONLY to get a pointer to the process.
+// Takes the process off core_id after a quantum that ended with status. Called without
+// rr_g_process_mutex.
+static void rr_leave_core(int core_id, ProcessIndex my_index, ExecStatus status) {
+    RrCoreState& core = rr_core_state[core_id];
+    Process* my_process = &g_process_table[my_index];
+    if (status == ExecStatus::TERMINATED) {
+        // Lock cout, print, then lock process list to terminate.
+        { std::lock_guard<std::mutex> lock(g_cout_mutex); std::cout << "\nProcess " << my_process->cold->processName << " terminated: " << my_process->cold->termination_reason << std::endl; }
         {
             std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-            my_process = rr_g_running_processes[core_id];
+            g_process_table.state(my_index) = ProcessState::FINISHED;
+            my_process->finish_time = std::chrono::system_clock::now();
+            my_process->finish_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+            rr_g_finished_processes.push_back(my_index);
+            // A coroutine has destroyed its own frame by now.
+            if (static_cast<size_t>(my_index) < rr_coroutines.size()) rr_coroutines[my_index] = nullptr;
+            rr_g_running_processes[core_id] = NO_PROCESS;
+            core.stepping = false;
+            core.switching = !rr_g_ready_queue.empty();
+            memory_manager->deallocate_for_process(*my_process);
+            rr_g_scheduler_cv.notify_one();
         }
+        return;
+    }
 
-        // If no process, idle and loop again.
-        if (!my_process) {
-            vmstats_increment_idle_ticks();
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            continue;
+    if (status == ExecStatus::BLOCKED) {
+        // Page fault: block the process; the faulting instruction is retried once it is dispatched again.
+        // A deferred fault still needs its page, so the process waits for the pager first.
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        g_process_table.state(my_index) = ProcessState::BLOCKED;
+        rr_g_ready_queue.blocked(my_index);
+        if (my_process->mem_data.pending_fault_page >= 0) {
+            rr_g_fault_queue.push_back(my_index);
+            rr_pager_cv.notify_one();
+        } else {
+            rr_g_blocked_queue.push_back(my_index);
         }
+        rr_g_running_processes[core_id] = NO_PROCESS;
+        core.stepping = false;
+        core.switching = !rr_g_ready_queue.empty();
+        rr_g_scheduler_cv.notify_one();
+        return;
+    }
 
-        // Step 2: Failsafe check for already finished process.
-        if (my_process->program_counter >= my_process->commands.size()) {
-            {
-                std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-                rr_g_finished_processes.push_back(my_process);
-                rr_g_running_processes[core_id] = nullptr;
-                memory_manager->deallocate_for_process(*my_process);
-                rr_g_scheduler_cv.notify_one();
-            }
+    if (status == ExecStatus::SLEEPING) {
+        // SLEEP: park the process on the timer wheel and free the core for the next ready process.
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        g_process_table.state(my_index) = ProcessState::SLEEPING;
+        rr_g_ready_queue.slept(my_index);
+        my_process->wake_tick = static_cast<uint64_t>(get_cpu_clock_ticks()) + my_process->sleep_ticks_remaining;
+        rr_g_sleep_wheel.schedule(my_index, my_process->wake_tick);
+        rr_g_running_processes[core_id] = NO_PROCESS;
+        core.stepping = false;
+        core.switching = !rr_g_ready_queue.empty();
+        rr_g_scheduler_cv.notify_one();
+        return;
+    }
+
+    // Step 3: The program finished or the quantum is spent; either way the process leaves the core.
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        if (status == ExecStatus::FINISHED) {
+            g_process_table.state(my_index) = ProcessState::FINISHED;
+            my_process->finish_time = std::chrono::system_clock::now();
+            my_process->finish_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+            rr_g_finished_processes.push_back(my_index);
+            if (static_cast<size_t>(my_index) < rr_coroutines.size()) rr_coroutines[my_index] = nullptr;
+            memory_manager->deallocate_for_process(*my_process);
+        } else { // Quantum expired
+            g_process_table.state(my_index) = ProcessState::READY;
+            rr_g_ready_queue.quantum_expired(my_index);
+            rr_g_ready_queue.push_back(my_index);
+        }
+        rr_g_running_processes[core_id] = NO_PROCESS;
+        core.stepping = false;
+        core.switching = !rr_g_ready_queue.empty();
+        rr_g_scheduler_cv.notify_one();
+    }
+    // Memory layout for this quantum goes to the snapshot stream.
+    snapshot_capture();
+}
+
+// Runs one quantum of the process a host thread claimed on core_id and takes the process off the
+// core. Called without rr_g_process_mutex.
+static void rr_run_quantum(int core_id, ProcessIndex my_index, int my_quantum) {
+    rr_leave_core(core_id, my_index, rr_execute_quantum(core_id, my_index, my_quantum));
+}
+
+// --- Process Coroutines ---
+// core-threads "coroutine": each process runs as a coroutine whose quanta are its cores' quanta, under
+// the ready-queue policy as usual. A quantum ends in the hooks below, which take the process off its
+// core as rr_run_quantum does. The core and its quantum stay put until the process leaves the core.
+class RrCoroutineHost : public CoroutineHost {
+public:
+    ExecStatus run_quantum(Process&, ProcessIndex index) override {
+        int core_id = g_process_table.core(index);
+        return rr_execute_quantum(core_id, index, rr_core_state[core_id].quantum);
+    }
+    void quantum_expired(ProcessIndex index, std::coroutine_handle<>) override {
+        rr_leave_core(g_process_table.core(index), index, ExecStatus::RUNNING);
+    }
+    void page_fault(Process&, ProcessIndex index, std::coroutine_handle<>) override {
+        rr_leave_core(g_process_table.core(index), index, ExecStatus::BLOCKED);
+    }
+    void sleep(ProcessIndex index, uint64_t, std::coroutine_handle<>) override {
+        rr_leave_core(g_process_table.core(index), index, ExecStatus::SLEEPING);
+    }
+    void retire(ProcessIndex index, ExecStatus status) override {
+        rr_leave_core(g_process_table.core(index), index, status);
+    }
+};
+static RrCoroutineHost rr_coroutine_host;
+
+// The coroutine of a process a host thread claimed, created on its first dispatch in coroutine mode.
+// Caller holds rr_g_process_mutex.
+static std::coroutine_handle<> rr_process_coroutine(ProcessIndex index) {
+    if (rr_coroutines.size() <= static_cast<size_t>(index)) rr_coroutines.resize(static_cast<size_t>(index) + 1);
+    std::coroutine_handle<>& handle = rr_coroutines[index];
+    if (!handle) {
+        Process& process = g_process_table[index];
+        process.mem_data.defer_page_faults = true;
+        handle = run_process(rr_coroutine_host, process, index).handle();
+    }
+    return handle;
+}
+
+// Destroys the frames of the processes that have not finished, which keep all their state in the
+// PCB, and lets their page faults block again. For leaving coroutine mode; caller holds
+// rr_g_process_mutex, with no host thread running.
+static void rr_drop_coroutines() {
+    for (size_t index = 0; index < rr_coroutines.size(); ++index) {
+        if (!rr_coroutines[index]) continue;
+        rr_coroutines[index].destroy();
+        rr_coroutines[index] = nullptr;
+        g_process_table[static_cast<ProcessIndex>(index)].mem_data.defer_page_faults = false;
+    }
+}
+
+// --- The Pager Thread ---
+// Brings in the pages of deferred faults one process at a time, off the cores, and hands each process
+// to the blocked queue, from which the scheduler readies it to retry the instruction. A process stays
+// at the front of rr_g_fault_queue meanwhile, so checkpoints and the shutdown check still see it.
+static void rr_pager_func() {
+    std::unique_lock<std::mutex> lock(rr_g_process_mutex);
+    while (rr_g_is_running) {
+        if (rr_g_fault_queue.empty() || rr_cores_paused) {
+            rr_pager_cv.wait_for(lock, std::chrono::milliseconds(50));
             continue;
         }
+        ProcessIndex index = rr_g_fault_queue.front();
+        rr_pager_busy = true;
+        lock.unlock();
+        memory_manager->resolve_page_fault(g_process_table[index]);
+        lock.lock();
+        rr_pager_busy = false;
+        rr_g_fault_queue.pop_front();
+        rr_g_blocked_queue.push_back(index);
+        rr_g_scheduler_cv.notify_one();
+    }
+}
 
-        // Step 3: Execute one instruction. This happens OUTSIDE the main lock.
-        const std::string& command_str = my_process->commands[my_process->program_counter];
-        std::istringstream iss(command_str);
-        std::string command_token;
-        iss >> command_token;
-        bool success = true;
-
-        if (command_token == "read" || command_token == "write") {
-            int address;
-            iss >> std::hex >> address;
-            bool is_write = (command_token == "write");
-            
-            // Memory access is a slow operation, so it's critical it happens without holding the process lock.
-            char* physical_ptr = memory_manager->access_memory(*my_process, address, is_write);
-
-            if (my_process->mem_data.terminated_by_error) {
-                success = false;
-                // Lock cout, print, then lock process list to terminate.
-                { std::lock_guard<std::mutex> lock(g_cout_mutex); std::cout << "\nProcess " << my_process->processName << " terminated: " << my_process->mem_data.termination_reason << std::endl; }
-                {
-                    std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-                    my_process->state = ProcessState::FINISHED;
-                    rr_g_finished_processes.push_back(my_process);
-                    rr_g_running_processes[core_id] = nullptr;
-                    memory_manager->deallocate_for_process(*my_process);
-                    rr_g_scheduler_cv.notify_one();
-                }
-            } else if (physical_ptr == nullptr) {
-                success = false;
-                // Lock process list to block the process.
-                {
-                    std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-                    my_process->state = ProcessState::BLOCKED;
-                    rr_g_blocked_queue.push_back(my_process);
-                    rr_g_running_processes[core_id] = nullptr;
-                    rr_g_scheduler_cv.notify_one();
-                }
-            } else {
-                if (is_write) {
-                    int value; iss >> value;
-                    *(reinterpret_cast<uint16_t*>(physical_ptr)) = static_cast<uint16_t>(value);
+// A process the scheduler assigned to a core that cpu-set retired, or whose host threads are being
+// replaced, before any host thread claimed it goes back to the ready queue. Caller holds
+// rr_g_process_mutex.
+static void rr_drain_core(int core_id) {
+    ProcessIndex index = rr_g_running_processes[core_id];
+    if (index == NO_PROCESS || rr_core_state[core_id].stepping) return;
+    g_process_table.state(index) = ProcessState::READY;
+    rr_g_ready_queue.push_back(index);
+    rr_g_running_processes[core_id] = NO_PROCESS;
+    rr_g_scheduler_cv.notify_one();
+}
+
+// core-threads "per-core": one host thread owns core_id. An idle core waits for the scheduler's
+// assignment signal instead of polling the list.
+void rr_core_worker_func(int core_id, int generation) {
+    while (rr_g_is_running) {
+        ProcessIndex my_index;
+        int my_quantum;
+
+        // Step 1: Lock ONLY to claim the process assigned to this core.
+        {
+            std::unique_lock<std::mutex> lock(rr_g_process_mutex);
+            if (core_id >= CPU_COUNT || generation != rr_host_generation) {
+                rr_drain_core(core_id);
+                break;
+            }
+            my_index = rr_g_running_processes[core_id];
+            if (my_index == NO_PROCESS || rr_cores_paused) {
+                bool assigned = rr_core_cv.wait_for(lock, std::chrono::milliseconds(50), [core_id, generation] {
+                    return !rr_g_is_running || (!rr_cores_paused && rr_g_running_processes[core_id] != NO_PROCESS) ||
+                           core_id >= CPU_COUNT || generation != rr_host_generation;
+                });
+                if (!assigned) {
+                    vmstats_increment_idle_ticks();
+                    rr_core_state[core_id].switching = false;
                 }
-                vmstats_increment_active_ticks();
+                continue;
             }
-        } else {
-            vmstats_increment_active_ticks();
+            rr_core_state[core_id].stepping = true;
+            my_quantum = rr_core_state[core_id].quantum;
         }
+        rr_run_quantum(core_id, my_index, my_quantum);
+    }
+}
+
+// Pool: the first core from the cursor on whose process no host thread is running, -1 if none or
+// while the cores are paused. Starting after the last core claimed steps every busy core in turn, so
+// no core's process waits more than one round of the others' quanta, as with a thread per core.
+// Caller holds rr_g_process_mutex.
+static int rr_next_core_to_step() {
+    if (rr_cores_paused) return -1;
+    size_t cores = rr_g_running_processes.size();
+    for (size_t k = 0; k < cores; ++k) {
+        size_t core = (rr_pool_cursor + k) % cores;
+        if (rr_g_running_processes[core] != NO_PROCESS && !rr_core_state[core].stepping) return static_cast<int>(core);
+    }
+    return -1;
+}
 
-        // Step 4: If instruction was successful, update counters and check for end-of-quantum or completion.
-        if (success) {
-            my_process->program_counter++;
-            my_process->commands_executed_this_quantum++;
-
-            bool is_finished = (my_process->program_counter >= my_process->commands.size());
-            bool quantum_expired = (my_process->commands_executed_this_quantum >= qCycles);
-
-            if (is_finished || quantum_expired) {
-                // Now, briefly lock ONLY to update the process lists.
-                std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-                if (is_finished) {
-                    my_process->state = ProcessState::FINISHED;
-                    my_process->finish_time = std::chrono::system_clock::now();
-                    rr_g_finished_processes.push_back(my_process);
-                    memory_manager->deallocate_for_process(*my_process);
-                } else { // Quantum expired
-                    my_process->state = ProcessState::READY;
-                    rr_g_ready_queue.push_back(my_process);
+// core-threads "pool": one of rr_pool_size host threads that step the virtual cores, a quantum at a
+// time. The emulated cores keep their semantics; only which host thread runs a quantum changes. In
+// coroutine mode a step resumes the process's coroutine, which runs the quantum.
+void rr_host_worker_func(int host_index, int generation) {
+    while (rr_g_is_running) {
+        int core_id;
+        ProcessIndex my_index;
+        int my_quantum;
+        std::coroutine_handle<> coroutine;
+        {
+            std::unique_lock<std::mutex> lock(rr_g_process_mutex);
+            if (generation != rr_host_generation) break;
+            core_id = rr_next_core_to_step();
+            // Retired cores are drained rather than run.
+            while (core_id >= CPU_COUNT) {
+                rr_drain_core(core_id);
+                core_id = rr_next_core_to_step();
+            }
+            if (core_id < 0) {
+                bool found = rr_core_cv.wait_for(lock, std::chrono::milliseconds(50), [generation] {
+                    return !rr_g_is_running || generation != rr_host_generation || rr_next_core_to_step() >= 0;
+                });
+                // One idle tick per idle core per wait, as the per-core threads count them.
+                if (!found && host_index == 0) {
+                    for (int i = 0; i < CPU_COUNT; ++i) {
+                        if (rr_g_running_processes[i] != NO_PROCESS) continue;
+                        vmstats_increment_idle_ticks();
+                        rr_core_state[i].switching = false;
+                    }
                 }
-                rr_g_running_processes[core_id] = nullptr;
-                rr_g_scheduler_cv.notify_one();
+                continue;
             }
+            rr_core_state[core_id].stepping = true;
+            rr_pool_cursor = static_cast<size_t>(core_id) + 1;
+            my_index = rr_g_running_processes[core_id];
+            my_quantum = rr_core_state[core_id].quantum;
+            if (rr_coroutine_mode) coroutine = rr_process_coroutine(my_index);
         }
+        // The coroutine is suspended again, and perhaps already resumed elsewhere, when resume() returns.
+        if (coroutine) coroutine.resume();
+        else rr_run_quantum(core_id, my_index, my_quantum);
     }
 }
 
@@ -300,8 +595,8 @@ void rr_display_processes() {
     // --- NEW: Calculate CPU Utilization ---
     int busyCores = 0;
     // Count how many cores are not idle.
-    for (const auto& p : rr_g_running_processes) {
-        if (p != nullptr) {
+    for (ProcessIndex p : rr_g_running_processes) {
+        if (p != NO_PROCESS) {
             busyCores++;
         }
     }
@@ -315,34 +610,61 @@ void rr_display_processes() {
     std::cout << "CPU Utilization: " << cpuUtil << "%" << std::endl;
 
     // The rest of your original display logic remains.
+    ReadyPolicy policy = rr_g_ready_queue.policy();
+    bool proportional = policy == ReadyPolicy::STRIDE || policy == ReadyPolicy::LOTTERY;
     std::cout << "\nRunning processes:\n";
-    for (const auto& p : rr_g_running_processes) {
-        if (p) {
-            std::cout << "  " << p->processName << " (ID: " << p->id << ")\n";
+    for (ProcessIndex p : rr_g_running_processes) {
+        if (p != NO_PROCESS) {
+            std::cout << "  " << g_process_table[p].cold->processName << " (ID: " << g_process_table[p].id << ")";
+            if (proportional) {
+                std::cout << " weight " << g_process_table[p].weight << ", "
+                          << g_process_table[p].ticks_executed.load(std::memory_order_relaxed) << " ticks";
+            }
+            if (policy == ReadyPolicy::EDF && g_process_table[p].deadline_tick != NOT_YET_TICK) {
+                std::cout << " deadline tick " << g_process_table[p].deadline_tick
+                          << (g_process_table[p].deadline_rejected ? " (best effort)" : "");
+            }
+            std::cout << "\n";
         }
     }
-    std::cout << "\nFinished processes:\n";
-    for (const auto& p : rr_g_finished_processes) {
-        if (p) {
-            std::cout << "  " << p->processName << " (ID: " << p->id << ")\n";
+    if (policy == ReadyPolicy::MLFQ) {
+        std::cout << "\nReady processes per MLFQ level:";
+        for (int level = 0; level < rr_g_ready_queue.level_count(); ++level) {
+            std::cout << " " << rr_g_ready_queue.level_size(level);
         }
+        std::cout << "\n";
+    }
+    if (rr_g_quantum_tuner.enabled() && policy != ReadyPolicy::MLFQ && policy != ReadyPolicy::SJF) {
+        std::cout << "\nAdaptive quantum: " << rr_g_quantum_tuner.quantum() << " ticks\n";
+    }
+    std::cout << "\nSleeping processes: " << rr_g_sleep_wheel.size() << "\n";
+    std::cout << "\nFinished processes:\n";
+    for (ProcessIndex p : rr_g_finished_processes) {
+        std::cout << "  " << g_process_table[p].cold->processName << " (ID: " << g_process_table[p].id << ")\n";
     }
     std::cout << "-------------------------------------------------------------\n\n";
 }
 
 void rr_create_process_with_commands(std::string processName, size_t memory_size, const std::vector<std::string>& commands) {
     // Create a new process
-    std::shared_ptr<Process> pcb;
-    
-    pcb = std::make_shared<Process>(cpuClocks);
-    pcb->start_time = std::chrono::system_clock::now(); 
-    pcb->processName = processName;
-    pcb->memory_size = memory_size;
-
-    pcb->commands = commands;
-
-    cpuClocks++;
-    rr_g_ready_queue.push_back(pcb);
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        ProcessIndex index = rr_new_process(processName);
+        if (index == NO_PROCESS) return;
+        Process* pcb = &g_process_table[index];
+        pcb->start_time = std::chrono::system_clock::now(); 
+        pcb->arrival_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+        pcb->cold->processName = processName;
+        pcb->weight = static_cast<uint32_t>(DEFAULT_WEIGHT);
+        print_log_register(pcb->cold->processName, pcb->cold->output);
+        pcb->memory_size = memory_size;
+        load_program(*pcb, intern_program(commands));
+
+        // READ / WRITE need backing memory, like processes from the creation queue.
+        memory_manager->allocate_for_process(*pcb, memory_size > 0 ? memory_size : MIN_MEM_PER_PROC);
+        g_process_table.state(index) = ProcessState::READY;
+        rr_g_ready_queue.push_back(index);
+    }
 
     // Notify scheduler that a new process is available
     rr_g_scheduler_cv.notify_one();
@@ -353,12 +675,29 @@ void rr_write_processes() {
     std::ofstream outfile("csopesy-log.txt", std::ios::app);
     outfile << "--- RR SCHEDULER REPORT ---\n";
     outfile << "Running processes:\n";
-    for (const auto& p : rr_g_running_processes) {
-        if (p) outfile << "  " << p->processName << "\n";
+    for (ProcessIndex p : rr_g_running_processes) {
+        if (p != NO_PROCESS) outfile << "  " << g_process_table[p].cold->processName << "\n";
     }
     outfile << "Finished processes:\n";
-    for (const auto& p : rr_g_finished_processes) {
-        if (p) outfile << "  " << p->processName << "\n";
+    for (ProcessIndex p : rr_g_finished_processes) {
+        outfile << "  " << g_process_table[p].cold->processName << "\n";
+    }
+    write_deadline_report(outfile, rr_g_finished_processes);
+    write_core_cache_report(outfile);
+    if (rr_g_quantum_tuner.enabled()) {
+        // The full history goes to its own file, one row per update.
+        std::vector<QuantumTuner::Sample> samples = rr_g_quantum_tuner.log();
+        std::ofstream quantum_log("csopesy-quantum-log.txt");
+        quantum_log << "tick,quantum,ready,switch_ns,tick_ns,overhead\n";
+        int lowest = rr_g_quantum_tuner.quantum(), highest = lowest;
+        for (const auto& sample : samples) {
+            quantum_log << sample.tick << "," << sample.quantum << "," << sample.ready << "," << sample.switch_ns << ","
+                        << sample.tick_ns << "," << sample.overhead << "\n";
+            lowest = std::min(lowest, sample.quantum);
+            highest = std::max(highest, sample.quantum);
+        }
+        outfile << "Adaptive quantum: " << rr_g_quantum_tuner.quantum() << " ticks now, " << lowest << "-" << highest
+                << " over the last " << samples.size() << " updates (csopesy-quantum-log.txt)\n";
     }
     outfile.close();
 }
@@ -366,26 +705,19 @@ void rr_write_processes() {
 // --- The Process Generator for 'scheduler-start' ---
 void rr_create_processes(MemoryManager& mm) {
     process_maker_running = true;
-    while (process_maker_running) {
-        {
-            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-            g_creation_queue.push_back({"process" + std::to_string(cpuClocks++), 256});
-        }
-        std::cout << "TEST" << std::endl;
-        rr_g_scheduler_cv.notify_one();
-        std::this_thread::sleep_for(std::chrono::milliseconds(processFrequency));
-    }
+    run_workload_generator(rr_g_process_mutex, rr_g_scheduler_cv, "process");
 
     // --- Shutdown Logic ---
     while (true) {
         bool all_done;
         {
             std::lock_guard<std::mutex> lock(rr_g_process_mutex);
-            bool running_is_empty = std::all_of(rr_g_running_processes.begin(), rr_g_running_processes.end(), [](const auto& p){ return p == nullptr; });
-            all_done = g_creation_queue.empty() && rr_g_ready_queue.empty() && rr_g_blocked_queue.empty() && running_is_empty;
+            bool running_is_empty = std::all_of(rr_g_running_processes.begin(), rr_g_running_processes.end(), [](ProcessIndex p){ return p == NO_PROCESS; });
+            all_done = g_creation_queue.empty() && rr_g_ready_queue.empty() && rr_g_blocked_queue.empty() && rr_g_fault_queue.empty() && running_is_empty;
         }
-        if (all_done) break;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        // exit stops the scheduler whether or not its processes are done.
+        if (all_done || !rr_g_is_running) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
     rr_g_is_running = false;
@@ -393,19 +725,171 @@ void rr_create_processes(MemoryManager& mm) {
 }
 
 // --- The Main Scheduler Entry Point ---
+bool rr_runs_scheduler(const std::string& name) {
+    ReadyPolicy policy;
+    return parse_ready_policy(name, policy);
+}
+
 int RR() {
     rr_g_is_running = true;
+    {
+        ReadyPolicy policy = ReadyPolicy::FIFO;
+        parse_ready_policy(scheduler, policy);
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        rr_g_ready_queue.set_policy(policy, mlfq_config_from_globals());
+        rr_g_quantum_tuner.configure(quantum_tuner_config_from_globals(), qCycles);
+        g_core_caches.configure(core_cache_config_from_globals(), CPU_COUNT);
+        rr_g_running_processes.assign(static_cast<size_t>(CPU_COUNT), NO_PROCESS);
+        rr_last_boost_tick = static_cast<uint64_t>(get_cpu_clock_ticks());
+    }
     
     std::thread scheduler(rr_scheduler_thread_func);
-    std::vector<std::thread> core_workers;
-    for (int i = 0; i < CPU_COUNT; ++i) {
-        core_workers.emplace_back(rr_core_worker_func, i);
+    std::thread pager(rr_pager_func);
+    {
+        std::lock_guard<std::mutex> lock(rr_host_threads_mutex);
+        rr_pooled = CORE_THREADS != "per-core";
+        rr_pool_size = rr_resolve_pool_size(HOST_THREADS);
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            rr_coroutine_mode = CORE_THREADS == "coroutine";
+        }
+        rr_start_host_threads();
     }
     
     scheduler.join();
-    for (auto& worker : core_workers) {
-        worker.join();
+    pager.join();
+    std::vector<std::thread> host_threads;
+    {
+        std::lock_guard<std::mutex> lock(rr_host_threads_mutex);
+        host_threads.swap(rr_host_threads);
+    }
+    for (auto& host_thread : host_threads) {
+        host_thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        rr_drop_coroutines();
     }
     
     return 0;
-}
\ No newline at end of file
+}
+
+// --- Host Threads ---
+// Pool size for host-threads: the value, or the host's hardware concurrency for 0.
+static int rr_resolve_pool_size(int host_threads) {
+    if (host_threads > 0) return std::min(host_threads, CoreCaches::MAX_CORES);
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Starts the host threads of the current mode: a pool of rr_pool_size, or one per core. Caller holds
+// rr_host_threads_mutex, with the list empty.
+static void rr_start_host_threads() {
+    std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+    int threads = rr_pooled ? rr_pool_size : CPU_COUNT.load();
+    for (int i = 0; i < threads; ++i) {
+        if (rr_pooled) rr_host_threads.emplace_back(rr_host_worker_func, i, rr_host_generation);
+        else rr_host_threads.emplace_back(rr_core_worker_func, i, rr_host_generation);
+    }
+}
+
+void rr_set_core_threads(const std::string& mode, int host_threads) {
+    std::lock_guard<std::mutex> threads_lock(rr_host_threads_mutex);
+    std::vector<std::thread> stopped;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        rr_host_generation++;
+        stopped.swap(rr_host_threads);
+    }
+    rr_core_cv.notify_all();
+    for (auto& host_thread : stopped) {
+        host_thread.join();
+    }
+    rr_pooled = mode != "per-core";
+    rr_pool_size = rr_resolve_pool_size(host_threads);
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        if (mode != "coroutine") rr_drop_coroutines();
+        rr_coroutine_mode = mode == "coroutine";
+    }
+    // Only RR() starts the first set; before it runs there is nothing to replace.
+    if (!stopped.empty()) rr_start_host_threads();
+}
+
+// --- Pausing the Cores ---
+// A quantum runs outside rr_g_process_mutex, so holding the lock alone does not stop a process
+// mid-instruction. Pausing stops host threads from claiming processes and the pager from taking
+// faults, and waits until every quantum and page-in in flight has ended; each process is then either
+// queued or assigned to a core but not started.
+void rr_pause_cores() {
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            rr_cores_paused = true;
+            if (!rr_pager_busy && std::none_of(std::begin(rr_core_state), std::end(rr_core_state), [](const RrCoreState& core) { return core.stepping; })) return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void rr_resume_cores() {
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        rr_cores_paused = false;
+    }
+    rr_core_cv.notify_all();
+    rr_pager_cv.notify_one();
+}
+
+// --- Core Hotplug ---
+// New cores get a running-list slot, a cache and a NUMA node before a host thread can step them.
+// Retiring cores leave the dispatch loop at once; a host thread mid-quantum on one finishes that
+// quantum and hands the process back to the ready queue like any expired quantum, and a per-core
+// thread then exits. The call waits for that, and only then shrinks the running list, so no host
+// thread ever indexes past it.
+int rr_set_core_count(int cores) {
+    cores = std::clamp(cores, 1, CoreCaches::MAX_CORES);
+    std::lock_guard<std::mutex> threads_lock(rr_host_threads_mutex);
+    std::vector<std::thread> retired;
+    int previous;
+    {
+        std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+        previous = CPU_COUNT;
+        if (cores > previous) {
+            rr_g_running_processes.resize(static_cast<size_t>(cores), NO_PROCESS);
+            g_core_caches.add_cores(cores);
+        }
+        memory_manager->set_numa_cores(cores);
+        vmstats_set_core_count(cores);
+        // A pool steps whatever cores there are; per-core threads come and go with their cores.
+        if (!rr_pooled && !rr_host_threads.empty()) {
+            for (int i = static_cast<int>(rr_host_threads.size()); i < cores; ++i) {
+                rr_host_threads.emplace_back(rr_core_worker_func, i, rr_host_generation);
+            }
+            for (size_t i = static_cast<size_t>(cores); i < rr_host_threads.size(); ++i) {
+                retired.push_back(std::move(rr_host_threads[i]));
+            }
+            rr_host_threads.resize(std::min(rr_host_threads.size(), static_cast<size_t>(cores)));
+        }
+    }
+    rr_core_cv.notify_all();
+    rr_g_scheduler_cv.notify_one();
+    for (auto& host_thread : retired) {
+        host_thread.join();
+    }
+    while (cores < previous) {
+        {
+            std::lock_guard<std::mutex> lock(rr_g_process_mutex);
+            bool drained = true;
+            for (size_t i = static_cast<size_t>(cores); i < rr_g_running_processes.size(); ++i) {
+                rr_drain_core(static_cast<int>(i));
+                drained = drained && rr_g_running_processes[i] == NO_PROCESS;
+            }
+            if (drained) {
+                rr_g_running_processes.resize(static_cast<size_t>(cores));
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return previous;
+}
@@ -1,15 +1,36 @@
 #ifndef RR_H
 #define RR_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 class MemoryManager; // Forward declaration is enough
+class Process;
 
 // --- Public Function Declarations ONLY ---
 int RR();
+// True for the schedulers RR() runs: "rr" and the other ready-queue policies in ReadyQueue.h.
+bool rr_runs_scheduler(const std::string& name);
 void rr_create_processes(MemoryManager& mm);
+// The scheduler thread's creation step: every request in g_creation_queue becomes a ready process
+// with its table entry, memory and program. Caller holds rr_g_process_mutex.
+void rr_create_queued_processes(uint64_t now);
 void rr_display_processes();
 void rr_write_processes();
+// Fills in the fixed program every scheduler-generated process runs.
+void rr_load_generated_program(Process& pcb, size_t memory_size);
 std::vector<std::string> rr_getRunningProcessNames();
+// cpu-set: runs on cores cores from now on, clamped to [1, 128], and returns the previous count.
+// Retired cores finish their quantum and return their process to the ready queue first.
+int rr_set_core_count(int cores);
+// Replaces the host threads behind the virtual cores, by core-threads mode: "pool", host_threads
+// threads (0 for the hardware concurrency) that step the cores in turns; "coroutine", such a pool
+// that resumes process coroutines and defers page faults to a pager thread; or "per-core", one
+// thread per core. The old threads finish their quanta first.
+void rr_set_core_threads(const std::string& mode, int host_threads);
+// Stops the cores between quanta: returns once no process is mid-quantum, and no host thread starts
+// one until rr_resume_cores(). For checkpoints.
+void rr_pause_cores();
+void rr_resume_cores();
 
 #endif // RR_H
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "ReadyQueue.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+#include "global.h"
+#include "Interpreter.h"
+
+bool parse_ready_policy(const std::string& name, ReadyPolicy& policy) {
+    if (name == "rr") policy = ReadyPolicy::FIFO;
+    else if (name == "mlfq") policy = ReadyPolicy::MLFQ;
+    else if (name == "sjf") policy = ReadyPolicy::SJF;
+    else if (name == "srtf") policy = ReadyPolicy::SRTF;
+    else if (name == "stride") policy = ReadyPolicy::STRIDE;
+    else if (name == "lottery") policy = ReadyPolicy::LOTTERY;
+    else if (name == "edf") policy = ReadyPolicy::EDF;
+    else return false;
+    return true;
+}
+
+MlfqConfig mlfq_config_from_globals() {
+    MlfqConfig config;
+    config.levels = std::clamp(MLFQ_LEVELS, 1, ReadyQueue::MAX_LEVELS);
+    std::istringstream listed(MLFQ_QUANTA);
+    long long quantum = 0;
+    for (int level = 0; level < config.levels; ++level) {
+        long long next;
+        if (listed >> next && next > 0) quantum = next;
+        else quantum = level == 0 ? std::max(1, qCycles) : quantum * 2;
+        quantum = std::min<long long>(quantum, INT_MAX);
+        config.quanta.push_back(static_cast<int>(quantum));
+    }
+    config.boost_ticks = MLFQ_BOOST_TICKS > 0 ? static_cast<uint64_t>(MLFQ_BOOST_TICKS) : 0;
+    return config;
+}
+
+void ReadyQueue::set_policy(ReadyPolicy policy, const MlfqConfig& mlfq) {
+    policy_ = policy;
+    mlfq_ = mlfq;
+    mlfq_.levels = std::clamp(mlfq_.levels, 1, MAX_LEVELS);
+    mlfq_.quanta.resize(mlfq_.levels, mlfq_.quanta.empty() ? 1 : mlfq_.quanta.back());
+    // A fixed workload-seed replays the same lottery draws as well.
+    lottery_rng_ = WorkloadEngine(WORKLOAD_SEED != 0 ? WORKLOAD_SEED : std::random_device{}());
+}
+
+int ReadyQueue::level_of(ProcessIndex index) const {
+    if (policy_ != ReadyPolicy::MLFQ) return 0;
+    return std::min<int>(g_process_table.priority(index), mlfq_.levels - 1);
+}
+
+void ReadyQueue::push_back(ProcessIndex index) {
+    if (policy_ == ReadyPolicy::LOTTERY) {
+        tickets_.add(index, g_process_table[index].weight);
+        return;
+    }
+    if (policy_ == ReadyPolicy::STRIDE) {
+        Process& process = g_process_table[index];
+        process.stride_pass = std::max(process.stride_pass, stride_pass_);
+        heap_.push(index, process.stride_pass);
+        return;
+    }
+    if (policy_ == ReadyPolicy::EDF) {
+        const Process& process = g_process_table[index];
+        heap_.push(index, process.deadline_rejected ? NOT_YET_TICK : process.deadline_tick);
+        return;
+    }
+    if (uses_heap()) {
+        const Process& process = g_process_table[index];
+        size_t length = program_length(process);
+        size_t pc = static_cast<size_t>(std::max(0, process.program_counter));
+        heap_.push(index, length > pc ? length - pc : 0);
+        return;
+    }
+    int level = level_of(index);
+    levels_[level].push_back(index);
+    nonempty_ |= uint64_t(1) << level;
+    size_++;
+}
+
+ProcessIndex ReadyQueue::pop_front() {
+    // Processes left on the levels by a switch to a heap or lottery policy go first.
+    if (nonempty_ == 0) {
+        if (heap_.empty() || (policy_ == ReadyPolicy::LOTTERY && !tickets_.empty())) return tickets_.draw(lottery_rng_);
+        if (policy_ == ReadyPolicy::STRIDE) stride_pass_ = std::max(stride_pass_, heap_.top_key());
+        return heap_.pop();
+    }
+    int level = std::countr_zero(nonempty_);
+    ProcessIndex index = levels_[level].front();
+    levels_[level].pop_front();
+    if (levels_[level].empty()) nonempty_ &= ~(uint64_t(1) << level);
+    size_--;
+    return index;
+}
+
+ProcessIndex ReadyQueue::pop_for_core(int core, uint64_t now, uint64_t migration_cost) {
+    if (nonempty_ == 0) return pop_front();
+    int level = std::countr_zero(nonempty_);
+    auto& queue = levels_[level];
+    size_t window = std::min(queue.size(), AFFINITY_WINDOW);
+    size_t pick = window;
+    size_t cold = window;
+    for (size_t i = 0; i < window; ++i) {
+        ProcessIndex index = queue[i];
+        int previous = g_process_table.core(index);
+        if (previous == core) {
+            pick = i;
+            break;
+        }
+        if (cold == window && (previous < 0 || g_process_table[index].left_core_tick + migration_cost <= now)) cold = i;
+    }
+    if (pick == window) pick = cold == window ? 0 : cold;
+    ProcessIndex index = queue[pick];
+    queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(pick));
+    if (queue.empty()) nonempty_ &= ~(uint64_t(1) << level);
+    size_--;
+    return index;
+}
+
+int ReadyQueue::quantum(ProcessIndex index) const {
+    if (policy_ == ReadyPolicy::MLFQ) return mlfq_.quanta[level_of(index)];
+    if (policy_ == ReadyPolicy::SJF) return INT_MAX;
+    if (rr_g_quantum_tuner.enabled()) return rr_g_quantum_tuner.quantum();
+    return std::max(1, qCycles);
+}
+
+void ReadyQueue::charge(ProcessIndex index) {
+    if (policy_ != ReadyPolicy::STRIDE) return;
+    // A dispatch costs at least one tick. A process that faults before its first instruction would
+    // otherwise keep the lowest pass and be retried at once, and under memory pressure its page can be
+    // evicted again before it runs, starving everything behind it.
+    Process& process = g_process_table[index];
+    uint64_t ticks = std::max<uint64_t>(1, g_process_table.quantum_ticks(index));
+    process.stride_pass += ticks * (STRIDE_UNIT / std::max<uint32_t>(1, process.weight));
+}
+
+void ReadyQueue::quantum_expired(ProcessIndex index) {
+    charge(index);
+    if (policy_ != ReadyPolicy::MLFQ) return;
+    uint8_t& level = g_process_table.priority(index);
+    if (level + 1 < mlfq_.levels) level++;
+}
+
+void ReadyQueue::blocked(ProcessIndex index) {
+    charge(index);
+    if (policy_ != ReadyPolicy::MLFQ) return;
+    uint8_t& level = g_process_table.priority(index);
+    if (level > 0) level--;
+}
+
+void ReadyQueue::slept(ProcessIndex index) {
+    charge(index);
+}
+
+bool ReadyQueue::admit(ProcessIndex index, uint64_t now, int cores) {
+    Process& candidate = g_process_table[index];
+    if (policy_ != ReadyPolicy::EDF || candidate.deadline_tick == NOT_YET_TICK) return true;
+    std::erase_if(admitted_, [](ProcessIndex i) { return g_process_table.state(i) == ProcessState::FINISHED; });
+
+    struct Demand {
+        uint64_t deadline;
+        uint64_t work;
+    };
+    auto remaining = [](const Process& p) {
+        uint64_t done = p.ticks_executed.load(std::memory_order_relaxed);
+        return p.work_ticks > done ? p.work_ticks - done : 0;
+    };
+    std::vector<Demand> demands;
+    demands.reserve(admitted_.size() + 1);
+    for (ProcessIndex i : admitted_) demands.push_back({g_process_table[i].deadline_tick, remaining(g_process_table[i])});
+    demands.push_back({candidate.deadline_tick, candidate.work_ticks});
+    std::sort(demands.begin(), demands.end(), [](const Demand& a, const Demand& b) { return a.deadline < b.deadline; });
+
+    uint64_t cumulative = 0;
+    for (const Demand& demand : demands) {
+        cumulative += demand.work;
+        // Admitted processes that are already late still take up cores but have nothing left to protect.
+        if (demand.deadline <= now) continue;
+        uint64_t window = demand.deadline - now;
+        if (demand.work > window || cumulative > window * static_cast<uint64_t>(std::max(1, cores))) {
+            candidate.deadline_rejected = true;
+            return false;
+        }
+    }
+    admitted_.push_back(index);
+    return true;
+}
+
+void ReadyQueue::boost() {
+    if (policy_ != ReadyPolicy::MLFQ) return;
+    // Running, blocked and sleeping processes come back at the top as well. The scan touches one
+    // byte per process in the table's dense priority array.
+    ProcessIndex count = static_cast<ProcessIndex>(g_process_table.size());
+    for (ProcessIndex index = 0; index < count; ++index) g_process_table.priority(index) = 0;
+    // Keep the queued processes in priority order: level 0 first, then each sunk level behind it.
+    for (int level = 1; level < mlfq_.levels; ++level) {
+        levels_[0].insert(levels_[0].end(), levels_[level].begin(), levels_[level].end());
+        levels_[level].clear();
+    }
+    nonempty_ = levels_[0].empty() ? 0 : 1;
+}
+
+void ReadyQueue::clear() {
+    for (auto& level : levels_) level.clear();
+    nonempty_ = 0;
+    size_ = 0;
+    heap_.clear();
+    tickets_.clear();
+    stride_pass_ = 0;
+    admitted_.clear();
+}
+
+void write_deadline_report(std::ostream& out, const std::vector<ProcessIndex>& finished) {
+    std::vector<int64_t> lateness;
+    size_t missed = 0, rejected = 0;
+    for (ProcessIndex index : finished) {
+        const Process& p = g_process_table[index];
+        if (p.deadline_tick == NOT_YET_TICK || p.finish_tick == NOT_YET_TICK) continue;
+        int64_t late = static_cast<int64_t>(p.finish_tick) - static_cast<int64_t>(p.deadline_tick);
+        lateness.push_back(late);
+        if (late > 0) missed++;
+        if (p.deadline_rejected) rejected++;
+    }
+    out << "Deadlines: " << lateness.size() << " finished processes had one";
+    if (lateness.empty()) {
+        out << "\n";
+        return;
+    }
+    out << ", " << missed << " missed (" << std::fixed << std::setprecision(1) << 100.0 * missed / lateness.size() << "%), "
+        << rejected << " rejected by EDF admission\n";
+
+    std::sort(lateness.begin(), lateness.end());
+    double mean = 0;
+    for (int64_t late : lateness) mean += static_cast<double>(late);
+    mean /= lateness.size();
+    auto quantile = [&](double q) { return lateness[static_cast<size_t>(q * (lateness.size() - 1))]; };
+    out << "Lateness (finish - deadline, CPU ticks): min " << lateness.front() << ", p50 " << quantile(0.50)
+        << ", p99 " << quantile(0.99) << ", max " << lateness.back() << ", mean " << mean << "\n";
+
+    // Power-of-two buckets of how late the misses were.
+    std::vector<size_t> buckets;
+    for (int64_t late : lateness) {
+        if (late <= 0) continue;
+        size_t bucket = static_cast<size_t>(std::bit_width(static_cast<uint64_t>(late)) - 1);
+        if (bucket >= buckets.size()) buckets.resize(bucket + 1, 0);
+        buckets[bucket]++;
+    }
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        if (buckets[bucket] == 0) continue;
+        out << "  late by [" << std::setw(10) << (uint64_t(1) << bucket) << ", " << std::setw(10) << (uint64_t(1) << (bucket + 1))
+            << ") ticks: " << buckets[bucket] << "\n";
+    }
+}
@@ -0,0 +1,152 @@
+#ifndef READY_QUEUE_H
+#define READY_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Process.h"
+#include "IndexedHeap.h"
+#include "TicketTree.h"
+#include "Workload.h"
+
+// Order in which the RR scheduler's cores take ready processes.
+enum class ReadyPolicy : uint8_t {
+    FIFO, // Round robin: one queue, quantum-cycles per dispatch
+    MLFQ, // Multi-level feedback queue, see below
+    SJF,  // Shortest job first: least remaining work first, runs until it finishes, blocks or sleeps
+    SRTF,    // Shortest remaining time first: SJF re-decided at the end of every quantum-cycles quantum
+    STRIDE,  // Proportional share: least CPU time per unit of weight first
+    LOTTERY, // Proportional share: a random draw weighted by each process's tickets
+    EDF      // Earliest deadline first, with admission control
+};
+
+// Maps a config.txt scheduler name ("rr", "mlfq", "sjf", "srtf", "stride", "lottery", "edf") to its policy. False for names the RR
+// scheduler does not run, e.g. "fcfs".
+bool parse_ready_policy(const std::string& name, ReadyPolicy& policy);
+
+// Per-level settings of the MLFQ policy, read from config.txt by mlfq_config_from_globals().
+struct MlfqConfig {
+    int levels = 1;
+    std::vector<int> quanta;  // Ticks per dispatch at each level, one entry per level
+    uint64_t boost_ticks = 0; // CPU ticks between priority boosts, 0 never boosts
+};
+
+// mlfq-levels levels; mlfq-quanta lists their quanta from the top level down, and levels it leaves
+// out double the level above, starting from quantum-cycles.
+MlfqConfig mlfq_config_from_globals();
+
+// --- Ready Queue ---
+// The RR scheduler's ready processes (process table indices), ordered by the configured policy.
+// Every policy files processes into up to MAX_LEVELS FIFO levels; a bitmap of the non-empty levels
+// makes pop_front() find the highest-priority level with one count-trailing-zeros. FIFO uses only
+// level 0.
+//
+// MLFQ: new processes enter level 0, the top. A process that uses up its quantum moves down one
+// level and a process that blocks on a page fault moves up one, so CPU-bound processes sink and
+// interactive ones stay near the top, where quanta are short. Every boost period boost() moves
+// every process back to the top so sunk processes cannot starve. The level is the process
+// table's priority field.
+//
+// SJF / SRTF: the levels are bypassed for an indexed min-heap keyed by remaining work, the compiled
+// program length minus the program counter, so a pick is O(log n) however many processes are ready.
+// FOR loops count once, so a loop-heavy program looks shorter than it runs. SRTF preempts at
+// quantum boundaries: a process whose quantum ends goes back into the heap, and a shorter arrival
+// takes the next free core.
+//
+// STRIDE / LOTTERY: each process asks for a share of the cores in proportion to its weight (screen -s
+// or default-weight). Stride keys the heap by the process's pass, which every tick it runs advances by
+// STRIDE_UNIT / weight, so the process furthest behind its share is always next; a process arriving
+// or waking starts at the pass of the last pick so it cannot claim the time it was away. Lottery
+// draws from a Fenwick tree of tickets instead, which gives the same shares in expectation. Both
+// picks are O(log n).
+//
+// EDF: the heap is keyed by absolute deadline; processes without one (or rejected by admit()) key
+// last and run in arrival order when no deadline is pending. A process whose quantum ends goes back
+// into the heap, so an earlier-deadline arrival preempts at the next quantum boundary.
+//
+// Not thread safe; the RR scheduler guards it with rr_g_process_mutex.
+class ReadyQueue {
+public:
+    static constexpr int MAX_LEVELS = 64;
+    static constexpr uint64_t STRIDE_UNIT = uint64_t(1) << 20; // Pass per tick at weight 1
+    static constexpr int MAX_WEIGHT = 10000; // Keeps STRIDE_UNIT / weight precise to 1%
+    static constexpr size_t AFFINITY_WINDOW = 8; // Processes pop_for_core() looks at
+
+    // Switches to policy. Processes already queued stay at the level they are on.
+    void set_policy(ReadyPolicy policy, const MlfqConfig& mlfq = MlfqConfig());
+    ReadyPolicy policy() const { return policy_; }
+
+    void push_back(ProcessIndex index);
+    // Removes and returns the next process to dispatch. The queue must not be empty.
+    ProcessIndex pop_front();
+    // Cache affinity: pop_front() for a free core. Under FIFO and MLFQ it looks at the first
+    // AFFINITY_WINDOW processes of the level pop_front() would take from and prefers one that last
+    // ran on core, then one that is no longer cache-hot on another core (left it migration_cost or
+    // more ticks before now), then the front. The other policies keep their own order.
+    ProcessIndex pop_for_core(int core, uint64_t now, uint64_t migration_cost);
+
+    // Ticks the process may run before it is preempted: quantum-cycles, or the adaptive quantum
+    // when adaptive-quantum is on, except under MLFQ and SJF.
+    int quantum(ProcessIndex index) const;
+    // Policy feedback from the cores as a process leaves one. They adjust its level (MLFQ) or charge
+    // the ticks of the dispatch to its pass (stride); the caller queues it.
+    void quantum_expired(ProcessIndex index);
+    void blocked(ProcessIndex index);
+    void slept(ProcessIndex index);
+    // EDF admission test for a new process with a deadline, at CPU tick now: sorted by deadline, the
+    // remaining work of every admitted process due by each deadline must fit on cores cores before
+    // it, and each process alone on one core. A process that fails is marked deadline_rejected and
+    // runs as best effort. Always true under other policies and for processes without a deadline.
+    bool admit(ProcessIndex index, uint64_t now, int cores);
+    // MLFQ: moves every process, queued or not, back to the top level. The caller decides when.
+    void boost();
+    uint64_t boost_ticks() const { return policy_ == ReadyPolicy::MLFQ ? mlfq_.boost_ticks : 0; }
+
+    // Calls fn(index) for every queued process: highest level first, then the heap in heap order, then
+    // the lottery.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& level : levels_) {
+            for (ProcessIndex index : level) fn(index);
+        }
+        heap_.for_each([&](ProcessIndex index, uint64_t) { fn(index); });
+        tickets_.for_each([&](ProcessIndex index, uint32_t) { fn(index); });
+    }
+
+    // Queued processes per level, for the scheduler display.
+    size_t level_size(int level) const { return levels_[level].size(); }
+    int level_count() const { return policy_ == ReadyPolicy::MLFQ ? mlfq_.levels : 1; }
+
+    bool empty() const { return nonempty_ == 0 && heap_.empty() && tickets_.empty(); }
+    size_t size() const { return size_ + heap_.size() + tickets_.size(); }
+    void clear();
+
+private:
+    int level_of(ProcessIndex index) const;
+    bool uses_heap() const {
+        return policy_ == ReadyPolicy::SJF || policy_ == ReadyPolicy::SRTF || policy_ == ReadyPolicy::STRIDE ||
+               policy_ == ReadyPolicy::EDF;
+    }
+    void charge(ProcessIndex index);
+
+    ReadyPolicy policy_ = ReadyPolicy::FIFO;
+    MlfqConfig mlfq_;
+    std::deque<ProcessIndex> levels_[MAX_LEVELS];
+    uint64_t nonempty_ = 0; // Bit L set while levels_[L] has processes
+    size_t size_ = 0;       // Processes on the levels
+    IndexedHeap heap_;      // SJF / SRTF / stride
+    TicketTree tickets_;    // Lottery
+    WorkloadEngine lottery_rng_{1};
+    uint64_t stride_pass_ = 0; // Pass of the last stride pick
+    std::vector<ProcessIndex> admitted_; // EDF: processes that passed admit(), pruned as they finish
+};
+
+// --- Deadlines ---
+// Deadline outcomes of the finished processes that had a deadline, under any scheduler: misses,
+// admission rejections and the lateness (finish tick - deadline tick) distribution. For report-util.
+void write_deadline_report(std::ostream& out, const std::vector<ProcessIndex>& finished);
+
+#endif // READY_QUEUE_H
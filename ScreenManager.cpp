@@ -24,8 +24,10 @@ void ScreenManager::createScreen(const std::string& name) {
 }
 
 // Switch to existing screen 
-void ScreenManager::attachScreen(const std::string& name) {
+void ScreenManager::attachScreen(const std::string& name, size_t lines) {
     if (screenExists(name)) {
+        detachScreen();
+
         HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE); 
         COORD topLeft = {0, 0}; 
         CONSOLE_SCREEN_BUFFER_INFO csbi; 
@@ -35,8 +37,8 @@ void ScreenManager::attachScreen(const std::string& name) {
         SetConsoleCursorPosition(hConsole, topLeft);
 
         activeScreen = screens[name]; 
-        activeScreen->display(); 
-        // activeScreen->run(); // Start screen's thread
+        activeScreen->display(lines); 
+        activeScreen->run(); // Tail the process's output
     } else {
         std::cerr << "Error : Screen '" << name << "' not found!" << std::endl;  
     }
@@ -45,7 +47,7 @@ void ScreenManager::attachScreen(const std::string& name) {
 // Detatch current screen 
 void ScreenManager::detachScreen() {
     if (activeScreen) {
-        // activeScreen-> stop(); 
+        activeScreen->stop(); 
         activeScreen = nullptr;
     }
 }
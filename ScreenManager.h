@@ -18,7 +18,7 @@ public:
     static std::shared_ptr<ScreenManager> getInstance(); 
 
     void createScreen(const std::string& name); 
-    void attachScreen(const std::string& name); 
+    void attachScreen(const std::string& name, size_t lines = SCREEN_DEFAULT_LINES); 
     void detachScreen(); 
     bool screenExists(const std::string& name) const; 
     bool screenActive() const;
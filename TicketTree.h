@@ -0,0 +1,110 @@
+#ifndef TICKET_TREE_H
+#define TICKET_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Process.h"
+
+// Lottery draw over process table indices, each holding some tickets. A Fenwick tree over ticket
+// counts makes adding a process and drawing (and removing) the winner O(log n). Slots freed by
+// winners are reused, so the tree only grows to the most processes held at once. Not thread safe.
+class TicketTree {
+public:
+    void add(ProcessIndex index, uint32_t tickets) {
+        if (free_slots_.empty()) grow();
+        size_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        owners_[slot] = index;
+        tickets_[slot] = tickets;
+        adjust(slot, static_cast<int64_t>(tickets));
+        total_ += tickets;
+        count_++;
+    }
+
+    // Draws a winner with probability proportional to its tickets and removes it. A holder with no
+    // tickets is only drawn once every holder has none. The tree must not be empty.
+    template <typename Engine>
+    ProcessIndex draw(Engine& engine) {
+        size_t slot;
+        if (total_ == 0) {
+            slot = 0;
+            while (owners_[slot] == NO_PROCESS) slot++;
+        } else {
+            slot = find(engine() % total_);
+        }
+        ProcessIndex index = owners_[slot];
+        adjust(slot, -static_cast<int64_t>(tickets_[slot]));
+        total_ -= tickets_[slot];
+        owners_[slot] = NO_PROCESS;
+        tickets_[slot] = 0;
+        free_slots_.push_back(slot);
+        count_--;
+        return index;
+    }
+
+    // Calls fn(index, tickets) for every holder, in slot order.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (size_t slot = 0; slot < owners_.size(); ++slot) {
+            if (owners_[slot] != NO_PROCESS) fn(owners_[slot], tickets_[slot]);
+        }
+    }
+
+    uint64_t total_tickets() const { return total_; }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    void clear() {
+        owners_.clear();
+        tickets_.clear();
+        tree_.clear();
+        free_slots_.clear();
+        total_ = 0;
+        count_ = 0;
+    }
+
+private:
+    // Fenwick tree over slots: tree_[i] (1-based) sums the tickets of the slots (i - lowbit(i), i].
+    void adjust(size_t slot, int64_t delta) {
+        for (size_t i = slot + 1; i < tree_.size(); i += i & (~i + 1)) tree_[i] += static_cast<uint64_t>(delta);
+    }
+
+    // Slot holding ticket number target (0-based), by descending the tree from its largest power of two.
+    size_t find(uint64_t target) const {
+        size_t position = 0;
+        for (size_t step = (tree_.size() - 1); step > 0; step >>= 1) {
+            size_t next = position + step;
+            if (next < tree_.size() && tree_[next] <= target) {
+                position = next;
+                target -= tree_[next];
+            }
+        }
+        return position; // Last 1-based position whose prefix sum is <= target, i.e. the winner's slot
+    }
+
+    // Doubles the slot count and rebuilds the tree in O(n). The capacity stays a power of two so find()
+    // can descend by halving steps.
+    void grow() {
+        size_t old_capacity = owners_.size();
+        size_t capacity = old_capacity == 0 ? 64 : old_capacity * 2;
+        owners_.resize(capacity, NO_PROCESS);
+        tickets_.resize(capacity, 0);
+        tree_.assign(capacity + 1, 0);
+        for (size_t slot = 0; slot < capacity; ++slot) {
+            size_t i = slot + 1;
+            tree_[i] += tickets_[slot];
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= capacity) tree_[parent] += tree_[i];
+        }
+        for (size_t slot = capacity; slot-- > old_capacity;) free_slots_.push_back(slot);
+    }
+
+    std::vector<ProcessIndex> owners_;  // Slot -> holder, NO_PROCESS when free
+    std::vector<uint32_t> tickets_;     // Slot -> tickets
+    std::vector<uint64_t> tree_;        // Fenwick tree, size capacity + 1
+    std::vector<size_t> free_slots_;    // Lowest slot last
+    uint64_t total_ = 0;
+    size_t count_ = 0;
+};
+
+#endif // TICKET_TREE_H
@@ -0,0 +1,87 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+
+// Ticks covered by one slot of the given level.
+constexpr uint64_t slot_width(int level) { return uint64_t(1) << (TimerWheel::SLOT_BITS * level); }
+} // end anonymous namespace
+
+void TimerWheel::schedule(ProcessIndex process, uint64_t wake_tick) {
+    // The current tick's slot has already been expired, so the earliest wake-up is the next tick.
+    wake_tick = std::max(wake_tick, now_ + 1);
+    next_event_ = std::min(next_event_, wake_tick);
+    place({process, wake_tick});
+    size_++;
+}
+
+void TimerWheel::place(Timer timer) {
+    // Lowest level whose 256 slots reach the wake tick. Cascading re-files timers due this very
+    // tick, which land in the current level-0 slot right before it is expired.
+    uint64_t delta = timer.wake_tick - now_;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= slot_width(level + 1)) level++;
+    // Beyond the top level's range the timer waits in its farthest slot and is re-filed from there.
+    uint64_t key = delta >= slot_width(LEVELS) ? now_ + slot_width(LEVELS) - 1 : timer.wake_tick;
+    slots_[level][(key >> (SLOT_BITS * level)) & SLOT_MASK].push_back(std::move(timer));
+}
+
+void TimerWheel::cascade(int level) {
+    auto& slot = slots_[level][(now_ >> (SLOT_BITS * level)) & SLOT_MASK];
+    if (slot.empty()) return;
+    scratch_.swap(slot);
+    for (auto& timer : scratch_) place(std::move(timer));
+    scratch_.clear();
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<ProcessIndex>& woken) {
+    while (now_ < now && size_ > 0) {
+        ++now_;
+        // When a level wraps, the next slot of the level above moves down; lower levels first.
+        for (int level = 1; level < LEVELS && (now_ & (slot_width(level) - 1)) == 0; ++level) {
+            cascade(level);
+        }
+        auto& due = slots_[0][now_ & SLOT_MASK];
+        for (const auto& timer : due) woken.push_back(timer.process);
+        size_ -= due.size();
+        due.clear();
+    }
+    // Nothing left to expire: the clock jumps straight to now.
+    now_ = std::max(now_, now);
+    next_event_ = size_ > 0 ? now_ + ticks_to_next_event() : std::numeric_limits<uint64_t>::max();
+}
+
+uint64_t TimerWheel::ticks_to_next_event() const {
+    if (size_ == 0) return 0;
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    // Level 0 holds every timer due within the next 256 ticks.
+    for (uint64_t delta = 1; delta < SLOTS; ++delta) {
+        if (!slots_[0][(now_ + delta) & SLOT_MASK].empty()) {
+            best = delta;
+            break;
+        }
+    }
+    // A higher slot cascades at the start of its block and may hold earlier timers than level 0.
+    for (int level = 1; level < LEVELS; ++level) {
+        uint64_t width = slot_width(level);
+        uint64_t boundary = (now_ / width + 1) * width;
+        for (int i = 0; i < SLOTS && boundary - now_ < best; ++i, boundary += width) {
+            if (!slots_[level][(boundary >> (SLOT_BITS * level)) & SLOT_MASK].empty()) {
+                best = boundary - now_;
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+void TimerWheel::clear() {
+    for (auto& level : slots_) {
+        for (auto& slot : level) slot.clear();
+    }
+    size_ = 0;
+    next_event_ = std::numeric_limits<uint64_t>::max();
+}
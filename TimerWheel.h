@@ -0,0 +1,68 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "Process.h"
+
+// Hierarchical timing wheel of sleeping processes (process table indices) keyed by CPU clock tick (get_cpu_clock_ticks()).
+// Level L has 256 slots of 256^L ticks each, so four levels cover 2^32 ticks ahead. A process is
+// filed in the lowest level whose range reaches its wake tick and is moved down one level each time
+// the level below wraps around to its slot. Advancing the clock by one tick expires one level-0
+// slot and, once every 256 ticks, re-files one higher slot: O(1) per tick regardless of how many
+// processes sleep. Not thread safe; each scheduler guards its wheel with its process mutex.
+class TimerWheel {
+public:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    // Parks process until wake_tick; ticks already passed wake it on the next advance().
+    void schedule(ProcessIndex process, uint64_t wake_tick);
+
+    // Moves the wheel's clock forward to now, appending every process whose wake tick has been
+    // reached to woken in wake order.
+    void advance(uint64_t now, std::vector<ProcessIndex>& woken);
+
+    // Ticks from the wheel's clock to the next tick that has work: an expiry, or a cascade that may
+    // bring one closer. 0 if the wheel is empty. Used to skip idle time when every core is idle.
+    uint64_t ticks_to_next_event() const;
+
+    // No later than the first wake-up; advance() to any tick before it wakes nobody. Cheap enough to
+    // test in a scheduler's wait predicate.
+    uint64_t next_event_tick() const { return next_event_; }
+
+    // Calls fn(process, wake_tick) for every parked process, in no particular order.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& level : slots_) {
+            for (const auto& slot : level) {
+                for (const auto& timer : slot) fn(timer.process, timer.wake_tick);
+            }
+        }
+    }
+
+    uint64_t now() const { return now_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+
+private:
+    struct Timer {
+        ProcessIndex process;
+        uint64_t wake_tick;
+    };
+
+    void place(Timer timer);
+    void cascade(int level);
+
+    std::vector<Timer> slots_[LEVELS][SLOTS];
+    std::vector<Timer> scratch_; // Slot being re-filed by cascade(), kept for its capacity
+    uint64_t now_ = 0;
+    uint64_t next_event_ = std::numeric_limits<uint64_t>::max();
+    size_t size_ = 0;
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+#include "Workload.h"
+#include "Interpreter.h"
+#include "config.h"
+#include "global.h"
+#include "vmstat.h"
+
+// --- File-local helpers ---
+namespace {
+
+const char* const MIX_NAMES[] = {"print", "declare", "add", "subtract", "sleep", "read", "write", "for"};
+static_assert(sizeof(MIX_NAMES) / sizeof(MIX_NAMES[0]) == static_cast<size_t>(MixKind::COUNT));
+
+// At most this many arrivals are queued per wake-up so the scheduler lock is held briefly;
+// any backlog arrives on the following wake-ups.
+const size_t MAX_ARRIVALS_PER_BATCH = 1024;
+const auto GENERATOR_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+const int MAX_FOR_BODY = 3;
+const int MAX_FOR_REPEATS = 4;
+const int MAX_SLEEP_TICKS = 4;
+const int MAX_IMMEDIATE = 1000;
+
+InstructionMix default_mix() {
+    InstructionMix mix;
+    mix.fill(1);
+    return mix;
+}
+
+} // end anonymous namespace
+
+bool parse_arrival_model(const std::string& text, ArrivalModel& model) {
+    if (text == "fixed") model = ArrivalModel::FIXED;
+    else if (text == "poisson") model = ArrivalModel::POISSON;
+    else if (text == "bursty") model = ArrivalModel::BURSTY;
+    else return false;
+    return true;
+}
+
+bool parse_instruction_mix(const std::string& text, InstructionMix& mix) {
+    InstructionMix parsed{};
+    std::istringstream iss(text);
+    std::string entry;
+    while (iss >> entry) {
+        size_t equals = entry.find('=');
+        if (equals == std::string::npos) return false;
+        std::string name = entry.substr(0, equals);
+        auto it = std::find_if(std::begin(MIX_NAMES), std::end(MIX_NAMES), [&](const char* n) { return name == n; });
+        if (it == std::end(MIX_NAMES)) return false;
+        try {
+            parsed[it - std::begin(MIX_NAMES)] = static_cast<uint32_t>(std::stoul(entry.substr(equals + 1)));
+        } catch (...) {
+            return false;
+        }
+    }
+    mix = parsed;
+    return true;
+}
+
+WorkloadConfig workload_config_from_globals() {
+    WorkloadConfig config;
+    config.seed = WORKLOAD_SEED;
+    config.min_ins = std::max(1, MIN_INS);
+    config.max_ins = std::max(config.min_ins, MAX_INS);
+    config.min_mem = static_cast<size_t>(std::max(MIN_MEM_PER_PROC, 2));
+    config.max_mem = std::max(config.min_mem, static_cast<size_t>(std::max(MAX_MEM_PER_PROC, 0)));
+    if (!parse_arrival_model(ARRIVAL_MODEL, config.arrival_model)) config.arrival_model = ArrivalModel::FIXED;
+    config.mean_gap_ticks = std::max(1, processFrequency);
+    config.burst_size = std::max(1, BURST_SIZE);
+    if (!parse_instruction_mix(INSTRUCTION_MIX, config.mix) ||
+        std::all_of(config.mix.begin(), config.mix.end(), [](uint32_t w) { return w == 0; })) {
+        config.mix = default_mix();
+    }
+    return config;
+}
+
+// --- WorkloadEngine ---
+WorkloadEngine::WorkloadEngine(uint64_t seed) {
+    // Expand the seed with splitmix64 so that similar seeds give unrelated streams.
+    for (auto& word : state_) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+// --- WorkloadGenerator ---
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config)
+    : config_(config),
+      seed_(config.seed != 0 ? config.seed : (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}()),
+      engine_(seed_) {
+    if (std::all_of(config_.mix.begin(), config_.mix.end(), [](uint32_t w) { return w == 0; })) {
+        config_.mix = default_mix();
+    }
+    uint64_t total = 0;
+    for (size_t i = 0; i < config_.mix.size(); ++i) {
+        total += config_.mix[i];
+        cumulative_mix_[i] = total;
+    }
+
+    // Powers of two in [min_mem, max_mem]; a range without one falls back to min_mem.
+    for (size_t size = 1; size <= config_.max_mem && size != 0; size <<= 1) {
+        if (size >= config_.min_mem) memory_sizes_.push_back(size);
+    }
+    if (memory_sizes_.empty()) memory_sizes_.push_back(config_.min_mem);
+}
+
+GeneratedProcess WorkloadGenerator::next() {
+    GeneratedProcess process;
+    process.memory_size = generate_memory_size();
+    process.program = generate_program(process.memory_size);
+    process.arrival_gap = generate_arrival_gap();
+    return process;
+}
+
+MixKind WorkloadGenerator::pick_kind(bool allow_for) {
+    const size_t for_index = static_cast<size_t>(MixKind::FOR);
+    uint64_t total = allow_for ? cumulative_mix_.back() : cumulative_mix_[for_index - 1];
+    if (total == 0) return MixKind::DECLARE; // The mix only allows FOR
+    uint64_t roll = total <= static_cast<uint64_t>(INT_MAX) + 1 ? static_cast<uint64_t>(draw(0, static_cast<int>(total - 1))) : std::uniform_int_distribution<uint64_t>(0, total - 1)(engine_);
+    size_t kind = std::upper_bound(cumulative_mix_.begin(), cumulative_mix_.end(), roll) - cumulative_mix_.begin();
+    return static_cast<MixKind>(kind);
+}
+
+// A draw in [lo, hi] from the top 32 bits of one engine output by multiply-shift, without the
+// division and retry loop of std::uniform_int_distribution that dominated generation time. The bias
+// is below (hi - lo + 1) / 2^32, far under anything a workload mix can show.
+int WorkloadGenerator::draw(int lo, int hi) {
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+    return lo + static_cast<int>(((engine_() >> 32) * range) >> 32);
+}
+
+// Slots are handed out in order of first use, in the operand order compile_program uses, so the
+// disassembled source recompiles to exactly this code.
+int WorkloadGenerator::variable_slot(int variable, ProgramImage& image) {
+    // The names are built once rather than per program.
+    static const std::array<std::string, GENERATED_VARIABLES> names = [] {
+        std::array<std::string, GENERATED_VARIABLES> built;
+        for (int i = 0; i < GENERATED_VARIABLES; ++i) built[i] = "v" + std::to_string(i);
+        return built;
+    }();
+    if (variable_slots_[variable] < 0) {
+        variable_slots_[variable] = static_cast<int>(image.variable_names.size());
+        image.variable_names.push_back(names[variable]);
+    }
+    return variable_slots_[variable];
+}
+
+void WorkloadGenerator::emit_instruction(MixKind kind, size_t memory_size, ProgramImage& image) {
+    auto variable = [&](Operand& operand) {
+        operand.is_variable = true;
+        operand.slot = variable_slot(draw(0, GENERATED_VARIABLES - 1), image);
+    };
+    auto value = [&](Operand& operand) {
+        if (draw(0, 1)) variable(operand);
+        else operand.value = static_cast<uint16_t>(draw(0, MAX_IMMEDIATE));
+    };
+    // Keep data accesses out of the symbol table when the process has room beyond it.
+    auto address = [&]() {
+        size_t low = memory_size > SYMBOL_TABLE_BYTES + 1 ? SYMBOL_TABLE_BYTES : 0;
+        size_t high = memory_size >= 2 ? memory_size - 2 : 0;
+        return draw(static_cast<int>(low), static_cast<int>(std::max(low, high))) & ~1;
+    };
+
+    Instruction ins;
+    switch (kind) {
+        case MixKind::PRINT:
+            ins.op = Opcode::PRINT;
+            if (draw(0, 1)) {
+                // Every PRINT of a variable says the same, so the program keeps one message per variable.
+                int variable = draw(0, GENERATED_VARIABLES - 1);
+                int slot = variable_slot(variable, image);
+                if (variable_messages_[variable] < 0) {
+                    variable_messages_[variable] = static_cast<int>(image.messages.size());
+                    auto& parts = image.messages.emplace_back(2);
+                    parts[0].text = "Value from: ";
+                    parts[1].is_variable = true;
+                    parts[1].slot = slot;
+                }
+                ins.message = variable_messages_[variable];
+            }
+            break;
+        case MixKind::DECLARE:
+            ins.op = Opcode::DECLARE;
+            variable(ins.dst);
+            ins.lhs.value = static_cast<uint16_t>(draw(0, MAX_IMMEDIATE));
+            break;
+        case MixKind::ADD:
+        case MixKind::SUBTRACT:
+            ins.op = kind == MixKind::ADD ? Opcode::ADD : Opcode::SUBTRACT;
+            variable(ins.dst);
+            value(ins.lhs);
+            value(ins.rhs);
+            break;
+        case MixKind::SLEEP:
+            ins.op = Opcode::SLEEP;
+            ins.lhs.value = static_cast<uint16_t>(draw(1, MAX_SLEEP_TICKS));
+            break;
+        case MixKind::READ:
+            ins.op = Opcode::READ;
+            variable(ins.dst);
+            ins.address = address();
+            break;
+        case MixKind::WRITE:
+            ins.op = Opcode::WRITE;
+            ins.address = address();
+            value(ins.lhs);
+            break;
+        default:
+            return;
+    }
+    image.code.push_back(ins);
+}
+
+// Builds the compiled program directly; compiling generated text costs several times more than
+// generating it. The image has no source text, program_source() disassembles it on demand.
+std::shared_ptr<const ProgramImage> WorkloadGenerator::generate_program(size_t memory_size) {
+    auto image = std::make_shared<ProgramImage>();
+    variable_slots_.fill(-1);
+    variable_messages_.fill(-1);
+    int remaining = draw(config_.min_ins, config_.max_ins);
+    image->code.reserve(remaining);
+    image->variable_names.reserve(GENERATED_VARIABLES);
+    while (remaining > 0) {
+        MixKind kind = pick_kind(remaining >= 2);
+        if (kind != MixKind::FOR) {
+            emit_instruction(kind, memory_size, *image);
+            remaining--;
+            continue;
+        }
+        // A FOR counts as its body times its repeats, so the program still runs the drawn count.
+        int body_size = draw(1, std::min(MAX_FOR_BODY, remaining / 2));
+        int repeats = draw(2, std::min(MAX_FOR_REPEATS, remaining / body_size));
+        int begin_pc = static_cast<int>(image->code.size());
+        Instruction begin;
+        begin.op = Opcode::FOR_BEGIN;
+        begin.lhs.value = static_cast<uint16_t>(repeats);
+        image->code.push_back(begin);
+        for (int i = 0; i < body_size; ++i) emit_instruction(pick_kind(false), memory_size, *image);
+        Instruction end;
+        end.op = Opcode::FOR_END;
+        end.jump = begin_pc + 1;
+        image->code.push_back(end);
+        image->code[begin_pc].jump = static_cast<int>(image->code.size());
+        remaining -= body_size * repeats;
+    }
+    if (config_.optimize && optimizer_keeps_ticks()) optimize_program(*image);
+    return image;
+}
+
+size_t WorkloadGenerator::generate_memory_size() {
+    return memory_sizes_[draw(0, static_cast<int>(memory_sizes_.size()) - 1)];
+}
+
+uint64_t WorkloadGenerator::generate_arrival_gap() {
+    double mean = std::max(config_.mean_gap_ticks, 1e-9);
+    switch (config_.arrival_model) {
+        case ArrivalModel::FIXED:
+            return static_cast<uint64_t>(std::llround(mean));
+        case ArrivalModel::BURSTY:
+            if (burst_remaining_ > 0) {
+                burst_remaining_--;
+                return 0;
+            }
+            burst_remaining_ = config_.burst_size - 1;
+            mean *= config_.burst_size;
+            [[fallthrough]];
+        case ArrivalModel::POISSON: {
+            // Arrival times are continuous; gaps are the whole ticks between consecutive arrivals.
+            arrival_clock_ += std::exponential_distribution<double>(1.0 / mean)(engine_);
+            uint64_t tick = static_cast<uint64_t>(arrival_clock_);
+            uint64_t gap = tick - last_arrival_tick_;
+            last_arrival_tick_ = tick;
+            return gap;
+        }
+        default:
+            return static_cast<uint64_t>(mean);
+    }
+}
+
+// --- Generator Thread ---
+void run_workload_generator(std::mutex& process_mutex, std::condition_variable& scheduler_cv, const std::string& name_prefix) {
+    WorkloadGenerator generator(workload_config_from_globals());
+    GeneratedProcess next = generator.next();
+    uint64_t next_arrival = static_cast<uint64_t>(get_total_cpu_ticks()) + next.arrival_gap;
+    std::vector<GeneratedProcess> arrivals;
+
+    while (process_maker_running) {
+        // Programs are generated outside the lock; only the queue push holds it.
+        uint64_t now = static_cast<uint64_t>(get_total_cpu_ticks());
+        while (next_arrival <= now && arrivals.size() < MAX_ARRIVALS_PER_BATCH) {
+            arrivals.push_back(std::move(next));
+            next = generator.next();
+            next_arrival += next.arrival_gap;
+        }
+        if (!arrivals.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(process_mutex);
+                for (auto& arrival : arrivals) {
+                    g_creation_queue.push_back({name_prefix + std::to_string(cpuClocks++), arrival.memory_size, std::move(arrival.program)});
+                }
+            }
+            arrivals.clear();
+            scheduler_cv.notify_one();
+        }
+        std::this_thread::sleep_for(GENERATOR_POLL_INTERVAL);
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "Instruction.h"
+
+// --- Randomized Workload Generator ---
+// Produces the programs, memory sizes and arrival times of scheduler-start processes. All draws come
+// from one seeded engine, so a fixed workload-seed replays the same workload.
+
+enum class ArrivalModel {
+    FIXED,   // One process every batch-process-freq CPU ticks
+    POISSON, // Exponential gaps averaging batch-process-freq ticks
+    BURSTY   // burst-size processes at once; bursts are Poisson with the same mean process rate
+};
+
+// Statement kinds a generated program draws from, weighted by instruction-mix.
+enum class MixKind { PRINT, DECLARE, ADD, SUBTRACT, SLEEP, READ, WRITE, FOR, COUNT };
+using InstructionMix = std::array<uint32_t, static_cast<size_t>(MixKind::COUNT)>;
+
+struct WorkloadConfig {
+    uint64_t seed = 0;               // 0 draws a seed from std::random_device
+    int min_ins = 1;                 // Executed instructions per program, FOR bodies counted per repeat
+    int max_ins = 1;
+    size_t min_mem = 64;             // Memory sizes are powers of two in [min_mem, max_mem]
+    size_t max_mem = 64;
+    ArrivalModel arrival_model = ArrivalModel::FIXED;
+    double mean_gap_ticks = 1;       // Mean CPU ticks between arrivals
+    int burst_size = 1;
+    InstructionMix mix{};
+    // Run optimize_program on each generated image. Off by default: a generated image runs once, and
+    // optimizing it costs more host time than it saves (see benchmark optimizer). Ignored while
+    // optimizer_keeps_ticks() is false.
+    bool optimize = false;
+};
+
+// Parses "fixed", "poisson" or "bursty".
+bool parse_arrival_model(const std::string& text, ArrivalModel& model);
+// Parses "print=1 add=4 ..."; kinds that are not listed get weight 0.
+bool parse_instruction_mix(const std::string& text, InstructionMix& mix);
+// Workload settings from the config.txt globals; invalid values fall back to the defaults.
+WorkloadConfig workload_config_from_globals();
+
+// xoshiro256**: a fraction of the per-draw cost of std::mt19937_64, which dominated generation time,
+// and plenty random for workload mixes.
+class WorkloadEngine {
+public:
+    using result_type = uint64_t;
+    explicit WorkloadEngine(uint64_t seed);
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+    // Inline: the generator draws several times per instruction.
+    result_type operator()() {
+        auto rotl = [](uint64_t x, int k) { return (x << k) | (x >> (64 - k)); };
+        uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+private:
+    uint64_t state_[4];
+};
+
+struct GeneratedProcess {
+    std::shared_ptr<const ProgramImage> program;
+    size_t memory_size = 0;
+    uint64_t arrival_gap = 0; // CPU ticks after the previous arrival; 0 arrives in the same tick
+};
+
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(const WorkloadConfig& config);
+
+    GeneratedProcess next();
+    uint64_t seed() const { return seed_; }
+
+private:
+    // Generated programs share a small variable pool so that arithmetic mostly reuses declared values.
+    static constexpr int GENERATED_VARIABLES = 8;
+
+    int draw(int lo, int hi);
+    int variable_slot(int variable, ProgramImage& image);
+    void emit_instruction(MixKind kind, size_t memory_size, ProgramImage& image);
+    MixKind pick_kind(bool allow_for);
+    std::shared_ptr<const ProgramImage> generate_program(size_t memory_size);
+    size_t generate_memory_size();
+    uint64_t generate_arrival_gap();
+
+    WorkloadConfig config_;
+    uint64_t seed_;
+    WorkloadEngine engine_;
+    std::array<uint64_t, static_cast<size_t>(MixKind::COUNT)> cumulative_mix_{};
+    std::vector<size_t> memory_sizes_;
+    std::array<int, GENERATED_VARIABLES> variable_slots_{}; // Generated variable -> slot in the program being built
+    std::array<int, GENERATED_VARIABLES> variable_messages_{}; // Generated variable -> its PRINT message, likewise
+    double arrival_clock_ = 0;    // Fractional arrival time for the Poisson models
+    uint64_t last_arrival_tick_ = 0;
+    int burst_remaining_ = 0;
+};
+
+// Body of the scheduler-start generator thread. Generates processes from the config.txt settings and
+// queues each one in g_creation_queue once the CPU tick count reaches its arrival time, until
+// process_maker_running is cleared.
+void run_workload_generator(std::mutex& process_mutex, std::condition_variable& scheduler_cv, const std::string& name_prefix);
+
+#endif // WORKLOAD_H
@@ -1,9 +1,10 @@
 #ifndef configs
 #define configs
 
+#include <atomic>
 #include <string>
 
-extern int CPU_COUNT;
+extern std::atomic<int> CPU_COUNT; // Read by the cores, vmstat and process-smi while cpu-set changes it
 extern std::string scheduler;
 extern int qCycles;
 extern int processFrequency;
@@ -15,6 +16,35 @@ extern int MAX_OVERALL_MEM;
 extern int MEM_PER_FRAME;
 extern int MIN_MEM_PER_PROC;
 extern int MAX_MEM_PER_PROC;
+extern int HUGE_PAGE_FRAMES;
+extern std::string ARRIVAL_MODEL;
+extern int BURST_SIZE;
+extern unsigned long long WORKLOAD_SEED;
+extern std::string INSTRUCTION_MIX;
+extern int MLFQ_LEVELS;
+extern std::string MLFQ_QUANTA;
+extern int MLFQ_BOOST_TICKS;
+extern int DEFAULT_WEIGHT;
+extern int ADAPTIVE_QUANTUM;
+extern int QUANTUM_MIN;
+extern int QUANTUM_MAX;
+extern int TARGET_RESPONSE_TICKS;
+extern int TARGET_SWITCH_OVERHEAD;
+extern int CORE_CACHE;
+extern int CACHE_SETS;
+extern int CACHE_WAYS;
+extern int CACHE_LINE_BYTES;
+extern int CACHE_MISS_PENALTY;
+extern int CACHE_AFFINITY;
+extern int MIGRATION_COST;
+extern int NUMA_NODES;
+extern std::string NUMA_NODE_CORES;
+extern std::string NUMA_NODE_FRAMES;
+extern std::string NUMA_PLACEMENT;
+extern int NUMA_REMOTE_PENALTY;
+extern int NUMA_MIGRATE;
+extern std::string CORE_THREADS;
+extern int HOST_THREADS;
 
 extern int FRAME_COUNT;
 
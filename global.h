@@ -13,41 +13,59 @@
 // Forward declare complex types to avoid including full headers
 #include "Process.h"
 #include "MemoryManager.h"
+#include "TimerWheel.h"
+#include "ProcessTable.h"
+#include "ReadyQueue.h"
+#include "QuantumTuner.h"
+#include "CoreCache.h"
 
 // --- EXTERN DECLARATIONS FOR ALL GLOBALS ---
 
 // Memory Manager
 extern MemoryManager* memory_manager;
 
+// Every PCB; the scheduler lists below hold indices into it
+extern ProcessTable g_process_table;
+
 // Creation Queue
 struct ProcessCreationRequest {
     std::string name;
     size_t memory_size;
+    std::shared_ptr<const ProgramImage> program; // Null runs the scheduler's fixed workload
+    uint32_t weight = 0; // Share for the stride and lottery policies, 0 takes default-weight
+    uint64_t deadline = 0; // CPU ticks after arrival the process must finish within, 0 for none
 };
 extern std::deque<ProcessCreationRequest> g_creation_queue;
 extern std::atomic<bool> g_system_initialized;
 extern std::mutex g_cout_mutex;
 
+// Simulated per-core caches, used by whichever scheduler runs
+extern CoreCaches g_core_caches;
+
 // RR Scheduler Globals
-extern std::deque<std::shared_ptr<Process>> rr_g_ready_queue;
-extern std::vector<std::shared_ptr<Process>> rr_g_running_processes;
-extern std::vector<std::shared_ptr<Process>> rr_g_finished_processes;
-extern std::deque<std::shared_ptr<Process>> rr_g_blocked_queue;
+extern ReadyQueue rr_g_ready_queue; // Ordered by the policy named by scheduler
+extern QuantumTuner rr_g_quantum_tuner; // quantum-cycles when adaptive-quantum is on
+extern std::vector<ProcessIndex> rr_g_running_processes; // NO_PROCESS for an idle core
+extern std::vector<ProcessIndex> rr_g_finished_processes;
+extern std::deque<ProcessIndex> rr_g_blocked_queue;
+extern std::deque<ProcessIndex> rr_g_fault_queue; // core-threads "coroutine": BLOCKED, waiting for the pager
+extern TimerWheel rr_g_sleep_wheel; // SLEEPING processes
 extern std::mutex rr_g_process_mutex;
 extern std::condition_variable rr_g_scheduler_cv;
 extern std::atomic<bool> rr_g_is_running;
 
 // FCFS Scheduler Globals
-extern std::deque<std::shared_ptr<Process>> fcfs_g_ready_queue;
-extern std::vector<std::shared_ptr<Process>> fcfs_g_running_processes;
-extern std::vector<std::shared_ptr<Process>> fcfs_g_finished_processes;
-extern std::deque<std::shared_ptr<Process>> fcfs_g_blocked_queue;
+extern std::deque<ProcessIndex> fcfs_g_ready_queue;
+extern std::vector<ProcessIndex> fcfs_g_running_processes; // NO_PROCESS for an idle core
+extern std::vector<ProcessIndex> fcfs_g_finished_processes;
+extern std::deque<ProcessIndex> fcfs_g_blocked_queue;
+extern TimerWheel fcfs_g_sleep_wheel; // SLEEPING processes
 extern std::mutex fcfs_g_process_mutex;
 extern std::condition_variable fcfs_g_scheduler_cv;
 extern std::atomic<bool> fcfs_g_is_running;
 
 // Other global variables
-extern int CPU_COUNT;
+extern std::atomic<int> CPU_COUNT;
 extern bool process_maker_running;
 extern int cpuClocks;
 extern std::string scheduler;
@@ -60,6 +78,35 @@ extern int MAX_OVERALL_MEM;
 extern int MEM_PER_FRAME;
 extern int MIN_MEM_PER_PROC;
 extern int MAX_MEM_PER_PROC;
+extern int HUGE_PAGE_FRAMES;
+extern std::string ARRIVAL_MODEL;
+extern int BURST_SIZE;
+extern unsigned long long WORKLOAD_SEED;
+extern std::string INSTRUCTION_MIX;
+extern int MLFQ_LEVELS;
+extern std::string MLFQ_QUANTA;
+extern int MLFQ_BOOST_TICKS;
+extern int DEFAULT_WEIGHT;
+extern int ADAPTIVE_QUANTUM;
+extern int QUANTUM_MIN;
+extern int QUANTUM_MAX;
+extern int TARGET_RESPONSE_TICKS;
+extern int TARGET_SWITCH_OVERHEAD;
+extern int CORE_CACHE;
+extern int CACHE_SETS;
+extern int CACHE_WAYS;
+extern int CACHE_LINE_BYTES;
+extern int CACHE_MISS_PENALTY;
+extern int CACHE_AFFINITY;
+extern int MIGRATION_COST;
+extern int NUMA_NODES;
+extern std::string NUMA_NODE_CORES;
+extern std::string NUMA_NODE_FRAMES;
+extern std::string NUMA_PLACEMENT;
+extern int NUMA_REMOTE_PENALTY;
+extern int NUMA_MIGRATE;
+extern std::string CORE_THREADS;
+extern int HOST_THREADS;
 extern unsigned short variable_a;
 extern unsigned short variable_b;
 extern unsigned short variable_c;
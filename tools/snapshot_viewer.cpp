@@ -0,0 +1,124 @@
+/**
+ * Offline viewer for the memory snapshot stream written by the emulator.
+ * Reconstructs any snapshot from the frame deltas and renders it in the
+ * same layout the old memory_stamp_N.txt files used.
+ *
+ * Usage: snapshot_viewer [file]            list the snapshots in the stream
+ *        snapshot_viewer [file] <sequence> render one snapshot
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <cstring>
+
+#include "../MemorySnapshot.h"
+
+template <typename T>
+bool read_raw(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+std::string format_time(int64_t timestamp_ms) {
+    std::time_t t = static_cast<std::time_t>(timestamp_ms / 1000);
+    std::tm tm = *std::localtime(&t);
+    std::stringstream ss;
+    ss << std::put_time(&tm, "%m/%d/%Y %I:%M:%S%p");
+    return ss.str();
+}
+
+void render(const std::vector<int32_t>& owners, const std::map<int, std::string>& names,
+            uint32_t mem_per_frame, int64_t timestamp_ms) {
+    int occupied_frames = 0;
+    for (int32_t owner : owners) {
+        if (owner != -1) { occupied_frames++; }
+    }
+    std::ostringstream out;
+    out << "Timestamp: (" << format_time(timestamp_ms) << ")\n";
+    out << "Total Frames: " << owners.size() << "\n";
+    out << "Occupied Frames: " << occupied_frames << "\n";
+    out << "Unused Frames: " << owners.size() - occupied_frames << "\n\n";
+    out << "---- Memory Layout (Top to Bottom) ----\n";
+    out << "----end---- = " << (long long)owners.size() * mem_per_frame << "\n";
+    for (int i = static_cast<int>(owners.size()) - 1; i >= 0; --i) {
+        out << (long long)(i + 1) * mem_per_frame << "\n";
+        if (owners[i] == -1) {
+            out << "[  FREE  ]\n";
+        } else {
+            auto it = names.find(owners[i]);
+            out << (it != names.end() ? it->second : "PID " + std::to_string(owners[i])) << "\n";
+        }
+        out << (long long)i * mem_per_frame << "\n\n";
+    }
+    out << "----start---- = 0\n";
+    std::cout << out.str();
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : SNAPSHOT_STREAM_FILE;
+    bool list_only = argc <= 2;
+    uint64_t wanted = list_only ? 0 : std::stoull(argv[2]);
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Error: Unable to open " << path << std::endl;
+        return 1;
+    }
+
+    char magic[4];
+    uint32_t version = 0, frame_count = 0, mem_per_frame = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        !read_raw(in, version) || version != SNAPSHOT_VERSION ||
+        !read_raw(in, frame_count) || !read_raw(in, mem_per_frame)) {
+        std::cerr << "Error: " << path << " is not a version " << SNAPSHOT_VERSION << " snapshot stream" << std::endl;
+        return 1;
+    }
+
+    std::vector<int32_t> owners(frame_count, -1);
+    std::map<int, std::string> names;
+    uint64_t snapshots = 0;
+
+    uint8_t type;
+    while (read_raw(in, type)) {
+        if (type == SNAPSHOT_RECORD_NAME) {
+            int32_t pid; uint16_t length;
+            if (!read_raw(in, pid) || !read_raw(in, length)) break;
+            std::string name(length, '\0');
+            if (!in.read(name.data(), length)) break;
+            names[pid] = name;
+        } else if (type == SNAPSHOT_RECORD_FRAMES) {
+            uint64_t sequence; int64_t timestamp_ms; uint32_t changed_count;
+            if (!read_raw(in, sequence) || !read_raw(in, timestamp_ms) || !read_raw(in, changed_count)) break;
+            bool complete = true;
+            for (uint32_t i = 0; i < changed_count; ++i) {
+                uint32_t index; int32_t owner;
+                if (!read_raw(in, index) || !read_raw(in, owner)) { complete = false; break; }
+                if (index < owners.size()) { owners[index] = owner; }
+            }
+            if (!complete) break;
+            snapshots++;
+
+            if (list_only) {
+                std::cout << std::setw(8) << sequence << "  " << format_time(timestamp_ms)
+                          << "  " << changed_count << " frame(s) changed\n";
+            } else if (sequence == wanted) {
+                render(owners, names, mem_per_frame, timestamp_ms);
+                return 0;
+            }
+        } else {
+            std::cerr << "Error: Unknown record type " << int(type) << std::endl;
+            return 1;
+        }
+    }
+
+    if (!list_only) {
+        std::cerr << "Error: Snapshot " << wanted << " not found (" << snapshots << " in stream)" << std::endl;
+        return 1;
+    }
+    std::cout << snapshots << " snapshot(s), " << frame_count << " frames of " << mem_per_frame << " bytes\n";
+    return 0;
+}
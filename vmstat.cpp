@@ -1,11 +1,29 @@
 #include "vmstat.h"
 #include "config.h" 
 #include "global.h" // Include this to get access to the memory_manager
+#include <algorithm>
+#include <deque>
+#include <mutex>
 
 // --- State for CPU Ticks (This is still correct) ---
 static std::atomic<long> active_ticks(0);
 static std::atomic<long> idle_ticks(0);
 
+// --- Simulated clock ---
+// The clock advances by the total ticks over the core count, so a cpu-set must not rescale the
+// ticks already counted. Each core-count change opens a segment that starts where the clock stood;
+// readers take the newest segment, and the high-water mark covers a reader that still raced on the
+// previous one. Segments are never freed, so a reader's pointer always stays valid.
+struct ClockSegment {
+    long clock_base;
+    long total_base;
+    int cores;
+};
+static std::mutex clock_segments_mutex;
+static std::deque<ClockSegment>& clock_segments = *new std::deque<ClockSegment>();
+static std::atomic<const ClockSegment*> clock_segment(nullptr);
+static std::atomic<long> clock_high_water(0);
+
 // --- OBSOLETE static variables for memory are REMOVED ---
 // static std::atomic<long> used_memory(0);
 // static std::atomic<long> paged_in(0);
@@ -13,14 +31,19 @@ static std::atomic<long> idle_ticks(0);
 
 
 void vmstats_reset() {
+    std::lock_guard<std::mutex> lock(clock_segments_mutex);
     active_ticks = 0;
     idle_ticks = 0;
+    clock_segment = nullptr;
+    clock_high_water = 0;
     // No need to reset memory stats here anymore.
 }
 
 // These functions are still correct.
 void vmstats_increment_active_ticks() { active_ticks++; }
 void vmstats_increment_idle_ticks()   { idle_ticks++; }
+void vmstats_add_active_ticks(long ticks) { active_ticks += ticks; }
+void vmstats_add_idle_ticks(long ticks)   { idle_ticks += ticks; }
 
 // --- OBSOLETE functions are REMOVED ---
 // void vmstats_increment_paged_in()
@@ -68,4 +91,28 @@ long get_pages_paged_out() {
 // --- Unchanged CPU tick functions ---
 long get_active_cpu_ticks() { return active_ticks; }
 long get_idle_cpu_ticks()   { return idle_ticks; }
-long get_total_cpu_ticks()  { return active_ticks + idle_ticks; }
\ No newline at end of file
+long get_total_cpu_ticks()  { return active_ticks + idle_ticks; }
+
+static long clock_at(const ClockSegment* segment, long total) {
+    if (!segment) return total / std::max(1, CPU_COUNT.load());
+    return segment->clock_base + std::max(0L, total - segment->total_base) / segment->cores;
+}
+
+long get_cpu_clock_ticks() {
+    const ClockSegment* segment = clock_segment.load(std::memory_order_acquire);
+    long now = clock_at(segment, get_total_cpu_ticks());
+    long seen = clock_high_water.load(std::memory_order_relaxed);
+    while (seen < now && !clock_high_water.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+    return std::max(seen, now);
+}
+
+void vmstats_set_core_count(int cores) {
+    std::lock_guard<std::mutex> lock(clock_segments_mutex);
+    cores = std::max(1, cores);
+    long total = get_total_cpu_ticks();
+    long now = std::max(clock_at(clock_segment.load(std::memory_order_acquire), total),
+                        clock_high_water.load());
+    clock_segments.push_back(ClockSegment{now, total, cores});
+    CPU_COUNT = cores;
+    clock_segment.store(&clock_segments.back(), std::memory_order_release);
+}
\ No newline at end of file
@@ -6,7 +6,11 @@
 // Keep functions for CPU ticks, as they are still managed here.
 void vmstats_reset();
 void vmstats_increment_active_ticks();
+// Publishes a whole quantum of active ticks with one atomic add.
+void vmstats_add_active_ticks(long ticks);
 void vmstats_increment_idle_ticks();
+// Idle time skipped while every core waits for a sleeping process.
+void vmstats_add_idle_ticks(long ticks);
 
 // These functions will now get their data from the MemoryManager.
 long get_total_memory();
@@ -15,6 +19,11 @@ long get_free_memory();
 long get_active_cpu_ticks();
 long get_idle_cpu_ticks();
 long get_total_cpu_ticks();
+// Ticks of the simulated clock: all cores tick together, so this is the total over the core count,
+// rebased at every core-count change so that the clock never jumps.
+long get_cpu_clock_ticks();
+// Sets CPU_COUNT and rebases the clock on it. The schedulers call this under their process lock.
+void vmstats_set_core_count(int cores);
 long get_pages_paged_in();
 long get_pages_paged_out();
 